@@ -30,6 +30,7 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Window/Input.hpp>
 #include <SFML/Internal.h>
+#include <vector>
 
 
 // WARNING : this structure must always be the SAME as in Window/Input.h
@@ -53,7 +54,8 @@ struct sfRenderWindow
 
 struct sfImage
 {
-    sf::Image This;
+    sf::Image              This;
+    std::vector<sf::Uint8> Pixels;
 };
 
 
@@ -219,7 +221,29 @@ sfColor sfImage_GetPixel(sfImage* Image, unsigned int X, unsigned int Y)
 ////////////////////////////////////////////////////////////
 const sfUint8* sfImage_GetPixelsPtr(sfImage* Image)
 {
-    CSFML_CALL_RETURN(Image, GetPixelsPtr(), NULL);
+    CSFML_CHECK_RETURN(Image, NULL);
+
+    if (Image->This.GetFormat() == sf::PixelFormat::RGBA8)
+        return Image->This.GetPixelsPtr();
+
+    // Single-channel images (like font images) are expanded to RGBA into a copy
+    unsigned int Width  = Image->This.GetWidth();
+    unsigned int Height = Image->This.GetHeight();
+    Image->Pixels.resize(Width * Height * 4);
+    for (unsigned int y = 0; y < Height; ++y)
+    {
+        for (unsigned int x = 0; x < Width; ++x)
+        {
+            sf::Color  Pixel = Image->This.GetPixel(x, y);
+            sf::Uint8* Dest  = &Image->Pixels[(x + y * Width) * 4];
+            Dest[0] = Pixel.r;
+            Dest[1] = Pixel.g;
+            Dest[2] = Pixel.b;
+            Dest[3] = Pixel.a;
+        }
+    }
+
+    return Image->Pixels.empty() ? NULL : &Image->Pixels[0];
 }
 
 
@@ -28,12 +28,14 @@
 #include <SFML/Graphics/PostFX.h>
 #include <SFML/Graphics/PostFX.hpp>
 #include <SFML/Internal.h>
+#include <vector>
 
 
 // WARNING : this structure must always be the SAME as in Graphics/Image.h
 struct sfImage
 {
-    sf::Image This;
+    sf::Image              This;
+    std::vector<sf::Uint8> Pixels;
 };
 struct sfPostFX
 {
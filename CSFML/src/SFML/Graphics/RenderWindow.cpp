@@ -34,6 +34,7 @@
 #include <SFML/Graphics/String.hpp>
 #include <SFML/Graphics/View.hpp>
 #include <SFML/Internal.h>
+#include <vector>
 
 
 // WARNING : this structure must always be the SAME as in Graphics/PostFX.h
@@ -62,7 +63,8 @@ struct sfString
 // WARNING : this structure must always be the SAME as in Graphics/Image.h
 struct sfImage
 {
-    sf::Image This;
+    sf::Image              This;
+    std::vector<sf::Uint8> Pixels;
 };
 // WARNING : this structure must always be the SAME as in Window/Input.h
 struct sfInput
@@ -30,12 +30,14 @@
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Internal.h>
+#include <vector>
 
 
 // WARNING : this structure must always be the SAME as in Graphics/Image.h
 struct sfImage
 {
-    sf::Image This;
+    sf::Image              This;
+    std::vector<sf::Uint8> Pixels;
 };
 struct sfSprite
 {
@@ -31,11 +31,15 @@
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Graphics/Color.hpp>
 #include <SFML/Graphics/Matrix3.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <vector>
 
 
 namespace sf
 {
+class Image;
 class RenderTarget;
+class SceneIndex;
 
 ////////////////////////////////////////////////////////////
 /// Enumerate the blending modes for drawable objects
@@ -70,12 +74,33 @@ public :
     ////////////////////////////////////////////////////////////
     Drawable(const Vector2f& Position = Vector2f(0, 0), const Vector2f& Scale = Vector2f(1, 1), float Rotation = 0.f, const Color& Col = Color(255, 255, 255, 255));
 
+    ////////////////////////////////////////////////////////////
+    /// Copy constructor ; the copy has the same parent as the
+    /// source object, but no children, and doesn't belong to the
+    /// scene index of the source object
+    ///
+    /// \param Copy : Object to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Drawable(const Drawable& Copy);
+
     ////////////////////////////////////////////////////////////
     /// Virtual destructor
     ///
     ////////////////////////////////////////////////////////////
     virtual ~Drawable();
 
+    ////////////////////////////////////////////////////////////
+    /// Assignment operator ; the object keeps its own parent,
+    /// children and scene index
+    ///
+    /// \param Other : Object to copy
+    ///
+    /// \return Reference to self
+    ///
+    ////////////////////////////////////////////////////////////
+    Drawable& operator =(const Drawable& Other);
+
     ////////////////////////////////////////////////////////////
     /// Set the position of the object (take 2 values)
     ///
@@ -189,6 +214,18 @@ public :
     ////////////////////////////////////////////////////////////
     void SetBlendMode(Blend::Mode Mode);
 
+    ////////////////////////////////////////////////////////////
+    /// Attach the object to a parent : its position, rotation,
+    /// scale and center are then relative to the local coordinates
+    /// of the parent, and it follows the parent when it moves.
+    /// Children are detached when their parent is destroyed.
+    /// By default an object has no parent
+    ///
+    /// \param Parent : New parent (NULL to detach the object)
+    ///
+    ////////////////////////////////////////////////////////////
+    void SetParent(const Drawable* Parent);
+
     ////////////////////////////////////////////////////////////
     /// Get the position of the object
     ///
@@ -238,6 +275,14 @@ public :
     ////////////////////////////////////////////////////////////
     Blend::Mode GetBlendMode() const;
 
+    ////////////////////////////////////////////////////////////
+    /// Get the parent of the object
+    ///
+    /// \return Current parent (NULL if none)
+    ///
+    ////////////////////////////////////////////////////////////
+    const Drawable* GetParent() const;
+
     ////////////////////////////////////////////////////////////
     /// Move the object of a given offset (take 2 values)
     ///
@@ -302,10 +347,22 @@ public :
     ////////////////////////////////////////////////////////////
     sf::Vector2f TransformToGlobal(const sf::Vector2f& Point) const;
 
+    ////////////////////////////////////////////////////////////
+    /// Get the bounding rectangle of the object in global coordinates
+    /// (ie the rectangle enclosing its local bounds once transformed)
+    ///
+    /// \param Bounds : Rectangle to fill with the bounds of the object
+    ///
+    /// \return False if the object has no bounds (it may be drawn anywhere)
+    ///
+    ////////////////////////////////////////////////////////////
+    bool GetGlobalBounds(FloatRect& Bounds) const;
+
 protected :
 
     ////////////////////////////////////////////////////////////
-    /// Get the transform matrix of the drawable
+    /// Get the transform matrix of the drawable, combined with
+    /// the ones of its parents (if any)
     ///
     /// \return Transform matrix
     ///
@@ -313,16 +370,44 @@ protected :
     const Matrix3& GetMatrix() const;
 
     ////////////////////////////////////////////////////////////
-    /// Get the inverse transform matrix of the drawable
+    /// Get the inverse transform matrix of the drawable, combined
+    /// with the ones of its parents (if any)
     ///
     /// \return Inverse transform matrix
     ///
     ////////////////////////////////////////////////////////////
     const Matrix3& GetInverseMatrix() const;
 
+    ////////////////////////////////////////////////////////////
+    /// Get the color the object is being rendered with ; it is
+    /// the one the object had when it was passed to Draw, which
+    /// may differ from GetColor when drawing is deferred
+    /// (see RenderTarget::BeginFrame)
+    ///
+    /// \return Color to render the object with
+    ///
+    ////////////////////////////////////////////////////////////
+    const Color& GetRenderColor() const;
+
 private :
 
     friend class RenderTarget;
+    friend class SceneIndex;
+    friend class SpriteBatch;
+
+    ////////////////////////////////////////////////////////////
+    /// Mark the transform matrices as outdated, and tell the
+    /// scene index containing the object that it has moved
+    ///
+    ////////////////////////////////////////////////////////////
+    void InvalidateTransform();
+
+    ////////////////////////////////////////////////////////////
+    /// Mark the global transform of the object and of its
+    /// children as outdated
+    ///
+    ////////////////////////////////////////////////////////////
+    void InvalidateGlobalTransform() const;
 
     ////////////////////////////////////////////////////////////
     /// Draw the object into the specified window
@@ -332,6 +417,18 @@ private :
     ////////////////////////////////////////////////////////////
     void Draw(RenderTarget& Target) const;
 
+    ////////////////////////////////////////////////////////////
+    /// Draw the object into the specified window, with the
+    /// states it had when the draw call was recorded
+    ///
+    /// \param Target : Target into which render the object
+    /// \param Matrix : Transform matrix to use
+    /// \param Col :    Color to use
+    /// \param Mode :   Blending mode to use
+    ///
+    ////////////////////////////////////////////////////////////
+    void Draw(RenderTarget& Target, const Matrix3& Matrix, const Color& Col, Blend::Mode Mode) const;
+
     ////////////////////////////////////////////////////////////
     /// Render the specific geometry of the object
     ///
@@ -340,19 +437,56 @@ private :
     ////////////////////////////////////////////////////////////
     virtual void Render(RenderTarget& Target) const = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// Get the image bound when rendering the object ;
+    /// it is used to group similar objects when drawing is deferred
+    ///
+    /// \return Image used by the object (NULL by default)
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual const Image* GetRenderImage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Tell whether the object reads the current contents of the
+    /// target when it is rendered ; deferred draw calls are never
+    /// reordered around such objects
+    ///
+    /// \return True if the object depends on what was drawn before it (false by default)
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool ReadsTarget() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Get the bounding rectangle of the object in local coordinates ;
+    /// it is used to skip the objects which are outside the view
+    ///
+    /// \param Bounds : Rectangle to fill with the bounds of the object
+    ///
+    /// \return False if the object has no bounds (false by default)
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool GetLocalBounds(FloatRect& Bounds) const;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Vector2f        myPosition;      ///< Position of the object on screen
-    Vector2f        myScale;         ///< Scale of the object
-    Vector2f        myCenter;        ///< Origin of translation / rotation / scaling of the object
-    float           myRotation;      ///< Orientation of the object, in degrees
-    Color           myColor;         ///< Overlay color of the object
-    Blend::Mode     myBlendMode;     ///< Blending mode
-    mutable bool    myNeedUpdate;    ///< Do we need to recompute the transform matrix ?
-    mutable bool    myInvNeedUpdate; ///< Do we need to recompute the inverse transform matrix ?
-    mutable Matrix3 myMatrix;        ///< Precomputed transform matrix gathering the translation / rotation / scale / center
-    mutable Matrix3 myInvMatrix;     ///< Precomputed inverse transform matrix gathering the translation / rotation / scale / center
+    Vector2f                       myPosition;         ///< Position of the object on screen
+    Vector2f                       myScale;            ///< Scale of the object
+    Vector2f                       myCenter;           ///< Origin of translation / rotation / scaling of the object
+    float                          myRotation;         ///< Orientation of the object, in degrees
+    Color                          myColor;            ///< Overlay color of the object
+    Blend::Mode                    myBlendMode;        ///< Blending mode
+    mutable bool                   myNeedUpdate;       ///< Do we need to recompute the transform matrix ?
+    mutable bool                   myInvNeedUpdate;    ///< Do we need to recompute the inverse transform matrix ?
+    mutable Matrix3                myMatrix;           ///< Precomputed transform matrix gathering the translation / rotation / scale / center
+    mutable Matrix3                myInvMatrix;        ///< Precomputed inverse transform matrix gathering the translation / rotation / scale / center
+    const Drawable*                myParent;           ///< Parent of the object (NULL if none)
+    mutable std::vector<Drawable*> myChildren;         ///< Objects attached to this one
+    mutable bool                   myGlobalNeedUpdate; ///< Do we need to recompute the global transform matrix ?
+    mutable Matrix3                myGlobalMatrix;     ///< Precomputed transform matrix combined with the ones of the parents
+    mutable SceneIndex*            myIndex;            ///< Scene index containing the object (NULL if none)
+    mutable unsigned int           myIndexEntry;       ///< Entry of the object in its scene index
+    mutable Color                  myRenderColor;      ///< Color of the object while it is being rendered
 };
 
 } // namespace sf
@@ -34,8 +34,9 @@
 #include <SFML/Graphics/Glyph.hpp>
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Rect.hpp>
-#include <map>
+#include <deque>
 #include <string>
+#include <vector>
 
 
 namespace sf
@@ -61,6 +62,20 @@ public :
     ////////////////////////////////////////////////////////////
     Font();
 
+    ////////////////////////////////////////////////////////////
+    /// Copy constructor
+    ///
+    /// \param Copy : instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Font(const Font& Copy);
+
+    ////////////////////////////////////////////////////////////
+    /// Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~Font();
+
     ////////////////////////////////////////////////////////////
     /// Load the font from a file
     ///
@@ -86,6 +101,35 @@ public :
     ////////////////////////////////////////////////////////////
     bool LoadFromMemory(const char* Data, std::size_t SizeInBytes, unsigned int CharSize = 30, const Unicode::Text& Charset = ourDefaultCharset);
 
+    ////////////////////////////////////////////////////////////
+    /// Load the font from a file, in dynamic mode : instead of
+    /// rendering a whole characters set when loading, glyphs are
+    /// rendered the first time they are requested, into a set of
+    /// images (pages) whose least recently used ones are recycled
+    /// when they are all full.
+    /// This is the mode to use with large characters sets (like CJK)
+    ///
+    /// \param Filename : Font file to load
+    /// \param CharSize : Size of characters in bitmap - the bigger, the higher quality (30 by default)
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool LoadDynamicFromFile(const std::string& Filename, unsigned int CharSize = 30);
+
+    ////////////////////////////////////////////////////////////
+    /// Load the font from a file in memory, in dynamic mode
+    /// (see LoadDynamicFromFile). The data is copied by the font
+    ///
+    /// \param Data :        Pointer to the data to load
+    /// \param SizeInBytes : Size of the data, in bytes
+    /// \param CharSize :    Size of characters in bitmap - the bigger, the higher quality (30 by default)
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool LoadDynamicFromMemory(const char* Data, std::size_t SizeInBytes, unsigned int CharSize = 30);
+
     ////////////////////////////////////////////////////////////
     /// Get the base size of characters in the font;
     /// All glyphs dimensions are based on this value
@@ -114,6 +158,37 @@ public :
     ////////////////////////////////////////////////////////////
     const Image& GetImage() const;
 
+    ////////////////////////////////////////////////////////////
+    /// Get one of the images containing the rendered characters ;
+    /// fonts loaded in dynamic mode may use several pages
+    /// (see Glyph::Page)
+    ///
+    /// \param Page : Index of the page
+    ///
+    /// \return Image containing the glyphs of the page
+    ///
+    ////////////////////////////////////////////////////////////
+    const Image& GetImage(unsigned int Page) const;
+
+    ////////////////////////////////////////////////////////////
+    /// Get the ratio of the pages area actually covered by
+    /// glyphs (without the padding between them)
+    ///
+    /// \return Fill ratio, in range [0, 1]
+    ///
+    ////////////////////////////////////////////////////////////
+    float GetFillRatio() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Assignment operator
+    ///
+    /// \param Other : instance to assign
+    ///
+    /// \return Reference to the font
+    ///
+    ////////////////////////////////////////////////////////////
+    Font& operator =(const Font& Other);
+
     ////////////////////////////////////////////////////////////
     /// Get the SFML default built-in font (Arial)
     ///
@@ -125,6 +200,164 @@ public :
 private :
 
     friend class priv::FontLoader;
+    friend class String;
+
+    ////////////////////////////////////////////////////////////
+    /// Table of glyphs indexed by code point : low code points
+    /// (ASCII / Latin-1) are stored in a flat array, the other
+    /// ones in an open-addressing hash table
+    ////////////////////////////////////////////////////////////
+    class GlyphTable
+    {
+    public :
+
+        ////////////////////////////////////////////////////////////
+        /// Default constructor
+        ///
+        ////////////////////////////////////////////////////////////
+        GlyphTable();
+
+        ////////////////////////////////////////////////////////////
+        /// Get the glyph of a code point, inserting it if needed
+        ///
+        /// \param CodePoint : Unicode value of the character
+        ///
+        /// \return Reference to the glyph
+        ///
+        ////////////////////////////////////////////////////////////
+        Glyph& operator [](Uint32 CodePoint);
+
+        ////////////////////////////////////////////////////////////
+        /// Find the glyph of a code point
+        ///
+        /// \param CodePoint : Unicode value of the character
+        ///
+        /// \return Pointer to the glyph, or NULL if not found
+        ///
+        ////////////////////////////////////////////////////////////
+        const Glyph* Find(Uint32 CodePoint) const;
+
+        ////////////////////////////////////////////////////////////
+        /// Remove a glyph
+        ///
+        /// \param CodePoint : Unicode value of the character
+        ///
+        ////////////////////////////////////////////////////////////
+        void Remove(Uint32 CodePoint);
+
+        ////////////////////////////////////////////////////////////
+        /// Remove all the glyphs
+        ///
+        ////////////////////////////////////////////////////////////
+        void Clear();
+
+    private :
+
+        ////////////////////////////////////////////////////////////
+        /// Get the slot of a code point in the hash table
+        ///
+        /// \param CodePoint : Unicode value of the character
+        ///
+        /// \return Index of the slot containing the code point, or of the empty slot where it would be inserted
+        ///
+        ////////////////////////////////////////////////////////////
+        std::size_t FindSlot(Uint32 CodePoint) const;
+
+        ////////////////////////////////////////////////////////////
+        /// Compute the hash of a code point
+        ///
+        /// \param CodePoint : Unicode value of the character
+        ///
+        /// \return Hash value
+        ///
+        ////////////////////////////////////////////////////////////
+        static Uint32 Hash(Uint32 CodePoint);
+
+        ////////////////////////////////////////////////////////////
+        /// Double the capacity of the hash table
+        ///
+        ////////////////////////////////////////////////////////////
+        void Grow();
+
+        enum
+        {
+            NbDirect = 256,       ///< Number of code points stored in the flat array
+            EmptyKey = 0xFFFFFFFF ///< Key of the empty slots (not a valid code point)
+        };
+
+        ////////////////////////////////////////////////////////////
+        // Member data
+        ////////////////////////////////////////////////////////////
+        Glyph               myDirect[NbDirect];     ///< Glyphs of the low code points, directly indexed
+        bool                myDirectUsed[NbDirect]; ///< Is each of the low code points in the table ?
+        std::vector<Uint32> myKeys;                 ///< Code points of the hash table slots
+        std::vector<Glyph>  myValues;               ///< Glyphs of the hash table slots
+        std::size_t         myCount;                ///< Number of code points in the hash table
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Defines an image holding rendered glyphs
+    ////////////////////////////////////////////////////////////
+    struct Page
+    {
+        Page();
+
+        Image               Texture;     ///< Image holding the glyphs
+        unsigned int        ShelfLeft;   ///< Left coordinate of the free space in the current row
+        unsigned int        ShelfTop;    ///< Top coordinate of the current row
+        unsigned int        ShelfHeight; ///< Height of the current row
+        std::vector<Uint32> CodePoints;  ///< Characters rendered into the page (dynamic mode only)
+        unsigned long       UsedArea;    ///< Number of pixels covered by the glyphs of the page
+        Uint32              LastUse;     ///< Time stamp of the last use of a glyph of the page
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Reset the font to its initial (empty) state
+    ///
+    ////////////////////////////////////////////////////////////
+    void Reset();
+
+    ////////////////////////////////////////////////////////////
+    /// Open the font data in dynamic mode
+    ///
+    /// \param CharSize : Size of characters in bitmap
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool OpenDynamic(unsigned int CharSize);
+
+    ////////////////////////////////////////////////////////////
+    /// Render a glyph into the pages, in dynamic mode
+    ///
+    /// \param CodePoint : Unicode value of the character to render
+    ///
+    /// \return Glyph's visual settings
+    ///
+    ////////////////////////////////////////////////////////////
+    const Glyph& LoadGlyph(Uint32 CodePoint) const;
+
+    ////////////////////////////////////////////////////////////
+    /// Mark a page as used, so that it is not recycled before
+    /// the pages used less recently (dynamic mode only)
+    ///
+    /// \param Page : Index of the page
+    ///
+    ////////////////////////////////////////////////////////////
+    void UsePage(unsigned int Page) const;
+
+    ////////////////////////////////////////////////////////////
+    /// Find room for a glyph in the pages, in dynamic mode ;
+    /// the least recently used page is recycled if they are all full
+    ///
+    /// \param Width :  Width of the glyph (plus padding, it must fit in a page)
+    /// \param Height : Height of the glyph (plus padding, it must fit in a page)
+    /// \param Rect :   Receives the rectangle allocated for the glyph
+    ///
+    /// \return Index of the page containing the rectangle
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int AllocateGlyph(unsigned int Width, unsigned int Height, IntRect& Rect) const;
 
     ////////////////////////////////////////////////////////////
     // Static member data
@@ -134,9 +367,14 @@ private :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Image                   myTexture;  ///< Texture holding the bitmap font
-    unsigned int            myCharSize; ///< Size of characters in the bitmap font
-    std::map<Uint32, Glyph> myGlyphs;   ///< Rendering settings of each character (glyph)
+    unsigned int             myCharSize;    ///< Size of characters in the bitmap font
+    mutable GlyphTable       myGlyphs;      ///< Rendering settings of each character (glyph)
+    mutable std::deque<Page> myPages;       ///< Images holding the bitmap font
+    mutable unsigned int     myCurrentPage; ///< Page receiving the new glyphs in dynamic mode
+    void*                    myFace;        ///< Font face kept open in dynamic mode (NULL otherwise)
+    std::vector<char>        myFontData;    ///< Copy of the font file, used by the face in dynamic mode
+    mutable Uint32           myUseCounter;  ///< Time stamp of the last glyph request, for recycling pages
+    mutable unsigned int     myGeneration;  ///< Incremented whenever glyphs are invalidated (reload, recycled page)
 };
 
 } // namespace sf
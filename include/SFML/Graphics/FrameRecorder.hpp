@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_FRAMERECORDER_HPP
+#define SFML_FRAMERECORDER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Config.hpp>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+
+namespace sf
+{
+class RenderWindow;
+
+////////////////////////////////////////////////////////////
+/// Enumerate the formats of the files written by a
+/// FrameRecorder
+////////////////////////////////////////////////////////////
+namespace RecordFormat
+{
+    enum Format
+    {
+        RawRGBA,    ///< Single file containing the frames one after the other, as raw RGBA pixels
+        Y4M,        ///< Single YUV4MPEG2 file (4:2:0), readable by most video encoders
+        PngSequence ///< One PNG file per frame, named after the given prefix and the frame number
+    };
+}
+
+////////////////////////////////////////////////////////////
+/// FrameRecorder captures the contents of a window every
+/// frame without stalling the rendering : the pixels are
+/// read into a ring of pixel buffer objects, and each frame
+/// is fetched two frames later, when the GPU is done with
+/// it. Frames are then handed to a background thread, which
+/// writes them to a file or passes them to a callback
+////////////////////////////////////////////////////////////
+class SFML_API FrameRecorder : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Type of the functions receiving the captured frames ;
+    /// they are called from the writer thread
+    ///
+    /// \param Pixels :   RGBA pixels of the frame, top to bottom (valid only during the call)
+    /// \param Width :    Width of the frame
+    /// \param Height :   Height of the frame
+    /// \param UserData : Data passed to Start
+    ///
+    ////////////////////////////////////////////////////////////
+    typedef void (*FrameCallback)(const Uint8* Pixels, unsigned int Width, unsigned int Height, void* UserData);
+
+    ////////////////////////////////////////////////////////////
+    /// Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    FrameRecorder();
+
+    ////////////////////////////////////////////////////////////
+    /// Destructor ; stops the recording if needed
+    ///
+    ////////////////////////////////////////////////////////////
+    ~FrameRecorder();
+
+    ////////////////////////////////////////////////////////////
+    /// Start recording a window into a file
+    ///
+    /// \param Window :    Window to record
+    /// \param Filename :  Path of the file to write (prefix of the file names for PngSequence)
+    /// \param Format :    Format of the file(s) to write
+    /// \param FrameRate : Frame rate written in the file header, for formats which have one (60 by default)
+    ///
+    /// \return True if recording could start
+    ///
+    ////////////////////////////////////////////////////////////
+    bool Start(RenderWindow& Window, const std::string& Filename, RecordFormat::Format Format, unsigned int FrameRate = 60);
+
+    ////////////////////////////////////////////////////////////
+    /// Start recording a window, passing the frames to a callback
+    ///
+    /// \param Window :   Window to record
+    /// \param Callback : Function receiving the frames
+    /// \param UserData : Data to pass to the callback (NULL by default)
+    ///
+    /// \return True if recording could start
+    ///
+    ////////////////////////////////////////////////////////////
+    bool Start(RenderWindow& Window, FrameCallback Callback, void* UserData = NULL);
+
+    ////////////////////////////////////////////////////////////
+    /// Capture the current contents of the window ; call it
+    /// once per frame, after drawing and before Display
+    ///
+    ////////////////////////////////////////////////////////////
+    void Capture();
+
+    ////////////////////////////////////////////////////////////
+    /// Stop recording : the frames still in flight are fetched,
+    /// and the function waits until all of them are written.
+    /// It must be called before the window is destroyed
+    ///
+    ////////////////////////////////////////////////////////////
+    void Stop();
+
+    ////////////////////////////////////////////////////////////
+    /// Tell whether a recording is in progress
+    ///
+    /// \return True if recording
+    ///
+    ////////////////////////////////////////////////////////////
+    bool IsRecording() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Get the number of frames dropped since the recording
+    /// started, because the writer thread couldn't keep up
+    ///
+    /// \return Number of dropped frames
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int GetDroppedFrames() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// Defines a captured frame
+    ////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        std::vector<Uint8> Pixels; ///< RGBA pixels, top to bottom
+        unsigned int       Width;  ///< Width of the frame
+        unsigned int       Height; ///< Height of the frame
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Start recording a window, once the destination of the
+    /// frames is set
+    ///
+    /// \param Window : Window to record
+    ///
+    /// \return True if recording could start
+    ///
+    ////////////////////////////////////////////////////////////
+    bool Begin(RenderWindow& Window);
+
+    ////////////////////////////////////////////////////////////
+    /// Create the pixel buffer objects for the current size,
+    /// if supported
+    ///
+    ////////////////////////////////////////////////////////////
+    void CreateBuffers();
+
+    ////////////////////////////////////////////////////////////
+    /// Destroy the pixel buffer objects
+    ///
+    ////////////////////////////////////////////////////////////
+    void DestroyBuffers();
+
+    ////////////////////////////////////////////////////////////
+    /// Fetch the oldest frame still in a pixel buffer object
+    ///
+    ////////////////////////////////////////////////////////////
+    void FetchOldestFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// Fetch all the frames still in pixel buffer objects
+    ///
+    ////////////////////////////////////////////////////////////
+    void FlushBuffers();
+
+    ////////////////////////////////////////////////////////////
+    /// Get a frame to fill, unless the writer thread is too late
+    ///
+    /// \return Frame to fill, or NULL if the frame must be dropped
+    ///
+    ////////////////////////////////////////////////////////////
+    Frame* AcquireFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// Hand a filled frame to the writer thread
+    ///
+    /// \param NewFrame : Frame to write
+    ///
+    ////////////////////////////////////////////////////////////
+    void QueueFrame(Frame* NewFrame);
+
+    ////////////////////////////////////////////////////////////
+    /// Write a frame to its destination (called by the writer thread)
+    ///
+    /// \param Source : Frame to write
+    ///
+    /// \return True if the frame was written
+    ///
+    ////////////////////////////////////////////////////////////
+    bool WriteFrame(const Frame& Source);
+
+    ////////////////////////////////////////////////////////////
+    /// Entry point of the writer thread : write the queued
+    /// frames until there's none left
+    ///
+    /// \param UserData : Recorder running the function
+    ///
+    ////////////////////////////////////////////////////////////
+    static void RunWriter(void* UserData);
+
+    ////////////////////////////////////////////////////////////
+    /// Number of pixel buffer objects, and maximum number of
+    /// frames waiting for the writer thread
+    ////////////////////////////////////////////////////////////
+    enum {NbBuffers = 3, MaxQueuedFrames = 8};
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    RenderWindow*        myWindow;             ///< Window being recorded (NULL if not recording)
+    unsigned int         myWidth;              ///< Width of the captured frames
+    unsigned int         myHeight;             ///< Height of the captured frames
+    unsigned int         myBuffers[NbBuffers]; ///< OpenGL identifiers of the pixel buffer objects (0 if not supported)
+    unsigned int         myNextBuffer;         ///< Index of the buffer receiving the next frame
+    unsigned int         myNbInFlight;         ///< Number of frames waiting in the buffers
+    RecordFormat::Format myFormat;             ///< Format of the written files
+    std::string          myFilename;           ///< Path of the written file (prefix for PngSequence)
+    FILE*                myFile;               ///< File receiving the frames (RawRGBA and Y4M)
+    FrameCallback        myCallback;           ///< Function receiving the frames (NULL if writing files)
+    void*                myUserData;           ///< Data to pass to the callback
+    unsigned int         myNbWritten;          ///< Number of frames written
+    unsigned int         myNbDropped;          ///< Number of frames dropped
+    bool                 myWriteFailed;        ///< Did writing fail ? (the next frames are then discarded)
+    Mutex                myMutex;              ///< Mutex protecting the queue and the writer state
+    std::deque<Frame*>   myQueue;              ///< Frames waiting for the writer thread
+    std::vector<Frame*>  myFreeFrames;         ///< Frames that can be reused
+    Thread               myWriter;             ///< Thread writing the frames
+    bool                 myIsWriting;          ///< Is the writer thread running ?
+};
+
+} // namespace sf
+
+
+#endif // SFML_FRAMERECORDER_HPP
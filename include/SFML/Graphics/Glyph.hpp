@@ -45,14 +45,15 @@ public :
     /// Default constructor
     ///
     ////////////////////////////////////////////////////////////
-    Glyph() : Advance(0) {}
+    Glyph() : Advance(0), Page(0) {}
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    int       Advance;   ///< Offset to move horizontically to the next character
-    IntRect   Rectangle; ///< Bounding rectangle of the glyph, in relative coordinates
-    FloatRect TexCoords; ///< Texture coordinates of the glyph inside the bitmap font
+    int          Advance;   ///< Offset to move horizontically to the next character
+    IntRect      Rectangle; ///< Bounding rectangle of the glyph, in relative coordinates
+    FloatRect    TexCoords; ///< Texture coordinates of the glyph inside the bitmap font
+    unsigned int Page;      ///< Index of the font image containing the glyph (see Font::GetImage)
 };
 
 } // namespace sf
@@ -37,7 +37,52 @@
 
 namespace sf
 {
-class RenderWindow;
+class RenderTarget;
+
+namespace priv
+{
+struct AsyncImageRequest;
+}
+
+////////////////////////////////////////////////////////////
+/// Enumerate the formats of the pixels of an image
+////////////////////////////////////////////////////////////
+namespace PixelFormat
+{
+    enum Format
+    {
+        RGBA8, ///< 4 components of 8 bits : red, green, blue, alpha
+        A8,    ///< 1 component of 8 bits : alpha (color is white)
+        L8     ///< 1 component of 8 bits : luminance (image is opaque)
+    };
+}
+
+////////////////////////////////////////////////////////////
+/// Enumerate the filters used to sample an image
+////////////////////////////////////////////////////////////
+namespace TextureFilter
+{
+    enum Mode
+    {
+        Nearest,  ///< No smoothing : nearest pixel
+        Linear,   ///< Interpolation between the 4 nearest pixels
+        Trilinear ///< Linear interpolation between the 2 nearest mipmaps (reduced copies of the image) ; best quality for zoomed out images
+    };
+}
+
+////////////////////////////////////////////////////////////
+/// Enumerate the filters used to resize an image
+////////////////////////////////////////////////////////////
+namespace ResizeFilter
+{
+    enum Mode
+    {
+        Box,      ///< Average of the covered pixels ; fastest, good for reductions by integer factors
+        Bilinear, ///< Linear interpolation (tent filter)
+        Bicubic,  ///< Catmull-Rom cubic interpolation ; sharp result, good default choice
+        Lanczos   ///< 3-lobed Lanczos windowed sinc ; sharpest result, slowest filter
+    };
+}
 
 ////////////////////////////////////////////////////////////
 /// Image is the low-level class for loading and
@@ -67,19 +112,21 @@ public :
     /// \param Width :  Image width
     /// \param Height : Image height
     /// \param Col :    Image color (black by default)
+    /// \param Format : Format of the pixels (RGBA8 by default)
     ///
     ////////////////////////////////////////////////////////////
-    Image(unsigned int Width, unsigned int Height, const Color& Col = Color(0, 0, 0, 255));
+    Image(unsigned int Width, unsigned int Height, const Color& Col = Color(0, 0, 0, 255), PixelFormat::Format Format = PixelFormat::RGBA8);
 
     ////////////////////////////////////////////////////////////
     /// Construct the image from pixels in memory
     ///
     /// \param Width :  Image width
     /// \param Height : Image height
-    /// \param Data :   Pointer to the pixels in memory (assumed format is RGBA)
+    /// \param Data :   Pointer to the pixels in memory
+    /// \param Format : Format of the pixels (RGBA8 by default)
     ///
     ////////////////////////////////////////////////////////////
-    Image(unsigned int Width, unsigned int Height, const Uint8* Data);
+    Image(unsigned int Width, unsigned int Height, const Uint8* Data, PixelFormat::Format Format = PixelFormat::RGBA8);
 
     ////////////////////////////////////////////////////////////
     /// Destructor
@@ -97,6 +144,44 @@ public :
     ////////////////////////////////////////////////////////////
     bool LoadFromFile(const std::string& Filename);
 
+    ////////////////////////////////////////////////////////////
+    /// Load the image from a file, reduced to fit into a maximum
+    /// size (the aspect ratio is kept, and the image is never
+    /// enlarged). JPG files are decoded directly at a reduced
+    /// size, which makes this much faster than loading the full
+    /// image for creating thumbnails
+    ///
+    /// \param Filename :  Path of the image file to load
+    /// \param MaxWidth :  Maximum width of the loaded image
+    /// \param MaxHeight : Maximum height of the loaded image
+    ///
+    /// \return True if loading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool LoadFromFile(const std::string& Filename, unsigned int MaxWidth, unsigned int MaxHeight);
+
+    ////////////////////////////////////////////////////////////
+    /// Start loading the image from a file in the background.
+    /// The file is decoded by worker threads, and the image stays
+    /// empty until IsLoading returns false
+    ///
+    /// \param Filename : Path of the image file to load
+    ///
+    ////////////////////////////////////////////////////////////
+    void LoadFromFileAsync(const std::string& Filename);
+
+    ////////////////////////////////////////////////////////////
+    /// Tell whether a loading started with LoadFromFileAsync is
+    /// still in progress. When the file has been decoded, this
+    /// function finishes the loading (the image then becomes
+    /// usable, or empty if loading failed) ; it must therefore be
+    /// called from the thread which uses the image
+    ///
+    /// \return True if the image is still being loaded
+    ///
+    ////////////////////////////////////////////////////////////
+    bool IsLoading();
+
     ////////////////////////////////////////////////////////////
     /// Load the image from a file in memory
     ///
@@ -113,12 +198,13 @@ public :
     ///
     /// \param Width :  Image width
     /// \param Height : Image height
-    /// \param Data :   Pointer to the pixels in memory (assumed format is RGBA)
+    /// \param Data :   Pointer to the pixels in memory
+    /// \param Format : Format of the pixels (RGBA8 by default)
     ///
     /// \return True if loading was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool LoadFromPixels(unsigned int Width, unsigned int Height, const Uint8* Data);
+    bool LoadFromPixels(unsigned int Width, unsigned int Height, const Uint8* Data, PixelFormat::Format Format = PixelFormat::RGBA8);
 
     ////////////////////////////////////////////////////////////
     /// Save the content of the image to a file
@@ -130,17 +216,32 @@ public :
     ////////////////////////////////////////////////////////////
     bool SaveToFile(const std::string& Filename) const;
 
+    ////////////////////////////////////////////////////////////
+    /// Save the content of the image to a cache file. Cache files
+    /// store the pixels in their own format, and are loaded back
+    /// by LoadFromFile with almost no decoding work, which makes
+    /// them much faster to load than PNG or JPG files
+    ///
+    /// \param Filename : Path of the file to save (overwritten if already exist)
+    /// \param Compress : Compress the pixels with zlib (smaller file, slightly slower loading) (true by default)
+    ///
+    /// \return True if saving was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool SaveToCache(const std::string& Filename, bool Compress = true) const;
+
     ////////////////////////////////////////////////////////////
     /// Create an empty image
     ///
     /// \param Width :  Image width
     /// \param Height : Image height
     /// \param Col :    Image color (black by default)
+    /// \param Format : Format of the pixels (RGBA8 by default)
     ///
     /// \return True if creation was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool Create(unsigned int Width, unsigned int Height, Color Col = Color(0, 0, 0, 255));
+    bool Create(unsigned int Width, unsigned int Height, Color Col = Color(0, 0, 0, 255), PixelFormat::Format Format = PixelFormat::RGBA8);
 
     ////////////////////////////////////////////////////////////
     /// Create transparency mask from a specified colorkey
@@ -154,7 +255,8 @@ public :
     ////////////////////////////////////////////////////////////
     /// Copy pixels from another image onto this one.
     /// This function does a slow pixel copy and should only
-    /// be used at initialization time
+    /// be used at initialization time.
+    /// Pixels are converted if both images have different formats
     ///
     /// \param Source :     Source image to copy
     /// \param DestX :      X coordinate of the destination position
@@ -167,15 +269,28 @@ public :
 
     ////////////////////////////////////////////////////////////
     /// Create the image from the current contents of the
-    /// given window
+    /// given render target (window or render image)
     ///
-    /// \param Window :     Window to capture
-    /// \param SourceRect : Sub-rectangle of the screen to copy (empty by default - entire image)
+    /// \param Target :     Render target to capture
+    /// \param SourceRect : Sub-rectangle of the target to copy (empty by default - entire image)
     ///
     /// \return True if copy was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool CopyScreen(RenderWindow& Window, const IntRect& SourceRect = IntRect(0, 0, 0, 0));
+    bool CopyScreen(RenderTarget& Target, const IntRect& SourceRect = IntRect(0, 0, 0, 0));
+
+    ////////////////////////////////////////////////////////////
+    /// Resize the image, resampling its pixels with the given
+    /// filter. Big images are processed by several threads
+    ///
+    /// \param Width :  New width
+    /// \param Height : New height
+    /// \param Filter : Filter to use (Bicubic by default)
+    ///
+    /// \return True if resizing was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool Resize(unsigned int Width, unsigned int Height, ResizeFilter::Mode Filter = ResizeFilter::Bicubic);
 
     ////////////////////////////////////////////////////////////
     /// Change the color of a pixel
@@ -196,11 +311,22 @@ public :
     /// \return Color of pixel (X, Y)
     ///
     ////////////////////////////////////////////////////////////
-    const Color& GetPixel(unsigned int X, unsigned int Y) const;
+    Color GetPixel(unsigned int X, unsigned int Y) const;
 
     ////////////////////////////////////////////////////////////
-    /// Get a read-only pointer to the array of pixels (RGBA 8 bits integers components)
-    /// Array size is GetWidth() x GetHeight() x 4
+    /// Change the pixels of a rectangle of the image at once.
+    /// Only the modified area will be copied to the texture
+    ///
+    /// \param Pixels : Pointer to the new pixels, in the format of the image (rows of Rect.GetWidth() pixels, without padding)
+    /// \param Rect :   Rectangle of the image to update
+    ///
+    ////////////////////////////////////////////////////////////
+    void UpdatePixels(const Uint8* Pixels, const IntRect& Rect);
+
+    ////////////////////////////////////////////////////////////
+    /// Get a read-only pointer to the array of pixels (8 bits integers components,
+    /// in the format of the image). Array size is GetWidth() x GetHeight() x 4
+    /// for RGBA8 images, and GetWidth() x GetHeight() for A8 and L8 images.
     /// This pointer becomes invalid if you reload or resize the image
     ///
     /// \return Const pointer to the array of pixels
@@ -223,6 +349,21 @@ public :
     ////////////////////////////////////////////////////////////
     void SetSmooth(bool Smooth);
 
+    ////////////////////////////////////////////////////////////
+    /// Change the filter used to sample the image.
+    /// The Trilinear filter builds a chain of mipmaps on the CPU,
+    /// which is updated each time the pixels change. When the image
+    /// is drawn into by OpenGL (RenderImage, CopyScreen), the mipmaps
+    /// are rebuilt the next time the image is used for drawing : on
+    /// the GPU if framebuffer objects are supported, otherwise by
+    /// reading the texture back, which stalls the rendering.
+    /// The default filter is Linear
+    ///
+    /// \param Filter : New filter
+    ///
+    ////////////////////////////////////////////////////////////
+    void SetFilter(TextureFilter::Mode Filter);
+
     ////////////////////////////////////////////////////////////
     /// Return the width of the image
     ///
@@ -239,6 +380,14 @@ public :
     ////////////////////////////////////////////////////////////
     unsigned int GetHeight() const;
 
+    ////////////////////////////////////////////////////////////
+    /// Return the format of the pixels of the image
+    ///
+    /// \return Pixel format
+    ///
+    ////////////////////////////////////////////////////////////
+    PixelFormat::Format GetFormat() const;
+
     ////////////////////////////////////////////////////////////
     /// Tells whether the smooth filtering is enabled or not
     ///
@@ -247,6 +396,14 @@ public :
     ////////////////////////////////////////////////////////////
     bool IsSmooth() const;
 
+    ////////////////////////////////////////////////////////////
+    /// Get the filter used to sample the image
+    ///
+    /// \return Current filter
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureFilter::Mode GetFilter() const;
+
     ////////////////////////////////////////////////////////////
     /// Convert a subrect expressed in pixels, into float
     /// texture coordinates
@@ -280,6 +437,8 @@ public :
 
 private :
 
+    friend class RenderImage;
+
     ////////////////////////////////////////////////////////////
     /// Create the OpenGL texture
     ///
@@ -288,24 +447,72 @@ private :
     ////////////////////////////////////////////////////////////
     bool CreateTexture();
 
+    ////////////////////////////////////////////////////////////
+    /// Change the format of the pixels, destroying the OpenGL
+    /// texture if it doesn't match the new format
+    ///
+    /// \param Format : New pixel format
+    ///
+    ////////////////////////////////////////////////////////////
+    void SetFormat(PixelFormat::Format Format);
+
+    ////////////////////////////////////////////////////////////
+    /// Add an area to the part of the pixels array which must
+    /// be copied to the texture
+    ///
+    /// \param Rect : Modified area
+    ///
+    ////////////////////////////////////////////////////////////
+    void AddDirtyRect(const IntRect& Rect);
+
     ////////////////////////////////////////////////////////////
     /// Make sure the texture in video memory is updated with the
     /// array of pixels
     ////////////////////////////////////////////////////////////
     void EnsureTextureUpdate() const;
 
+    ////////////////////////////////////////////////////////////
+    /// Update an area of the mipmaps from the pixels array, and
+    /// copy it to the texture ; the mipmaps are created first if
+    /// they don't exist yet
+    ///
+    /// \param Rect : Modified area of the pixels array
+    ///
+    ////////////////////////////////////////////////////////////
+    void UpdateMipmaps(const IntRect& Rect) const;
+
     ////////////////////////////////////////////////////////////
     /// Make sure the array of pixels is updated with the
     /// texture in video memory
     ////////////////////////////////////////////////////////////
     void EnsureArrayUpdate() const;
 
+    ////////////////////////////////////////////////////////////
+    /// Make sure the mipmaps are updated after OpenGL has
+    /// written into the texture
+    ////////////////////////////////////////////////////////////
+    void EnsureMipmapsUpdate() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Tell the image that OpenGL has written into its texture :
+    /// the array of pixels must be read back before being used,
+    /// and the mipmaps (if any) must be rebuilt
+    ///
+    ////////////////////////////////////////////////////////////
+    void NotifyTextureModified();
+
     ////////////////////////////////////////////////////////////
     /// Reset the image attributes
     ///
     ////////////////////////////////////////////////////////////
     void Reset();
 
+    ////////////////////////////////////////////////////////////
+    /// Abandon the loading started with LoadFromFileAsync, if any
+    ///
+    ////////////////////////////////////////////////////////////
+    void CancelLoading();
+
     ////////////////////////////////////////////////////////////
     /// Destroy the OpenGL texture
     ///
@@ -315,15 +522,20 @@ private :
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    unsigned int               myWidth;             ///< Image width
-    unsigned int               myHeight;            ///< Image Height
-    unsigned int               myTextureWidth;      ///< Actual texture width (can be greater than image width because of padding)
-    unsigned int               myTextureHeight;     ///< Actual texture height (can be greater than image height because of padding)
-    unsigned int               myTexture;           ///< Internal texture identifier
-    bool                       myIsSmooth;          ///< Status of the smooth filter
-    mutable std::vector<Color> myPixels;            ///< Pixels of the image
-    mutable bool               myNeedTextureUpdate; ///< Status of synchronization between pixels in central memory and the internal texture un video memory
-    mutable bool               myNeedArrayUpdate;   ///< Status of synchronization between pixels in central memory and the internal texture un video memory
+    unsigned int                             myWidth;             ///< Image width
+    unsigned int                             myHeight;            ///< Image Height
+    PixelFormat::Format                      myFormat;            ///< Format of the pixels
+    unsigned int                             myTextureWidth;      ///< Actual texture width (can be greater than image width because of padding)
+    unsigned int                             myTextureHeight;     ///< Actual texture height (can be greater than image height because of padding)
+    unsigned int                             myTexture;           ///< Internal texture identifier
+    TextureFilter::Mode                      myFilter;            ///< Filter used to sample the texture
+    mutable std::vector<Uint8>               myPixels;            ///< Pixels of the image, in the image format
+    mutable std::vector<std::vector<Uint8> > myMipmaps;           ///< Pixels of the mipmaps 1 to N, when using the trilinear filter
+    IntRect                                  myDirtyRect;         ///< Area of the pixels array modified since the last texture update
+    mutable bool                             myNeedTextureUpdate; ///< Status of synchronization between pixels in central memory and the internal texture un video memory
+    mutable bool                             myNeedArrayUpdate;   ///< Status of synchronization between pixels in central memory and the internal texture un video memory
+    mutable bool                             myNeedMipmapsUpdate; ///< Do the mipmaps have to be rebuilt from the texture ?
+    priv::AsyncImageRequest*                 myAsyncRequest;      ///< Loading in progress in the background (NULL if none)
 };
 
 } // namespace sf
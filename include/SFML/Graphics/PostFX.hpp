@@ -85,7 +85,9 @@ public :
     bool LoadFromMemory(const std::string& Effect);
 
     ////////////////////////////////////////////////////////////
-    /// Change a parameter of the effect (1 float)
+    /// Change a parameter of the effect (1 float).
+    /// Parameters are stored and sent to the effect the next time
+    /// it's drawn, only if their value changed
     ///
     /// \param Name : Parameter name in the effect
     /// \param X :    Value to assign
@@ -155,8 +157,16 @@ protected :
     ////////////////////////////////////////////////////////////
     virtual void Render(RenderTarget& Target) const;
 
+    ////////////////////////////////////////////////////////////
+    /// /see Drawable::ReadsTarget
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool ReadsTarget() const;
+
 private :
 
+    friend class PostFXChain;
+
     ////////////////////////////////////////////////////////////
     /// Preprocess a SFML effect file
     /// to convert it to a valid GLSL fragment shader
@@ -174,18 +184,56 @@ private :
     ////////////////////////////////////////////////////////////
     void CreateProgram();
 
+    ////////////////////////////////////////////////////////////
+    /// Find the locations of all the variables of the program
+    ///
+    ////////////////////////////////////////////////////////////
+    void ReadParameters();
+
+    ////////////////////////////////////////////////////////////
+    /// Store the new value of a parameter of the effect
+    ///
+    /// \param Name :       Parameter name in the effect
+    /// \param NbValues :   Number of floats to assign
+    /// \param X, Y, Z, W : Values to assign
+    ///
+    ////////////////////////////////////////////////////////////
+    void StageParameter(const std::string& Name, int NbValues, float X, float Y, float Z, float W);
+
+    ////////////////////////////////////////////////////////////
+    /// Send the parameters changed since the last render to
+    /// the program (which must be in use)
+    ///
+    ////////////////////////////////////////////////////////////
+    void UploadParameters() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Defines a variable of the effect
+    ////////////////////////////////////////////////////////////
+    struct Parameter
+    {
+        int   Location;  ///< Location of the variable in the program
+        int   NbValues;  ///< Number of floats of the stored value (0 if none)
+        float Values[4]; ///< Stored value
+        bool  Modified;  ///< Has the value changed since it was last sent to the program ?
+    };
+
     ////////////////////////////////////////////////////////////
     // Types
     ////////////////////////////////////////////////////////////
     typedef std::map<std::string, const Image*> TextureTable;
+    typedef std::map<std::string, Parameter>    ParameterTable;
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    unsigned int  myShaderProgram;  ///< OpenGL identifier for the program
-    TextureTable  myTextures;       ///< Texture variables in the effect
-    std::string   myFragmentShader; ///< Fragment shader source code
-    mutable Image myFrameBuffer;    ///< Texture containing the current frame buffer
+    unsigned int           myShaderProgram;    ///< OpenGL identifier for the program
+    TextureTable           myTextures;         ///< Texture variables in the effect
+    mutable ParameterTable myParameters;       ///< Variables of the program, and their stored values
+    mutable bool           myTexturesModified; ///< Have the texture units changed since they were last sent to the program ?
+    std::string            myFragmentShader;   ///< Fragment shader source code
+    mutable Image          myFrameBuffer;      ///< Texture containing the current frame buffer
+    mutable const Image*   myInput;            ///< Image to use instead of a copy of the frame buffer (set by PostFXChain)
 };
 
 } // namespace sf
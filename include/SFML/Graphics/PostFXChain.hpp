@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_POSTFXCHAIN_HPP
+#define SFML_POSTFXCHAIN_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/PostFX.hpp>
+#include <SFML/Graphics/RenderImage.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <vector>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// Enumerate the resolutions of the passes of a PostFXChain
+////////////////////////////////////////////////////////////
+namespace PassResolution
+{
+    enum Mode
+    {
+        Full,    ///< Same size as the scene
+        Half,    ///< Half the width and height of the scene
+        Quarter  ///< Quarter of the width and height of the scene ; good for blurs and blooms
+    };
+}
+
+////////////////////////////////////////////////////////////
+/// PostFXChain applies a sequence of post-effects without
+/// copying the screen : the scene is drawn once into an
+/// off-screen image, then each effect reads the result of
+/// the previous one and writes into another off-screen
+/// image (two images per resolution are used in turn).
+/// The final result is drawn into the target.
+/// Requires render images (see RenderImage::CanUseRenderImage)
+////////////////////////////////////////////////////////////
+class SFML_API PostFXChain : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    PostFXChain();
+
+    ////////////////////////////////////////////////////////////
+    /// Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~PostFXChain();
+
+    ////////////////////////////////////////////////////////////
+    /// Create the off-screen image receiving the scene ; the
+    /// other images are created when needed
+    ///
+    /// \param Width :  Width of the scene, in pixels
+    /// \param Height : Height of the scene, in pixels
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool Create(unsigned int Width, unsigned int Height);
+
+    ////////////////////////////////////////////////////////////
+    /// Get the render image to draw the scene into, before
+    /// calling Draw
+    ///
+    /// \return Render image receiving the scene
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderImage& GetScene();
+
+    ////////////////////////////////////////////////////////////
+    /// Add an effect at the end of the chain. The effect reads the
+    /// result of the previous pass through its frame buffer textures
+    /// (those set with a NULL image), and must stay alive as long as
+    /// it's in the chain. Each pass starts from a transparent image,
+    /// and the effect is drawn with its own blending mode
+    ///
+    /// \param Effect :     Effect to add
+    /// \param Resolution : Resolution of the pass (Full by default)
+    ///
+    ////////////////////////////////////////////////////////////
+    void AddEffect(const PostFX& Effect, PassResolution::Mode Resolution = PassResolution::Full);
+
+    ////////////////////////////////////////////////////////////
+    /// Remove all the effects of the chain
+    ///
+    ////////////////////////////////////////////////////////////
+    void ClearEffects();
+
+    ////////////////////////////////////////////////////////////
+    /// Apply the effects to the scene, and draw the result so
+    /// that it covers the current view of the target (replacing
+    /// its contents)
+    ///
+    /// \param Target : Render target to draw the result into
+    ///
+    ////////////////////////////////////////////////////////////
+    void Draw(RenderTarget& Target);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// Get the image receiving a pass, creating it if needed
+    ///
+    /// \param Resolution : Resolution of the pass
+    /// \param Source :     Image read by the pass
+    ///
+    /// \return Image to draw into, or NULL if it couldn't be created
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderImage* GetPassTarget(PassResolution::Mode Resolution, const RenderImage* Source);
+
+    ////////////////////////////////////////////////////////////
+    /// Defines an effect of the chain
+    ////////////////////////////////////////////////////////////
+    struct Pass
+    {
+        const PostFX*        Effect;     ///< Effect to apply
+        PassResolution::Mode Resolution; ///< Resolution of the pass
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Number of resolutions
+    ////////////////////////////////////////////////////////////
+    enum {NbResolutions = 3};
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int      myWidth;                      ///< Width of the scene
+    unsigned int      myHeight;                     ///< Height of the scene
+    std::vector<Pass> myPasses;                     ///< Effects of the chain
+    RenderImage*      myImages[NbResolutions][2];   ///< Images used in turn by the passes of each resolution ; the first full one receives the scene
+    Sprite            myResult;                     ///< Sprite drawing the final result into the target
+};
+
+} // namespace sf
+
+
+#endif // SFML_POSTFXCHAIN_HPP
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_RENDERIMAGE_HPP
+#define SFML_RENDERIMAGE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+
+
+namespace sf
+{
+class Context;
+
+////////////////////////////////////////////////////////////
+/// RenderImage is an off-screen render target : everything
+/// is drawn directly into the texture of an image (through a
+/// frame buffer object), which can then be used like any
+/// other image, for example to draw layers or UI panels once
+/// and reuse them across frames
+////////////////////////////////////////////////////////////
+class SFML_API RenderImage : public RenderTarget, NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderImage();
+
+    ////////////////////////////////////////////////////////////
+    /// Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual ~RenderImage();
+
+    ////////////////////////////////////////////////////////////
+    /// Create the render image ; its contents are initially
+    /// fully transparent
+    ///
+    /// \param Width :  Width of the render image
+    /// \param Height : Height of the render image
+    ///
+    /// \return True if creation was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool Create(unsigned int Width, unsigned int Height);
+
+    ////////////////////////////////////////////////////////////
+    /// Finish the drawing into the render image : the target
+    /// image can then be used by other render targets (the draw
+    /// calls recorded since BeginFrame are executed first).
+    /// Call it after drawing, each time the contents change
+    ///
+    ////////////////////////////////////////////////////////////
+    void Display();
+
+    ////////////////////////////////////////////////////////////
+    /// Get the image containing the drawn contents
+    ///
+    /// \return Target image
+    ///
+    ////////////////////////////////////////////////////////////
+    const Image& GetImage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Get the width of the rendering region of the image
+    ///
+    /// \return Width in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual unsigned int GetWidth() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Get the height of the rendering region of the image
+    ///
+    /// \return Height in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual unsigned int GetHeight() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Tell whether or not the system supports render images
+    ///
+    /// \return True if the system can use render images
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool CanUseRenderImage();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// /see RenderTarget::Activate
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool Activate(bool Active);
+
+    ////////////////////////////////////////////////////////////
+    /// /see RenderTarget::IsTopToBottom
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool IsTopToBottom() const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Image        myImage;       ///< Target image
+    Context*     myContext;     ///< OpenGL context owning the frame buffer object (they can't be shared between contexts)
+    unsigned int myFrameBuffer; ///< OpenGL identifier of the frame buffer object
+};
+
+} // namespace sf
+
+
+#endif // SFML_RENDERIMAGE_HPP
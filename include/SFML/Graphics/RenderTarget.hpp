@@ -29,13 +29,19 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Matrix3.hpp>
 #include <SFML/Graphics/View.hpp>
 #include <SFML/Graphics/Rect.hpp>
+#include <vector>
 
 
 namespace sf
 {
-class Drawable;
+namespace priv
+{
+    class GLStateCache;
+}
 
 ////////////////////////////////////////////////////////////
 /// Base class for all render targets (window, image, ...)
@@ -59,13 +65,49 @@ public :
     void Clear(const Color& FillColor = Color(0, 0, 0));
 
     ////////////////////////////////////////////////////////////
-    /// Draw something into the target
+    /// Draw something into the target.
+    /// Objects with bounds (sprites, strings, shapes) which are
+    /// entirely outside the current view are skipped
     ///
     /// \param Object : Object to draw
     ///
     ////////////////////////////////////////////////////////////
     virtual void Draw(const Drawable& Object);
 
+    ////////////////////////////////////////////////////////////
+    /// Start recording draw calls instead of executing them.
+    /// Until Flush is called, Draw only stores the objects along
+    /// with their transform, color and blending mode : an object
+    /// can be moved, recolored and drawn again in the same frame.
+    /// Its other properties (image and sub-rectangle of a sprite,
+    /// text of a string, points of a shape, ...) are read by Flush,
+    /// so they must not change before, and the objects must stay
+    /// alive until then.
+    /// Displaying or capturing the target calls Flush
+    ///
+    ////////////////////////////////////////////////////////////
+    void BeginFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// Execute all the draw calls recorded since BeginFrame,
+    /// and go back to immediate drawing.
+    /// Draw calls are sorted by layer, then by blending mode and image
+    /// to minimize state changes ; the submission order is only kept
+    /// around view changes and objects that read the target (like PostFX)
+    ///
+    ////////////////////////////////////////////////////////////
+    void Flush();
+
+    ////////////////////////////////////////////////////////////
+    /// Change the layer of the next recorded draw calls.
+    /// Layers are drawn in increasing order when calling Flush.
+    /// The default layer is 0
+    ///
+    /// \param Layer : New layer
+    ///
+    ////////////////////////////////////////////////////////////
+    void SetLayer(unsigned int Layer);
+
     ////////////////////////////////////////////////////////////
     /// Get the width of the rendering region of the target
     ///
@@ -111,7 +153,9 @@ public :
     /// more CPU charge. Use this function if you don't want SFML
     /// to mess up your own OpenGL states (if any).
     /// Don't enable state preservation if not needed, as it will allow
-    /// SFML to do internal optimizations and improve performances.
+    /// SFML to do internal optimizations and improve performances ;
+    /// in particular, SFML then assumes that nobody else changes
+    /// the OpenGL states between two calls to Draw.
     /// This parameter is false by default
     ///
     /// \param Preserve : True to preserve OpenGL states, false to let SFML optimize
@@ -119,6 +163,35 @@ public :
     ////////////////////////////////////////////////////////////
     void PreserveOpenGLStates(bool Preserve);
 
+    ////////////////////////////////////////////////////////////
+    /// Get the number of OpenGL calls which were skipped because
+    /// they wouldn't have changed the current states, since the
+    /// last call to Clear
+    ///
+    /// \return Number of skipped OpenGL calls
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int GetNbElidedCalls() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Get the number of objects passed to Draw since the last
+    /// call to Clear
+    ///
+    /// \return Number of submitted objects
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int GetNbSubmittedObjects() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Get the number of objects which were not drawn because
+    /// they were entirely outside the current view, since the
+    /// last call to Clear
+    ///
+    /// \return Number of culled objects
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int GetNbCulledObjects() const;
+
 protected :
 
     ////////////////////////////////////////////////////////////
@@ -135,6 +208,8 @@ protected :
 
 private :
 
+    friend class Image;
+
     ////////////////////////////////////////////////////////////
     /// Activate the target for rendering
     ///
@@ -145,19 +220,86 @@ private :
     ////////////////////////////////////////////////////////////
     virtual bool Activate(bool Active) = 0;
 
+    ////////////////////////////////////////////////////////////
+    /// Tell whether the target stores its rows top to bottom,
+    /// like images, rather than bottom to top like OpenGL
+    /// framebuffers ; the projection is then flipped vertically
+    ///
+    /// \return True if the rows are stored top to bottom
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool IsTopToBottom() const;
+
     ////////////////////////////////////////////////////////////
     /// Set the OpenGL render states needed for the SFML rendering
     ///
     ////////////////////////////////////////////////////////////
     void SetRenderStates();
 
+    ////////////////////////////////////////////////////////////
+    /// Save the external OpenGL states if needed, and set the SFML ones
+    ///
+    ////////////////////////////////////////////////////////////
+    void BeginDrawing();
+
+    ////////////////////////////////////////////////////////////
+    /// Restore the external OpenGL states if needed
+    ///
+    ////////////////////////////////////////////////////////////
+    void EndDrawing();
+
+    ////////////////////////////////////////////////////////////
+    /// Set the viewport and projection matrix of a view
+    ///
+    /// \param ViewToApply : View to use for rendering
+    ///
+    ////////////////////////////////////////////////////////////
+    void ApplyView(const View& ViewToApply);
+
+    ////////////////////////////////////////////////////////////
+    /// Sort the recorded draw calls by key
+    ///
+    ////////////////////////////////////////////////////////////
+    void SortCommands();
+
+    ////////////////////////////////////////////////////////////
+    /// Defines a recorded draw call
+    ////////////////////////////////////////////////////////////
+    struct DrawCommand
+    {
+        Uint32          Key[3]; ///< Sort key, least significant word first (blending mode and image, sequence, layer)
+        unsigned int    View;   ///< Index of the view to use
+        unsigned int    State;  ///< Index of the states of the object when it was recorded
+        const Drawable* Object; ///< Object to draw
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Defines the states of an object when it was recorded
+    ////////////////////////////////////////////////////////////
+    struct DrawState
+    {
+        Matrix3     Matrix; ///< Transform matrix
+        Color       Col;    ///< Color
+        Blend::Mode Mode;   ///< Blending mode
+    };
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    View        myDefaultView;    ///< Default view
-    const View* myCurrentView;    ///< Current active view
-    bool        myPreserveStates; ///< Should we preserve external OpenGL states ?
-    bool        myIsDrawing;      ///< True when Draw is called from inside, to allow some renderstates optimizations
+    View                     myDefaultView;    ///< Default view
+    const View*              myCurrentView;    ///< Current active view
+    bool                     myPreserveStates; ///< Should we preserve external OpenGL states ?
+    bool                     myIsDrawing;      ///< True when Draw is called from inside, to allow some renderstates optimizations
+    bool                     myIsDeferring;    ///< True between BeginFrame and Flush
+    unsigned int             myLayer;          ///< Layer of the next recorded draw calls
+    unsigned int             mySequence;       ///< Index of the current sequence of recorded calls which can be reordered
+    std::vector<DrawCommand> myCommands;       ///< Draw calls recorded since BeginFrame
+    std::vector<DrawCommand> mySortBuffer;     ///< Temporary storage used when sorting the draw calls
+    std::vector<View>        myViews;          ///< Views used by the recorded draw calls
+    std::vector<DrawState>   myStates;         ///< States of the objects of the recorded draw calls
+    priv::GLStateCache*      myStateCache;     ///< Shadow copy of the OpenGL states of the target
+    unsigned int             myNbSubmitted;    ///< Number of objects passed to Draw since the last Clear
+    unsigned int             myNbCulled;       ///< Number of objects skipped since the last Clear
 };
 
 } // namespace sf
@@ -95,7 +95,9 @@ public :
     virtual unsigned int GetHeight() const;
 
     ////////////////////////////////////////////////////////////
-    /// Save the content of the window to an image
+    /// Save the content of the window to an image.
+    /// This function stalls the rendering ; to capture the
+    /// window every frame, use a FrameRecorder instead
     ///
     /// \return Image instance containing the contents of the screen
     ///
@@ -122,6 +124,12 @@ private :
     ////////////////////////////////////////////////////////////
     virtual void OnCreate();
 
+    ////////////////////////////////////////////////////////////
+    /// /see Window::OnDisplay
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void OnDisplay();
+
     ////////////////////////////////////////////////////////////
     /// /see RenderTarget::Activate
     ///
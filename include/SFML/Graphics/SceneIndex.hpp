@@ -0,0 +1,263 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_SCENEINDEX_HPP
+#define SFML_SCENEINDEX_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <utility>
+#include <vector>
+
+
+namespace sf
+{
+class Drawable;
+
+////////////////////////////////////////////////////////////
+/// SceneIndex stores drawable objects in a uniform grid
+/// according to their global bounds, to find the objects
+/// inside a rectangle (like the rectangle of a view) or under
+/// a point without testing all of them.
+/// Moving, rotating or scaling an object updates its place
+/// in the grid the next time the index is queried
+////////////////////////////////////////////////////////////
+class SFML_API SceneIndex : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Construct the index
+    ///
+    /// \param CellSize : Size of the cells of the grid ; should be a few times the size of a typical object (256 by default)
+    ///
+    ////////////////////////////////////////////////////////////
+    SceneIndex(float CellSize = 256.f);
+
+    ////////////////////////////////////////////////////////////
+    /// Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~SceneIndex();
+
+    ////////////////////////////////////////////////////////////
+    /// Add an object to the index. The object leaves the index
+    /// when it is destroyed ; an object can only belong to one
+    /// index at a time
+    ///
+    /// \param Object : Object to add
+    ///
+    /// \return False if the object already belongs to another index
+    ///
+    ////////////////////////////////////////////////////////////
+    bool Add(const Drawable& Object);
+
+    ////////////////////////////////////////////////////////////
+    /// Remove an object from the index
+    ///
+    /// \param Object : Object to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void Remove(const Drawable& Object);
+
+    ////////////////////////////////////////////////////////////
+    /// Update the place of an object whose size changed
+    /// (new sub-rectangle, text, points, ...) ; this is done
+    /// automatically when its position, rotation, scale or
+    /// center changes
+    ///
+    /// \param Object : Object to update
+    ///
+    ////////////////////////////////////////////////////////////
+    void Refresh(const Drawable& Object);
+
+    ////////////////////////////////////////////////////////////
+    /// Remove all the objects from the index
+    ///
+    ////////////////////////////////////////////////////////////
+    void Clear();
+
+    ////////////////////////////////////////////////////////////
+    /// Get the number of objects in the index
+    ///
+    /// \return Number of objects
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t GetNbObjects() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Find the objects whose global bounds intersect a rectangle.
+    /// Objects are appended in the order they were added,
+    /// so that they can be drawn directly
+    ///
+    /// \param Rect :    Rectangle to test, in global coordinates
+    /// \param Objects : Array to append the objects to
+    ///
+    /// \return Number of objects found
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t QueryRect(const FloatRect& Rect, std::vector<const Drawable*>& Objects);
+
+    ////////////////////////////////////////////////////////////
+    /// Find the objects whose global bounds contain a point.
+    /// Objects are appended in the order they were added
+    /// (the topmost one is the last)
+    ///
+    /// \param Point :   Point to test, in global coordinates (see RenderWindow::ConvertCoords)
+    /// \param Objects : Array to append the objects to
+    ///
+    /// \return Number of objects found
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t QueryPoint(const Vector2f& Point, std::vector<const Drawable*>& Objects);
+
+    ////////////////////////////////////////////////////////////
+    /// Find the topmost object under a point ; unlike QueryPoint,
+    /// the point is tested against the local bounds of the objects,
+    /// so that rotated objects are picked exactly
+    ///
+    /// \param Point : Point to test, in global coordinates (see RenderWindow::ConvertCoords)
+    ///
+    /// \return Object under the point, or NULL if there is none
+    ///
+    ////////////////////////////////////////////////////////////
+    const Drawable* Pick(const Vector2f& Point);
+
+private :
+
+    friend class Drawable;
+
+    ////////////////////////////////////////////////////////////
+    /// Called by an object of the index when its transform changes
+    ///
+    /// \param Index : Entry of the object
+    ///
+    ////////////////////////////////////////////////////////////
+    void NotifyMoved(unsigned int Index);
+
+    ////////////////////////////////////////////////////////////
+    /// Move the objects which changed since the last query
+    ///
+    ////////////////////////////////////////////////////////////
+    void Update();
+
+    ////////////////////////////////////////////////////////////
+    /// Compute the bounds of an entry and insert it into the cells it covers
+    ///
+    /// \param Index : Entry to insert
+    ///
+    ////////////////////////////////////////////////////////////
+    void Insert(unsigned int Index);
+
+    ////////////////////////////////////////////////////////////
+    /// Remove an entry from the cells it covers
+    ///
+    /// \param Index : Entry to remove
+    ///
+    ////////////////////////////////////////////////////////////
+    void Erase(unsigned int Index);
+
+    ////////////////////////////////////////////////////////////
+    /// Change the number of buckets of the grid
+    ///
+    /// \param NbBuckets : New number of buckets (must be a power of two)
+    ///
+    ////////////////////////////////////////////////////////////
+    void Rehash(std::size_t NbBuckets);
+
+    ////////////////////////////////////////////////////////////
+    /// Get the bucket storing a cell of the grid
+    ///
+    /// \param X : Horizontal index of the cell
+    /// \param Y : Vertical index of the cell
+    ///
+    /// \return Bucket of the cell
+    ///
+    ////////////////////////////////////////////////////////////
+    std::vector<unsigned int>& GetBucket(int X, int Y);
+
+    ////////////////////////////////////////////////////////////
+    /// Get the cell containing a coordinate
+    ///
+    /// \param Coordinate : Coordinate to convert
+    ///
+    /// \return Index of the cell along the coordinate's axis
+    ///
+    ////////////////////////////////////////////////////////////
+    int GetCell(float Coordinate) const;
+
+    ////////////////////////////////////////////////////////////
+    /// Test an entry against a rectangle, and keep it if it
+    /// intersects and wasn't already found by the current query
+    ///
+    /// \param Index : Entry to test
+    /// \param Rect :  Rectangle to test
+    ///
+    ////////////////////////////////////////////////////////////
+    void TestEntry(unsigned int Index, const FloatRect& Rect);
+
+    ////////////////////////////////////////////////////////////
+    /// Defines an object of the index
+    ////////////////////////////////////////////////////////////
+    struct Entry
+    {
+        const Drawable* Object;    ///< Object (NULL if the entry is free)
+        unsigned int    Order;     ///< Order in which the object was added
+        FloatRect       Bounds;    ///< Global bounds of the object when it was inserted
+        IntRect         Cells;     ///< Cells covered by the bounds (inclusive)
+        bool            HasBounds; ///< Does the object have bounds ?
+        bool            InGrid;    ///< Is the object stored in the grid, or in the list of large objects ?
+        bool            Moved;     ///< Has the object moved since it was inserted ?
+        unsigned int    Stamp;     ///< Last query which found the object
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Object found by a query, with its order
+    ////////////////////////////////////////////////////////////
+    typedef std::pair<unsigned int, const Drawable*> FoundObject;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    float                                   myCellSize;     ///< Size of the cells
+    std::vector<Entry>                      myEntries;      ///< Objects of the index
+    std::vector<unsigned int>               myFreeEntries;  ///< Entries which can be reused
+    std::vector<std::vector<unsigned int> > myBuckets;      ///< Entries stored in each bucket of the grid
+    std::vector<unsigned int>               myLargeEntries; ///< Entries which are too large for the grid, or have no bounds
+    std::vector<unsigned int>               myMovedEntries; ///< Entries which moved since the last query
+    std::vector<FoundObject>                myFound;        ///< Objects found by the current query, with their order
+    std::size_t                             myNbObjects;    ///< Number of objects in the index
+    unsigned int                            myNextOrder;    ///< Order of the next added object
+    unsigned int                            myStamp;        ///< Identifier of the current query
+};
+
+} // namespace sf
+
+
+#endif // SFML_SCENEINDEX_HPP
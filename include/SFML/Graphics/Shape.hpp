@@ -50,6 +50,30 @@ public :
     ////////////////////////////////////////////////////////////
     Shape();
 
+    ////////////////////////////////////////////////////////////
+    /// Copy constructor
+    ///
+    /// \param Copy : instance to copy
+    ///
+    ////////////////////////////////////////////////////////////
+    Shape(const Shape& Copy);
+
+    ////////////////////////////////////////////////////////////
+    /// Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~Shape();
+
+    ////////////////////////////////////////////////////////////
+    /// Assignment operator
+    ///
+    /// \param Other : instance to assign
+    ///
+    /// \return Reference to the shape
+    ///
+    ////////////////////////////////////////////////////////////
+    Shape& operator =(const Shape& Other);
+
     ////////////////////////////////////////////////////////////
     /// Add a point to the shape
     ///
@@ -261,6 +285,12 @@ protected :
     ////////////////////////////////////////////////////////////
     virtual void Render(RenderTarget& Target) const;
 
+    ////////////////////////////////////////////////////////////
+    /// /see Drawable::GetLocalBounds
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool GetLocalBounds(FloatRect& Bounds) const;
+
 private :
 
     ////////////////////////////////////////////////////////////
@@ -269,6 +299,13 @@ private :
     ////////////////////////////////////////////////////////////
     void Compile();
 
+    ////////////////////////////////////////////////////////////
+    /// Build the vertices of the fill and the outline, and
+    /// upload them to the vertex buffer if there is one
+    ///
+    ////////////////////////////////////////////////////////////
+    void UpdateVertices() const;
+
     ////////////////////////////////////////////////////////////
     /// Compute the normal of a given 2D segment
     ///
@@ -294,14 +331,27 @@ private :
         Color    OutlineCol; ///< Outline color of the point
     };
 
+    ////////////////////////////////////////////////////////////
+    /// Defines a vertex, with the GL_C4UB_V2F layout
+    ////////////////////////////////////////////////////////////
+    struct Vertex
+    {
+        Uint8 R, G, B, A; ///< Color of the vertex
+        float X, Y;       ///< Position of the vertex
+    };
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    std::vector<Point> myPoints;           ///< Points composing the shape
-    float              myOutline;          ///< Outline width
-    bool               myIsFillEnabled;    ///< Should we draw the inside if the shape ?
-    bool               myIsOutlineEnabled; ///< Should we draw the outline if the shape ?
-    bool               myIsCompiled;       ///< Compiled state of the shape
+    std::vector<Point>          myPoints;             ///< Points composing the shape
+    float                       myOutline;            ///< Outline width
+    bool                        myIsFillEnabled;      ///< Should we draw the inside if the shape ?
+    bool                        myIsOutlineEnabled;   ///< Should we draw the outline if the shape ?
+    bool                        myIsCompiled;         ///< Compiled state of the shape
+    mutable std::vector<Vertex> myVertices;           ///< Fill fan followed by the outline strip
+    mutable Color               myVerticesColor;      ///< Global color the vertices were built with
+    mutable bool                myNeedVerticesUpdate; ///< Do we need to rebuild the vertices ?
+    mutable unsigned int        myBuffer;             ///< OpenGL vertex buffer holding the vertices (0 if not supported)
 };
 
 } // namespace sf
@@ -159,8 +159,22 @@ protected :
     ////////////////////////////////////////////////////////////
     virtual void Render(RenderTarget& Target) const;
 
+    ////////////////////////////////////////////////////////////
+    /// /see Drawable::GetRenderImage
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual const Image* GetRenderImage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// /see Drawable::GetLocalBounds
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool GetLocalBounds(FloatRect& Bounds) const;
+
 private :
 
+    friend class SpriteBatch;
+
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_SPRITEBATCH_HPP
+#define SFML_SPRITEBATCH_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Drawable.hpp>
+#include <vector>
+
+
+namespace sf
+{
+class Image;
+class Sprite;
+
+////////////////////////////////////////////////////////////
+/// SpriteBatch gathers many sprites and draws them with
+/// a single OpenGL call for each pair of image and blend mode.
+/// Sprites are transformed on the CPU when they are added,
+/// so further changes to them are ignored until the batch
+/// is cleared and filled again
+////////////////////////////////////////////////////////////
+class SFML_API SpriteBatch : public Drawable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    SpriteBatch();
+
+    ////////////////////////////////////////////////////////////
+    /// Add a sprite to the batch.
+    /// Sprites sharing the same image and blend mode are drawn
+    /// together, in the order of the first sprite of each group
+    ///
+    /// \param Object : Sprite to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void Add(const Sprite& Object);
+
+    ////////////////////////////////////////////////////////////
+    /// Remove all the sprites from the batch.
+    /// The allocated memory is kept for the next sprites
+    ///
+    ////////////////////////////////////////////////////////////
+    void Clear();
+
+    ////////////////////////////////////////////////////////////
+    /// Get the number of sprites in the batch
+    ///
+    /// \return Number of sprites added since the last call to Clear
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t GetSize() const;
+
+protected :
+
+    ////////////////////////////////////////////////////////////
+    /// /see Drawable::Render
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void Render(RenderTarget& Target) const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// Defines a vertex of the batch, as expected by glInterleavedArrays
+    ////////////////////////////////////////////////////////////
+    struct Vertex
+    {
+        float TexX, TexY; ///< Texture coordinates
+        Uint8 R, G, B, A; ///< Color
+        float X, Y, Z;    ///< Position
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Defines a group of sprites drawn in a single call
+    ////////////////////////////////////////////////////////////
+    struct Group
+    {
+        const Image*        Texture;  ///< Image shared by the sprites (can be NULL)
+        Blend::Mode         Mode;     ///< Blending mode shared by the sprites
+        std::vector<Vertex> Vertices; ///< Transformed quads of the sprites
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Group> myGroups;    ///< Groups of sprites (only the first myNbGroups ones are in use)
+    std::size_t        myNbGroups;  ///< Number of groups in use
+    std::size_t        myNbSprites; ///< Number of sprites in the batch
+};
+
+} // namespace sf
+
+
+#endif // SFML_SPRITEBATCH_HPP
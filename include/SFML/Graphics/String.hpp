@@ -34,6 +34,7 @@
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Rect.hpp>
 #include <string>
+#include <vector>
 
 
 namespace sf
@@ -166,23 +167,67 @@ protected :
     ////////////////////////////////////////////////////////////
     virtual void Render(RenderTarget& Target) const;
 
+    ////////////////////////////////////////////////////////////
+    /// /see Drawable::GetRenderImage
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual const Image* GetRenderImage() const;
+
+    ////////////////////////////////////////////////////////////
+    /// /see Drawable::GetLocalBounds
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual bool GetLocalBounds(FloatRect& Bounds) const;
+
 private :
 
     ////////////////////////////////////////////////////////////
-    /// Recompute the bounding rectangle of the text
+    /// Make sure the geometry of the text is up-to-date
+    ///
+    ////////////////////////////////////////////////////////////
+    void UpdateGeometry() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Lay out the text : compute the vertices of the glyphs and
+    /// underlines, the position of each character and the bounding
+    /// rectangle of the text
     ///
     ////////////////////////////////////////////////////////////
-    void RecomputeRect();
+    void ComputeGeometry() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Defines a vertex of the text geometry
+    ////////////////////////////////////////////////////////////
+    struct Vertex
+    {
+        float TexX, TexY; ///< Texture coordinates of the vertex
+        float X, Y;       ///< Position of the vertex, in font units
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Defines a range of vertices using the same font page
+    ////////////////////////////////////////////////////////////
+    struct PageRange
+    {
+        unsigned int Page;  ///< Index of the font page
+        std::size_t  First; ///< Index of the first vertex
+        std::size_t  Count; ///< Number of vertices
+    };
 
     ////////////////////////////////////////////////////////////
     // Member data
     ////////////////////////////////////////////////////////////
-    Unicode::Text     myText;           ///< Text to display
-    ResourcePtr<Font> myFont;           ///< Font used to display the string
-    float             mySize;           ///< Size of the characters
-    unsigned long     myStyle;          ///< Text style (see Style enum)
-    FloatRect         myBaseRect;       ///< Bounding rectangle of the text in object coordinates
-    bool              myNeedRectUpdate; ///< Does the bounding rect need an update ?
+    Unicode::Text                 myText;               ///< Text to display
+    ResourcePtr<Font>             myFont;               ///< Font used to display the string
+    float                         mySize;               ///< Size of the characters
+    unsigned long                 myStyle;              ///< Text style (see Style enum)
+    mutable FloatRect             myBaseRect;           ///< Bounding rectangle of the text in object coordinates
+    mutable std::vector<Vertex>   myVertices;           ///< Quads of the glyphs, followed by the quads of the underlines
+    mutable std::size_t           myNbGlyphVertices;    ///< Number of vertices used by the glyphs
+    mutable std::vector<PageRange> myPageRanges;         ///< Glyph vertices, grouped by font page
+    mutable unsigned int          myFontGeneration;     ///< Generation of the font when the geometry was computed
+    mutable std::vector<Vector2f> myCharactersPos;      ///< Position of each character, plus the end of the text
+    mutable bool                  myNeedGeometryUpdate; ///< Does the geometry need an update ?
 };
 
 } // namespace sf
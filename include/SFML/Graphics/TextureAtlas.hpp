@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_TEXTUREATLAS_HPP
+#define SFML_TEXTUREATLAS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+class SkylinePacker;
+}
+
+////////////////////////////////////////////////////////////
+/// TextureAtlas packs many small images into a few large
+/// pages, so that sprites using them can share the same
+/// texture (and thus be batched together).
+/// Each image added to the atlas gives a region (page and
+/// sub-rectangle), to use with Sprite::SetImage and
+/// Sprite::SetSubRect
+////////////////////////////////////////////////////////////
+class SFML_API TextureAtlas : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Defines the location of an image in the atlas
+    ////////////////////////////////////////////////////////////
+    struct Region
+    {
+        ////////////////////////////////////////////////////////////
+        /// Default constructor
+        ///
+        ////////////////////////////////////////////////////////////
+        Region();
+
+        const Image* Texture; ///< Page containing the image (NULL if the image couldn't be added)
+        IntRect      Rect;    ///< Sub-rectangle of the page covered by the image
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Default constructor
+    ///
+    /// \param PageSize : Width and height of the pages (1024 by default)
+    /// \param Padding :  Space left around each image, in pixels (1 by default)
+    /// \param Extrude :  Fill the padding with the border pixels of the images, so that smoothing doesn't bleed between neighbours (true by default)
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureAtlas(unsigned int PageSize = 1024, unsigned int Padding = 1, bool Extrude = true);
+
+    ////////////////////////////////////////////////////////////
+    /// Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextureAtlas();
+
+    ////////////////////////////////////////////////////////////
+    /// Load an image from a file and add it to the atlas
+    ///
+    /// \param Filename : Path of the image file to load
+    ///
+    /// \return Region of the atlas containing the image (with a NULL texture if it failed)
+    ///
+    ////////////////////////////////////////////////////////////
+    Region AddFromFile(const std::string& Filename);
+
+    ////////////////////////////////////////////////////////////
+    /// Load an image from a file in memory and add it to the atlas
+    ///
+    /// \param Data :        Pointer to the file data in memory
+    /// \param SizeInBytes : Size of the data to load, in bytes
+    ///
+    /// \return Region of the atlas containing the image (with a NULL texture if it failed)
+    ///
+    ////////////////////////////////////////////////////////////
+    Region AddFromMemory(const char* Data, std::size_t SizeInBytes);
+
+    ////////////////////////////////////////////////////////////
+    /// Add an existing image (or a part of it) to the atlas.
+    /// The pixels are copied, the source image can be
+    /// destroyed afterwards
+    ///
+    /// \param Source :     Image to add
+    /// \param SourceRect : Sub-rectangle of the image to add (empty by default - entire image)
+    ///
+    /// \return Region of the atlas containing the image (with a NULL texture if it failed)
+    ///
+    ////////////////////////////////////////////////////////////
+    Region Add(const Image& Source, const IntRect& SourceRect = IntRect(0, 0, 0, 0));
+
+    ////////////////////////////////////////////////////////////
+    /// Remove all the images and pages of the atlas ; the
+    /// regions previously returned become invalid
+    ///
+    ////////////////////////////////////////////////////////////
+    void Clear();
+
+    ////////////////////////////////////////////////////////////
+    /// Enable or disable the smooth filter of all the pages.
+    /// This parameter is enabled by default
+    ///
+    /// \param Smooth : True to enable smoothing filter, false to disable it
+    ///
+    ////////////////////////////////////////////////////////////
+    void SetSmooth(bool Smooth);
+
+    ////////////////////////////////////////////////////////////
+    /// Get the number of pages of the atlas
+    ///
+    /// \return Number of pages
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int GetNbPages() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Get one of the pages of the atlas
+    ///
+    /// \param Index : Index of the page
+    ///
+    /// \return Image of the page
+    ///
+    ////////////////////////////////////////////////////////////
+    const Image& GetPage(unsigned int Index) const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// Add an array of pixels to the atlas
+    ///
+    /// \param Pixels : Pixels of the image to add
+    /// \param Width :  Width of the image, in pixels
+    /// \param Height : Height of the image, in pixels
+    /// \param Format : Format of the pixels
+    ///
+    /// \return Region of the atlas containing the image (with a NULL texture if it failed)
+    ///
+    ////////////////////////////////////////////////////////////
+    Region AddPixels(const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height, PixelFormat::Format Format);
+
+    ////////////////////////////////////////////////////////////
+    /// Find room for an image in the pages, adding a new page
+    /// if none of them has enough space left
+    ///
+    /// \param Width :  Width of the image, in pixels
+    /// \param Height : Height of the image, in pixels
+    /// \param Rect :   Receives the sub-rectangle of the page reserved for the image (padding excluded)
+    ///
+    /// \return Page containing the reserved area (NULL if it failed)
+    ///
+    ////////////////////////////////////////////////////////////
+    Image* Allocate(unsigned int Width, unsigned int Height, IntRect& Rect);
+
+    ////////////////////////////////////////////////////////////
+    /// Copy the border pixels of an image into the padding
+    /// around it
+    ///
+    /// \param Page : Page containing the image
+    /// \param Rect : Sub-rectangle of the page covered by the image
+    ///
+    ////////////////////////////////////////////////////////////
+    void ExtrudeBorders(Image& Page, const IntRect& Rect);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int                       myPageSize; ///< Width and height of the pages
+    unsigned int                       myPadding;  ///< Space left around each image
+    bool                               myExtrude;  ///< Fill the padding with the border pixels ?
+    bool                               myIsSmooth; ///< Smooth filter of the pages
+    std::deque<Image>                  myPages;    ///< Images of the pages
+    std::vector<priv::SkylinePacker*>  myPackers;  ///< Free space of each page
+};
+
+} // namespace sf
+
+
+#endif // SFML_TEXTUREATLAS_HPP
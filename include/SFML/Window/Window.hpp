@@ -289,6 +289,12 @@ private :
     ////////////////////////////////////////////////////////////
     virtual void OnCreate();
 
+    ////////////////////////////////////////////////////////////
+    /// Called before the window is displayed on screen
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void OnDisplay();
+
     ////////////////////////////////////////////////////////////
     /// /see WindowListener::OnEvent
     ///
@@ -177,11 +177,41 @@ PySfImage_LoadFromPixels(PySfImage* self, PyObject *args)
 static PyObject *
 PySfImage_GetPixels(PySfImage *self)
 {
+	unsigned int Width = self->obj->GetWidth(), Height = self->obj->GetHeight();
+	Py_ssize_t Size = Width*Height*4;
+
+	if (self->obj->GetFormat() == sf::PixelFormat::RGBA8)
+	{
+#ifdef IS_PY3K
+		return PyBytes_FromStringAndSize((const char *)(self->obj->GetPixelsPtr()), Size);
+#else
+		return PyString_FromStringAndSize((const char *)(self->obj->GetPixelsPtr()), Size);
+#endif
+	}
+
+	// Single-channel images (like font images) are expanded to RGBA
 #ifdef IS_PY3K
-	return PyBytes_FromStringAndSize((const char *)(self->obj->GetPixelsPtr()), self->obj->GetWidth()*self->obj->GetHeight()*4);
+	PyObject *Pixels = PyBytes_FromStringAndSize(NULL, Size);
 #else
-	return PyString_FromStringAndSize((const char *)(self->obj->GetPixelsPtr()), self->obj->GetWidth()*self->obj->GetHeight()*4);
+	PyObject *Pixels = PyString_FromStringAndSize(NULL, Size);
 #endif
+	if (Pixels == NULL)
+		return NULL;
+#ifdef IS_PY3K
+	sf::Uint8 *Dest = (sf::Uint8 *)PyBytes_AS_STRING(Pixels);
+#else
+	sf::Uint8 *Dest = (sf::Uint8 *)PyString_AS_STRING(Pixels);
+#endif
+	for (unsigned int y=0; y<Height; ++y)
+		for (unsigned int x=0; x<Width; ++x, Dest+=4)
+		{
+			sf::Color Pixel = self->obj->GetPixel(x, y);
+			Dest[0] = Pixel.r;
+			Dest[1] = Pixel.g;
+			Dest[2] = Pixel.b;
+			Dest[3] = Pixel.a;
+		}
+	return Pixels;
 }
 
 static PyObject *
@@ -0,0 +1,149 @@
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+
+
+////////////////////////////////////////////////////////////
+/// Get the paths of the image files contained in a directory
+///
+/// \param Directory : Directory to scan
+/// \param Files :     Paths of the image files found
+///
+/// \return False if the directory couldn't be opened
+///
+////////////////////////////////////////////////////////////
+bool FindImages(const std::string& Directory, std::vector<std::string>& Files)
+{
+    DIR* Dir = opendir(Directory.c_str());
+    if (!Dir)
+    {
+        std::cerr << "Failed to open directory \"" << Directory << "\"" << std::endl;
+        return false;
+    }
+
+    const char* Extensions[] = {".bmp", ".dds", ".hdr", ".jpg", ".jpeg", ".png", ".psd", ".tga"};
+    const std::size_t NbExtensions = sizeof(Extensions) / sizeof(*Extensions);
+
+    while (dirent* Entry = readdir(Dir))
+    {
+        std::string Name = Entry->d_name;
+        std::string Lower = Name;
+        std::transform(Lower.begin(), Lower.end(), Lower.begin(), ::tolower);
+
+        for (std::size_t i = 0; i < NbExtensions; ++i)
+        {
+            std::string Extension = Extensions[i];
+            if ((Lower.size() > Extension.size()) && (Lower.compare(Lower.size() - Extension.size(), Extension.size(), Extension) == 0))
+            {
+                Files.push_back(Directory + "/" + Name);
+                break;
+            }
+        }
+    }
+    closedir(Dir);
+
+    std::sort(Files.begin(), Files.end());
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Count the images which have been loaded successfully
+///
+/// \param Images : Images to check
+///
+/// \return Number of non-empty images
+///
+////////////////////////////////////////////////////////////
+std::size_t CountLoaded(const std::vector<sf::Image>& Images)
+{
+    std::size_t Count = 0;
+    for (std::size_t i = 0; i < Images.size(); ++i)
+    {
+        if (Images[i].GetWidth() > 0)
+            ++Count;
+    }
+
+    return Count;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application ; loads all the images of a
+/// directory one after the other, then all at once in the
+/// background, and compares the time taken by both ways
+///
+/// Usage : async-loading [directory]
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+    // Find the images to load
+    std::string Directory = (argc > 1) ? argv[1] : "datas/post-fx";
+    std::vector<std::string> Files;
+    if (!FindImages(Directory, Files))
+        return EXIT_FAILURE;
+    if (Files.empty())
+    {
+        std::cerr << "No image found in \"" << Directory << "\"" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << Files.size() << " images in \"" << Directory << "\"" << std::endl;
+
+    // Load everything once, so that both runs find the files in the system's disk cache
+    {
+        std::vector<sf::Image> Images(Files.size());
+        for (std::size_t i = 0; i < Files.size(); ++i)
+            Images[i].LoadFromFile(Files[i]);
+    }
+
+    // Serial loading : each call returns when its image is ready
+    {
+        std::vector<sf::Image> Images(Files.size());
+        sf::Clock Clock;
+        for (std::size_t i = 0; i < Files.size(); ++i)
+            Images[i].LoadFromFile(Files[i]);
+        float Time = Clock.GetElapsedTime();
+
+        std::cout << "LoadFromFile      : " << Time * 1000.f << " ms (" << CountLoaded(Images) << " images loaded)" << std::endl;
+    }
+
+    // Parallel loading : start all the requests, then poll them until they are all finished
+    {
+        std::vector<sf::Image> Images(Files.size());
+        sf::Clock Clock;
+        for (std::size_t i = 0; i < Files.size(); ++i)
+            Images[i].LoadFromFileAsync(Files[i]);
+
+        std::size_t NbPending = Files.size();
+        while (NbPending > 0)
+        {
+            NbPending = 0;
+            for (std::size_t i = 0; i < Images.size(); ++i)
+            {
+                if (Images[i].IsLoading())
+                    ++NbPending;
+            }
+
+            // Leave the CPU to the worker threads between two checks
+            if (NbPending > 0)
+                sf::Sleep(0.001f);
+        }
+        float Time = Clock.GetElapsedTime();
+
+        std::cout << "LoadFromFileAsync : " << Time * 1000.f << " ms (" << CountLoaded(Images) << " images loaded)" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,99 @@
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Time random glyph lookups in a font, and in a std::map
+/// holding the same glyphs for comparison
+///
+/// \param Name :       Name of the test, for display
+/// \param Font :       Font to query
+/// \param CodePoints : Characters set to look up
+///
+////////////////////////////////////////////////////////////
+void RunTest(const char* Name, const sf::Font& Font, const std::vector<sf::Uint32>& CodePoints)
+{
+    const int NbLookups = 1 << 16;
+    const int NbPasses  = 100;
+
+    // Build a random sequence of characters, as a text would use them
+    std::vector<sf::Uint32> Sequence(NbLookups);
+    for (int i = 0; i < NbLookups; ++i)
+        Sequence[i] = CodePoints[sf::Randomizer::Random(0, static_cast<int>(CodePoints.size()) - 1)];
+
+    // Build the std::map baseline out of the font's glyphs (this also warms up the font)
+    std::map<sf::Uint32, sf::Glyph> Map;
+    for (std::size_t i = 0; i < CodePoints.size(); ++i)
+        Map[CodePoints[i]] = Font.GetGlyph(CodePoints[i]);
+
+    // Sum the advances, so that the lookups can't be optimized away
+    long Sum = 0;
+
+    sf::Clock Clock;
+    for (int Pass = 0; Pass < NbPasses; ++Pass)
+        for (int i = 0; i < NbLookups; ++i)
+            Sum += Font.GetGlyph(Sequence[i]).Advance;
+    float FontTime = Clock.GetElapsedTime();
+
+    Clock.Reset();
+    for (int Pass = 0; Pass < NbPasses; ++Pass)
+        for (int i = 0; i < NbLookups; ++i)
+            Sum -= Map.find(Sequence[i])->second.Advance;
+    float MapTime = Clock.GetElapsedTime();
+
+    // Both loops add up the same advances
+    if (Sum != 0)
+        std::cerr << Name << " : the font and the map returned different glyphs" << std::endl;
+
+    const float NbTotal = static_cast<float>(NbLookups) * NbPasses;
+    std::cout << Name << " (" << CodePoints.size() << " characters)" << std::endl;
+    std::cout << "  sf::Font::GetGlyph : " << NbTotal / FontTime / 1000000.f << " million lookups per second" << std::endl;
+    std::cout << "  std::map::find     : " << NbTotal / MapTime  / 1000000.f << " million lookups per second" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application ; measures the speed of
+/// sf::Font::GetGlyph with the default characters set and
+/// with a large CJK characters set
+///
+/// Usage : glyph-lookup [font file for the CJK set]
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+    // The default font contains the printable ISO-8859-1 characters
+    std::vector<sf::Uint32> Latin;
+    for (sf::Uint32 c = 0x20; c < 0x7F; ++c)
+        Latin.push_back(c);
+    for (sf::Uint32 c = 0xA0; c < 0x100; ++c)
+        Latin.push_back(c);
+
+    RunTest("Default charset", sf::Font::GetDefaultFont(), Latin);
+
+    // Generate 5000 characters from the CJK unified ideographs block ; characters
+    // missing from the font get an entry anyway, so any font file can be used
+    std::vector<sf::Uint32> CJK;
+    for (sf::Uint32 c = 0x4E00; c < 0x4E00 + 5000; ++c)
+        CJK.push_back(c);
+    CJK.push_back(0);
+
+    const char* Filename = (argc > 1) ? argv[1] : "datas/post-fx/cheeseburger.ttf";
+    sf::Font Font;
+    if (!Font.LoadFromFile(Filename, 16, &CJK[0]))
+        return EXIT_FAILURE;
+    CJK.pop_back();
+
+    RunTest("CJK charset", Font, CJK);
+
+    return EXIT_SUCCESS;
+}
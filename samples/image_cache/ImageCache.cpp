@@ -0,0 +1,50 @@
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <string>
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application ; converts an image file to
+/// an image cache file, which sf::Image::LoadFromFile loads
+/// back much faster than the original image
+///
+/// Usage : image-cache [-raw] <source image> <cache file>
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+    // Parse the command line
+    bool Compress = true;
+    int  First    = 1;
+    if ((argc > 1) && (std::string(argv[1]) == "-raw"))
+    {
+        Compress = false;
+        First    = 2;
+    }
+
+    if (argc - First != 2)
+    {
+        std::cerr << "Usage : image-cache [-raw] <source image> <cache file>" << std::endl;
+        std::cerr << "  -raw : store the pixels uncompressed (bigger file, fastest loading)" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Load the source image
+    sf::Image Image;
+    if (!Image.LoadFromFile(argv[First]))
+        return EXIT_FAILURE;
+
+    // Write the cache file
+    if (!Image.SaveToCache(argv[First + 1], Compress))
+        return EXIT_FAILURE;
+
+    std::cout << argv[First] << " -> " << argv[First + 1] << " (" << Image.GetWidth() << "x" << Image.GetHeight() << ")" << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,232 @@
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/System.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// The plain C++ and SSE2 versions of the routines are private to the
+// graphics module : we compile its source file here to call them directly
+#include "../../src/SFML/Graphics/PixelKernels.cpp"
+
+
+#ifdef SFML_PIXELKERNELS_SSE2
+
+////////////////////////////////////////////////////////////
+/// Common signature of the tested routines : Dst is the
+/// row of pixels to write, Src the source pixels (two rows
+/// of 2 * Count pixels, enough for every routine)
+////////////////////////////////////////////////////////////
+typedef void (*Kernel)(sf::Uint8* Dst, const sf::Uint8* Src, std::size_t Count);
+
+const sf::Uint8 Key[4]         = {16, 32, 48, 64};
+const sf::Uint8 Replacement[4] = {1, 2, 3, 4};
+const sf::Uint8 FillColor[4]   = {5, 6, 7, 8};
+
+sf::Uint32 ToUint32(const sf::Uint8* Components)
+{
+    sf::Uint32 Value;
+    std::memcpy(&Value, Components, 4);
+    return Value;
+}
+
+void ReplaceColorC(sf::Uint8* Dst, const sf::Uint8*, std::size_t Count)
+{
+    ReplaceColorScalar(Dst, Count, ToUint32(Key), ToUint32(Replacement));
+}
+
+void ReplaceColorSIMD(sf::Uint8* Dst, const sf::Uint8*, std::size_t Count)
+{
+    ReplaceColorSSE2(Dst, Count, ToUint32(Key), ToUint32(Replacement));
+}
+
+void FillC(sf::Uint8* Dst, const sf::Uint8*, std::size_t Count)
+{
+    FillScalar(Dst, Count, ToUint32(FillColor));
+}
+
+void FillSIMD(sf::Uint8* Dst, const sf::Uint8*, std::size_t Count)
+{
+    FillSSE2(Dst, Count, ToUint32(FillColor));
+}
+
+void HalveRowsC(sf::Uint8* Dst, const sf::Uint8* Src, std::size_t Count)
+{
+    HalveRowsScalar(Dst, Src, Src + Count * 8, Count);
+}
+
+void HalveRowsSIMD(sf::Uint8* Dst, const sf::Uint8* Src, std::size_t Count)
+{
+    HalveRowsSSE2(Dst, Src, Src + Count * 8, Count);
+}
+
+struct Test
+{
+    const char* Name;
+    Kernel      Scalar;
+    Kernel      SSE2;
+};
+
+const Test Tests[] =
+{
+    {"BlendRGB",     &BlendRGBScalar,  &BlendRGBSSE2},
+    {"ReplaceColor", &ReplaceColorC,   &ReplaceColorSIMD},
+    {"Fill",         &FillC,           &FillSIMD},
+    {"ExpandRGB",    &ExpandRGBScalar, &ExpandRGBSSE2},
+    {"HalveRows",    &HalveRowsC,      &HalveRowsSIMD}
+};
+const std::size_t NbTests = sizeof(Tests) / sizeof(*Tests);
+
+
+////////////////////////////////////////////////////////////
+/// Fill buffers with random pixels ; one destination pixel
+/// out of three gets the color key, so that ReplaceColor
+/// has something to replace
+///
+/// \param Dst :   Destination pixels to generate
+/// \param Src :   Source pixels to generate
+/// \param Count : Number of destination pixels
+///
+////////////////////////////////////////////////////////////
+void Generate(std::vector<sf::Uint8>& Dst, std::vector<sf::Uint8>& Src, std::size_t Count)
+{
+    Dst.resize(Count * 4 + 4);
+    Src.resize(Count * 16 + 4);
+    for (std::size_t i = 0; i < Dst.size(); ++i)
+        Dst[i] = static_cast<sf::Uint8>(sf::Randomizer::Random(0, 255));
+    for (std::size_t i = 0; i < Src.size(); ++i)
+        Src[i] = static_cast<sf::Uint8>(sf::Randomizer::Random(0, 255));
+    for (std::size_t i = 0; i < Count; i += 3)
+    {
+        std::memcpy(&Dst[i * 4], Key, 4);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Check that the plain C++ and SSE2 versions of a routine
+/// produce the same bytes, for several odd widths and for
+/// both aligned and unaligned rows
+///
+/// \param Routine : Routine to check
+///
+/// \return True if all the results are identical
+///
+////////////////////////////////////////////////////////////
+bool Compare(const Test& Routine)
+{
+    const std::size_t Widths[] = {1, 3, 7, 15, 17, 33, 1023, 4097};
+    const std::size_t NbWidths = sizeof(Widths) / sizeof(*Widths);
+
+    bool Identical = true;
+    for (std::size_t i = 0; i < NbWidths; ++i)
+    {
+        std::vector<sf::Uint8> Original, Src;
+        Generate(Original, Src, Widths[i]);
+
+        // Offset 0 keeps the buffers aligned, offset 4 moves them by one pixel
+        for (std::size_t Offset = 0; Offset <= 4; Offset += 4)
+        {
+            std::vector<sf::Uint8> Scalar = Original;
+            Routine.Scalar(&Scalar[Offset], &Src[Offset], Widths[i]);
+
+            std::vector<sf::Uint8> SSE2 = Original;
+            Routine.SSE2(&SSE2[Offset], &Src[Offset], Widths[i]);
+
+            if (std::memcmp(&Scalar[0], &SSE2[0], Scalar.size()) != 0)
+            {
+                std::cout << "  results differ for width " << Widths[i] << ", offset " << Offset << std::endl;
+                Identical = false;
+            }
+        }
+    }
+
+    return Identical;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Measure the speed of a routine
+///
+/// \param Function : Routine to measure
+///
+/// \return Number of million pixels processed per second
+///
+////////////////////////////////////////////////////////////
+float Measure(Kernel Function)
+{
+    const std::size_t Count  = 1 << 18;
+    const int         NbRuns = 100;
+
+    std::vector<sf::Uint8> Original, Src;
+    Generate(Original, Src, Count);
+    std::vector<sf::Uint8> Dst(Original.size());
+
+    // Restore the destination before each run, and only time the routine itself
+    float Time = 0.f;
+    for (int i = 0; i < NbRuns; ++i)
+    {
+        std::memcpy(&Dst[0], &Original[0], Dst.size());
+        sf::Clock Clock;
+        Function(&Dst[0], &Src[0], Count);
+        Time += Clock.GetElapsedTime();
+    }
+
+    return static_cast<float>(Count) * NbRuns / Time / 1000000.f;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application ; checks that the plain C++
+/// and SSE2 versions of the pixel routines used by sf::Image
+/// give the same results, and compares their speed
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    if (!DetectSSE2())
+    {
+        std::cout << "SSE2 is not supported on this CPU, only the plain C++ versions are available" << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    bool Identical = true;
+    std::cout << std::left  << std::setw(14) << "Routine"
+              << std::right << std::setw(14) << "C++ (Mpix/s)" << std::setw(15) << "SSE2 (Mpix/s)" << "  Results" << std::endl;
+    for (std::size_t i = 0; i < NbTests; ++i)
+    {
+        bool Same = Compare(Tests[i]);
+        Identical = Identical && Same;
+
+        float Scalar = Measure(Tests[i].Scalar);
+        float SSE2   = Measure(Tests[i].SSE2);
+
+        std::cout << std::left  << std::setw(14) << Tests[i].Name
+                  << std::right << std::setw(14) << static_cast<int>(Scalar) << std::setw(15) << static_cast<int>(SSE2)
+                  << "  " << (Same ? "identical" : "DIFFERENT") << std::endl;
+    }
+
+    return Identical ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+////////////////////////////////////////////////////////////
+/// Entry point of application, for CPUs without SSE2
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main()
+{
+    std::cout << "SSE2 is not available on this platform, only the plain C++ versions are compiled" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+#endif // SFML_PIXELKERNELS_SSE2
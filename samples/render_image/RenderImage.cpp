@@ -0,0 +1,123 @@
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+
+////////////////////////////////////////////////////////////
+/// Check the color of a pixel of an image, and print the result
+///
+/// \param Image :    Image to check
+/// \param X :        X coordinate of the pixel
+/// \param Y :        Y coordinate of the pixel
+/// \param Expected : Name of the expected color
+/// \param Match :    Does the pixel have the expected color?
+///
+/// \return Value of Match
+///
+////////////////////////////////////////////////////////////
+bool Check(const sf::Image& Image, unsigned int X, unsigned int Y, const char* Expected, bool Match)
+{
+    sf::Color Pixel = Image.GetPixel(X, Y);
+    std::cout << "  pixel (" << X << ", " << Y << ") = (" << static_cast<int>(Pixel.r) << ", "
+              << static_cast<int>(Pixel.g) << ", " << static_cast<int>(Pixel.b) << "), expected "
+              << Expected << (Match ? " : ok" : " : WRONG") << std::endl;
+
+    return Match;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application ; draws a scene into a render
+/// image, then applies a post-effect to it through a
+/// sf::PostFXChain, and saves both results to PNG files.
+/// Both files must show the red square in the top-left
+/// corner ; running with LIBGL_ALWAYS_SOFTWARE=1 checks
+/// the software OpenGL implementation
+///
+/// Usage : render-image [output directory]
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+    std::string Directory = (argc > 1) ? std::string(argv[1]) + "/" : "";
+
+    if (!sf::RenderImage::CanUseRenderImage())
+    {
+        std::cerr << "Render images are not supported by your system" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // The chain owns the render image receiving the scene ; the size isn't
+    // a power of two, so that non-power-of-two textures are checked too
+    const unsigned int Width  = 320;
+    const unsigned int Height = 240;
+    sf::PostFXChain Chain;
+    if (!Chain.Create(Width, Height))
+        return EXIT_FAILURE;
+
+    // Draw a scene which shows the orientation : red square at the top-left,
+    // green square at the top-right, blue bar along the bottom, text at the top
+    sf::RenderImage& Scene = Chain.GetScene();
+    Scene.Clear(sf::Color(40, 40, 40));
+    Scene.Draw(sf::Shape::Rectangle(0, 0, 40, 40, sf::Color(255, 0, 0)));
+    Scene.Draw(sf::Shape::Rectangle(Width - 40.f, 0, static_cast<float>(Width), 40, sf::Color(0, 255, 0)));
+    Scene.Draw(sf::Shape::Rectangle(0, Height - 20.f, static_cast<float>(Width), static_cast<float>(Height), sf::Color(0, 0, 255)));
+    sf::String Text("Top", sf::Font::GetDefaultFont(), 30.f);
+    Text.SetPosition(60.f, 5.f);
+    Scene.Draw(Text);
+    Scene.Display();
+
+    // Save the scene and check its orientation
+    std::cout << "Scene :" << std::endl;
+    const sf::Image& SceneImage = Scene.GetImage();
+    if (!SceneImage.SaveToFile(Directory + "render_image.png"))
+        return EXIT_FAILURE;
+
+    bool Success = true;
+    Success = Check(SceneImage, 10, 10, "red", SceneImage.GetPixel(10, 10) == sf::Color(255, 0, 0)) && Success;
+    Success = Check(SceneImage, Width - 10, 10, "green", SceneImage.GetPixel(Width - 10, 10) == sf::Color(0, 255, 0)) && Success;
+    Success = Check(SceneImage, 10, Height - 10, "blue", SceneImage.GetPixel(10, Height - 10) == sf::Color(0, 0, 255)) && Success;
+
+    if (!sf::PostFX::CanUsePostFX())
+    {
+        std::cerr << "Post-effects are not supported by your system" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Mix the scene with its shades of orange (40% of the original, 60% of the orange)
+    sf::PostFX Colorize;
+    if (!Colorize.LoadFromFile("datas/post-fx/colorize.sfx"))
+        return EXIT_FAILURE;
+    Colorize.SetTexture("framebuffer", NULL);
+    Colorize.SetParameter("color", 1.f, 0.5f, 0.f);
+    Chain.AddEffect(Colorize);
+
+    // Apply the chain into another render image, and save the result
+    sf::RenderImage Result;
+    if (!Result.Create(Width, Height))
+        return EXIT_FAILURE;
+    Chain.Draw(Result);
+    Result.Display();
+
+    std::cout << "Post-effect :" << std::endl;
+    const sf::Image& ResultImage = Result.GetImage();
+    if (!ResultImage.SaveToFile(Directory + "render_image_postfx.png"))
+        return EXIT_FAILURE;
+
+    // Red becomes (162, 30, 0) and blue (17, 8, 102) ; leave some room for rounding
+    sf::Color TopLeft    = ResultImage.GetPixel(10, 10);
+    sf::Color BottomLeft = ResultImage.GetPixel(10, Height - 10);
+    Success = Check(ResultImage, 10, 10, "(162, 30, 0)", (TopLeft.r > 150) && (TopLeft.r < 175) && (TopLeft.b < 10)) && Success;
+    Success = Check(ResultImage, 10, Height - 10, "(17, 8, 102)", (BottomLeft.r < 30) && (BottomLeft.b > 90) && (BottomLeft.b < 115)) && Success;
+
+    std::cout << "Saved " << Directory << "render_image.png and " << Directory << "render_image_postfx.png" << std::endl;
+
+    return Success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,117 @@
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////
+/// Draw the sprites for a number of frames, either one by
+/// one or through a sprite batch, and print the timings
+///
+/// \param App :      Window to draw to
+/// \param Sprites :  Sprites to draw
+/// \param NbFrames : Number of frames to draw
+/// \param Batched :  Draw through a sprite batch?
+///
+/// \return False if the window has been closed
+///
+////////////////////////////////////////////////////////////
+bool RunTest(sf::RenderWindow& App, const std::vector<sf::Sprite>& Sprites, int NbFrames, bool Batched)
+{
+    sf::SpriteBatch Batch;
+    sf::Clock       Clock;
+
+    for (int Frame = 0; Frame < NbFrames; ++Frame)
+    {
+        // Process events
+        sf::Event Event;
+        while (App.GetEvent(Event))
+        {
+            if ((Event.Type == sf::Event::Closed) ||
+               ((Event.Type == sf::Event::KeyPressed) && (Event.Key.Code == sf::Key::Escape)))
+            {
+                App.Close();
+                return false;
+            }
+        }
+
+        App.Clear();
+
+        if (Batched)
+        {
+            // Rebuild the batch every frame, as a game with moving sprites would do
+            Batch.Clear();
+            for (std::size_t i = 0; i < Sprites.size(); ++i)
+                Batch.Add(Sprites[i]);
+            App.Draw(Batch);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < Sprites.size(); ++i)
+                App.Draw(Sprites[i]);
+        }
+
+        App.Display();
+    }
+
+    float Time = Clock.GetElapsedTime();
+    std::cout << (Batched ? "sprite batch : " : "one by one   : ")
+              << Time * 1000.f / NbFrames << " ms per frame, "
+              << static_cast<float>(Sprites.size()) * NbFrames / Time << " sprites per second" << std::endl;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of application ; draws the same sprites one
+/// by one and through a sf::SpriteBatch, and compares the
+/// time spent per frame
+///
+/// Usage : sprite-batch [number of sprites]
+///
+/// \return Application exit code
+///
+////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+    // Parse the command line
+    int NbSprites = (argc > 1) ? std::atoi(argv[1]) : 10000;
+    if (NbSprites <= 0)
+    {
+        std::cerr << "Usage : sprite-batch [number of sprites]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int NbFrames = 200;
+
+    // Create the main window ; disable vertical sync so that it doesn't cap the timings
+    sf::RenderWindow App(sf::VideoMode(800, 600, 32), "SFML Sprite batch");
+    App.UseVerticalSync(false);
+
+    // Create two small images, so that the batch has to deal with more than one texture
+    sf::Image Images[2];
+    if (!Images[0].Create(16, 16, sf::Color(255, 128, 0)) || !Images[1].Create(16, 16, sf::Color(0, 128, 255)))
+        return EXIT_FAILURE;
+
+    // Scatter the sprites over the window
+    std::vector<sf::Sprite> Sprites(NbSprites);
+    for (int i = 0; i < NbSprites; ++i)
+    {
+        Sprites[i].SetImage(Images[i % 2]);
+        Sprites[i].SetCenter(8.f, 8.f);
+        Sprites[i].SetPosition(sf::Randomizer::Random(0.f, 800.f), sf::Randomizer::Random(0.f, 600.f));
+        Sprites[i].SetRotation(sf::Randomizer::Random(0.f, 360.f));
+    }
+
+    std::cout << NbSprites << " sprites, " << NbFrames << " frames" << std::endl;
+
+    // Draw them one by one, then batched
+    if (RunTest(App, Sprites, NbFrames, false))
+        RunTest(App, Sprites, NbFrames, true);
+
+    return EXIT_SUCCESS;
+}
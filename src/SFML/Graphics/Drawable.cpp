@@ -27,7 +27,11 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Drawable.hpp>
 #include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/GLStateCache.hpp>
+#include <SFML/Graphics/SceneIndex.hpp>
 #include <SFML/Window/Window.hpp>
+#include <algorithm>
+#include <iostream>
 #include <math.h>
 
 
@@ -37,25 +41,80 @@ namespace sf
 /// Default constructor
 ////////////////////////////////////////////////////////////
 Drawable::Drawable(const Vector2f& Position, const Vector2f& Scale, float Rotation, const Color& Col) :
-myPosition     (Position),
-myScale        (Scale),
-myCenter       (0, 0),
-myRotation     (Rotation),
-myColor        (Col),
-myBlendMode    (Blend::Alpha),
-myNeedUpdate   (true),
-myInvNeedUpdate(true)
+myPosition        (Position),
+myScale           (Scale),
+myCenter          (0, 0),
+myRotation        (Rotation),
+myColor           (Col),
+myBlendMode       (Blend::Alpha),
+myNeedUpdate      (true),
+myInvNeedUpdate   (true),
+myParent          (NULL),
+myGlobalNeedUpdate(true),
+myIndex           (NULL),
+myIndexEntry      (0),
+myRenderColor     (Col)
 {
 
 }
 
 
+////////////////////////////////////////////////////////////
+/// Copy constructor
+////////////////////////////////////////////////////////////
+Drawable::Drawable(const Drawable& Copy) :
+myPosition        (Copy.myPosition),
+myScale           (Copy.myScale),
+myCenter          (Copy.myCenter),
+myRotation        (Copy.myRotation),
+myColor           (Copy.myColor),
+myBlendMode       (Copy.myBlendMode),
+myNeedUpdate      (true),
+myInvNeedUpdate   (true),
+myParent          (NULL),
+myGlobalNeedUpdate(true),
+myIndex           (NULL),
+myIndexEntry      (0),
+myRenderColor     (Copy.myColor)
+{
+    SetParent(Copy.myParent);
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Virtual destructor
 ////////////////////////////////////////////////////////////
 Drawable::~Drawable()
 {
-    // Nothing to do
+    // Don't leave a dangling pointer in the scene index
+    if (myIndex)
+        myIndex->Remove(*this);
+
+    // Detach the children, which keep their transform relative to us
+    for (std::vector<Drawable*>::iterator i = myChildren.begin(); i != myChildren.end(); ++i)
+    {
+        (*i)->myParent = NULL;
+        (*i)->InvalidateGlobalTransform();
+    }
+
+    SetParent(NULL);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Assignment operator
+////////////////////////////////////////////////////////////
+Drawable& Drawable::operator =(const Drawable& Other)
+{
+    myPosition  = Other.myPosition;
+    myScale     = Other.myScale;
+    myCenter    = Other.myCenter;
+    myRotation  = Other.myRotation;
+    myColor     = Other.myColor;
+    myBlendMode = Other.myBlendMode;
+    InvalidateTransform();
+
+    return *this;
 }
 
 
@@ -84,9 +143,8 @@ void Drawable::SetPosition(const Vector2f& Position)
 ////////////////////////////////////////////////////////////
 void Drawable::SetX(float X)
 {
-    myPosition.x    = X;
-    myNeedUpdate    = true;
-    myInvNeedUpdate = true;
+    myPosition.x = X;
+    InvalidateTransform();
 }
 
 
@@ -95,9 +153,8 @@ void Drawable::SetX(float X)
 ////////////////////////////////////////////////////////////
 void Drawable::SetY(float Y)
 {
-    myPosition.y    = Y;
-    myNeedUpdate    = true;
-    myInvNeedUpdate = true;
+    myPosition.y = Y;
+    InvalidateTransform();
 }
 
 
@@ -128,9 +185,8 @@ void Drawable::SetScaleX(float FactorX)
 {
     if (FactorX > 0)
     {
-        myScale.x       = FactorX;
-        myNeedUpdate    = true;
-        myInvNeedUpdate = true;
+        myScale.x = FactorX;
+        InvalidateTransform();
     }
 }
 
@@ -142,9 +198,8 @@ void Drawable::SetScaleY(float FactorY)
 {
     if (FactorY > 0)
     {
-        myScale.y       = FactorY;
-        myNeedUpdate    = true;
-        myInvNeedUpdate = true;
+        myScale.y = FactorY;
+        InvalidateTransform();
     }
 }
 
@@ -156,10 +211,9 @@ void Drawable::SetScaleY(float FactorY)
 ////////////////////////////////////////////////////////////
 void Drawable::SetCenter(float CenterX, float CenterY)
 {
-    myCenter.x      = CenterX;
-    myCenter.y      = CenterY;
-    myNeedUpdate    = true;
-    myInvNeedUpdate = true;
+    myCenter.x = CenterX;
+    myCenter.y = CenterY;
+    InvalidateTransform();
 }
 
 
@@ -182,8 +236,7 @@ void Drawable::SetRotation(float Rotation)
     myRotation = static_cast<float>(fmod(Rotation, 360));
     if (myRotation < 0)
         myRotation += 360.f;
-    myNeedUpdate    = true;
-    myInvNeedUpdate = true;
+    InvalidateTransform();
 }
 
 
@@ -207,6 +260,39 @@ void Drawable::SetBlendMode(Blend::Mode Mode)
 }
 
 
+////////////////////////////////////////////////////////////
+/// Attach the object to a parent
+////////////////////////////////////////////////////////////
+void Drawable::SetParent(const Drawable* Parent)
+{
+    if (Parent == myParent)
+        return;
+
+    // Make sure we don't create a cycle
+    for (const Drawable* Ancestor = Parent; Ancestor; Ancestor = Ancestor->myParent)
+    {
+        if (Ancestor == this)
+        {
+            std::cerr << "Failed to set the parent of a drawable : it would become its own ancestor" << std::endl;
+            return;
+        }
+    }
+
+    // Leave the previous parent
+    if (myParent)
+    {
+        std::vector<Drawable*>& Siblings = myParent->myChildren;
+        Siblings.erase(std::find(Siblings.begin(), Siblings.end(), this));
+    }
+
+    myParent = Parent;
+    if (myParent)
+        myParent->myChildren.push_back(this);
+
+    InvalidateGlobalTransform();
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Get the position of the object
 ////////////////////////////////////////////////////////////
@@ -261,6 +347,15 @@ Blend::Mode Drawable::GetBlendMode() const
 }
 
 
+////////////////////////////////////////////////////////////
+/// Get the parent of the object
+////////////////////////////////////////////////////////////
+const Drawable* Drawable::GetParent() const
+{
+    return myParent;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Move the object of a given offset (take 2 values)
 ///
@@ -328,19 +423,60 @@ sf::Vector2f Drawable::TransformToGlobal(const sf::Vector2f& Point) const
 }
 
 
+////////////////////////////////////////////////////////////
+/// Get the bounding rectangle of the object in global coordinates
+////////////////////////////////////////////////////////////
+bool Drawable::GetGlobalBounds(FloatRect& Bounds) const
+{
+    FloatRect Local;
+    if (!GetLocalBounds(Local))
+        return false;
+
+    // Transform the four corners, as the object may be rotated
+    const Matrix3& Matrix = GetMatrix();
+    Vector2f Corners[4] =
+    {
+        Matrix.Transform(Vector2f(Local.Left,  Local.Top)),
+        Matrix.Transform(Vector2f(Local.Right, Local.Top)),
+        Matrix.Transform(Vector2f(Local.Right, Local.Bottom)),
+        Matrix.Transform(Vector2f(Local.Left,  Local.Bottom))
+    };
+
+    Bounds = FloatRect(Corners[0].x, Corners[0].y, Corners[0].x, Corners[0].y);
+    for (int i = 1; i < 4; ++i)
+    {
+        Bounds.Left   = std::min(Bounds.Left,   Corners[i].x);
+        Bounds.Top    = std::min(Bounds.Top,    Corners[i].y);
+        Bounds.Right  = std::max(Bounds.Right,  Corners[i].x);
+        Bounds.Bottom = std::max(Bounds.Bottom, Corners[i].y);
+    }
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Get the transform matrix of the drawable
 ////////////////////////////////////////////////////////////
 const Matrix3& Drawable::GetMatrix() const
 {
     // First recompute it if needed
-    if (myNeedUpdate)
+    if (myGlobalNeedUpdate)
     {
-        myMatrix.SetFromTransformations(myCenter, myPosition, myRotation, myScale);
-        myNeedUpdate = false;
+        if (myNeedUpdate)
+        {
+            myMatrix.SetFromTransformations(myCenter, myPosition, myRotation, myScale);
+            myNeedUpdate = false;
+        }
+
+        // Combine it with the parent's one, which is only recomputed if it changed too
+        if (myParent)
+            myGlobalMatrix = myParent->GetMatrix() * myMatrix;
+
+        myGlobalNeedUpdate = false;
     }
 
-    return myMatrix;
+    return myParent ? myGlobalMatrix : myMatrix;
 }
 
 
@@ -360,42 +496,108 @@ const Matrix3& Drawable::GetInverseMatrix() const
 }
 
 
+////////////////////////////////////////////////////////////
+/// Get the color the object is being rendered with
+////////////////////////////////////////////////////////////
+const Color& Drawable::GetRenderColor() const
+{
+    return myRenderColor;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the image bound when rendering the object
+////////////////////////////////////////////////////////////
+const Image* Drawable::GetRenderImage() const
+{
+    return NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Tell whether the object reads the current contents of the
+/// target when it is rendered
+////////////////////////////////////////////////////////////
+bool Drawable::ReadsTarget() const
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the bounding rectangle of the object in local coordinates
+////////////////////////////////////////////////////////////
+bool Drawable::GetLocalBounds(FloatRect&) const
+{
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Mark the transform matrices as outdated, and tell the
+/// scene index containing the object that it has moved
+////////////////////////////////////////////////////////////
+void Drawable::InvalidateTransform()
+{
+    myNeedUpdate = true;
+
+    InvalidateGlobalTransform();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Mark the global transform of the object and of its
+/// children as outdated
+////////////////////////////////////////////////////////////
+void Drawable::InvalidateGlobalTransform() const
+{
+    // If our global transform is already outdated, so are the ones of our children
+    if (myGlobalNeedUpdate)
+        return;
+
+    myGlobalNeedUpdate = true;
+    myInvNeedUpdate    = true;
+
+    if (myIndex)
+        myIndex->NotifyMoved(myIndexEntry);
+
+    for (std::vector<Drawable*>::const_iterator i = myChildren.begin(); i != myChildren.end(); ++i)
+        (*i)->InvalidateGlobalTransform();
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Draw the object into the specified window
 ////////////////////////////////////////////////////////////
 void Drawable::Draw(RenderTarget& Target) const
+{
+    Draw(Target, GetMatrix(), myColor, myBlendMode);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Draw the object into the specified window, with the
+/// states it had when the draw call was recorded
+////////////////////////////////////////////////////////////
+void Drawable::Draw(RenderTarget& Target, const Matrix3& Matrix, const Color& Col, Blend::Mode Mode) const
 {
     // Save the current modelview matrix and set the new one
-    GLCheck(glMatrixMode(GL_MODELVIEW));
+    priv::GLStateCache::SetMatrixMode(GL_MODELVIEW);
     GLCheck(glPushMatrix());
-    GLCheck(glMultMatrixf(GetMatrix().Get4x4Elements()));
+    GLCheck(glMultMatrixf(Matrix.Get4x4Elements()));
 
     // Setup alpha-blending
-    if (myBlendMode == Blend::None)
-    {
-        GLCheck(glDisable(GL_BLEND));
-    }
-    else
-    {
-        GLCheck(glEnable(GL_BLEND));
-
-        switch (myBlendMode)
-        {
-            case Blend::Alpha :    GLCheck(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)); break;
-            case Blend::Add :      GLCheck(glBlendFunc(GL_SRC_ALPHA, GL_ONE));                 break;
-            case Blend::Multiply : GLCheck(glBlendFunc(GL_DST_COLOR, GL_ZERO));                break;
-            default :                                                                          break;
-        }
-    }
+    priv::GLStateCache::SetBlendMode(Mode);
 
     // Set color
-    GLCheck(glColor4f(myColor.r / 255.f, myColor.g / 255.f, myColor.b / 255.f, myColor.a / 255.f));
+    priv::GLStateCache::SetColor(Col);
+    myRenderColor = Col;
 
     // Let the derived class render the object geometry
     Render(Target);
 
     // Restore the previous modelview matrix
-    GLCheck(glMatrixMode(GL_MODELVIEW));
+    priv::GLStateCache::SetMatrixMode(GL_MODELVIEW);
     GLCheck(glPopMatrix());
 }
 
@@ -27,9 +27,21 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/FontLoader.hpp>
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 
 
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Size and maximum number of the pages used by dynamic fonts
+    ////////////////////////////////////////////////////////////
+    const unsigned int PageSize = 512;
+    const unsigned int MaxPages = 16;
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
@@ -62,9 +74,43 @@ Uint32 Font::ourDefaultCharset[] =
 /// Default constructor
 ////////////////////////////////////////////////////////////
 Font::Font() :
-myCharSize(0)
+myCharSize   (0),
+myCurrentPage(0),
+myFace       (NULL),
+myUseCounter (0),
+myGeneration (0)
 {
+    myPages.push_back(Page());
+}
+
 
+////////////////////////////////////////////////////////////
+/// Copy constructor
+////////////////////////////////////////////////////////////
+Font::Font(const Font& Copy) :
+Resource<Font>(Copy),
+myCharSize    (Copy.myCharSize),
+myGlyphs      (Copy.myGlyphs),
+myPages       (Copy.myPages),
+myCurrentPage (Copy.myCurrentPage),
+myFace        (NULL),
+myFontData    (Copy.myFontData),
+myUseCounter  (Copy.myUseCounter),
+myGeneration  (0)
+{
+    // A font face can't be shared, open our own one
+    if (Copy.myFace)
+        myFace = priv::FontLoader::GetInstance().OpenFace(&myFontData[0], myFontData.size(), myCharSize);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destructor
+////////////////////////////////////////////////////////////
+Font::~Font()
+{
+    if (myFace)
+        priv::FontLoader::GetInstance().CloseFace(static_cast<FT_Face>(myFace));
 }
 
 
@@ -74,7 +120,7 @@ myCharSize(0)
 bool Font::LoadFromFile(const std::string& Filename, unsigned int CharSize, const Unicode::Text& Charset)
 {
     // Clear the previous character map
-    myGlyphs.clear();
+    Reset();
 
     // Always add these special characters
     Unicode::UTF32String UTFCharset = Charset;
@@ -93,7 +139,7 @@ bool Font::LoadFromFile(const std::string& Filename, unsigned int CharSize, cons
 bool Font::LoadFromMemory(const char* Data, std::size_t SizeInBytes, unsigned int CharSize, const Unicode::Text& Charset)
 {
     // Clear the previous character map
-    myGlyphs.clear();
+    Reset();
 
     // Check parameters
     if (!Data || (SizeInBytes == 0))
@@ -113,6 +159,66 @@ bool Font::LoadFromMemory(const char* Data, std::size_t SizeInBytes, unsigned in
 }
 
 
+////////////////////////////////////////////////////////////
+/// Load the font from a file, in dynamic mode
+////////////////////////////////////////////////////////////
+bool Font::LoadDynamicFromFile(const std::string& Filename, unsigned int CharSize)
+{
+    // Clear the previous font
+    Reset();
+
+    // Read the whole file, the font face will need it as long as it is open
+    std::ifstream File(Filename.c_str(), std::ios_base::binary);
+    if (!File)
+    {
+        std::cerr << "Failed to load font \"" << Filename << "\" (cannot open file)" << std::endl;
+        return false;
+    }
+    File.seekg(0, std::ios_base::end);
+    std::size_t Size = static_cast<std::size_t>(File.tellg());
+    File.seekg(0, std::ios_base::beg);
+    myFontData.resize(Size);
+    if (Size > 0)
+        File.read(&myFontData[0], static_cast<std::streamsize>(Size));
+
+    if (!OpenDynamic(CharSize))
+    {
+        std::cerr << "Failed to load font \"" << Filename << "\"" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Load the font from a file in memory, in dynamic mode
+////////////////////////////////////////////////////////////
+bool Font::LoadDynamicFromMemory(const char* Data, std::size_t SizeInBytes, unsigned int CharSize)
+{
+    // Clear the previous font
+    Reset();
+
+    // Check parameters
+    if (!Data || (SizeInBytes == 0))
+    {
+        std::cerr << "Failed to load font from memory, no data provided" << std::endl;
+        return false;
+    }
+
+    // Keep a copy of the data, the font face will need it as long as it is open
+    myFontData.assign(Data, Data + SizeInBytes);
+
+    if (!OpenDynamic(CharSize))
+    {
+        std::cerr << "Failed to load font from memory" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Get the base size of characters in the font;
 /// All glyphs dimensions are based on this value
@@ -129,11 +235,18 @@ unsigned int Font::GetCharacterSize() const
 ////////////////////////////////////////////////////////////
 const Glyph& Font::GetGlyph(Uint32 CodePoint) const
 {
-    std::map<Uint32, Glyph>::const_iterator It = myGlyphs.find(CodePoint);
-    if (It != myGlyphs.end())
+    const Glyph* Found = myGlyphs.Find(CodePoint);
+    if (Found)
+    {
+        // Valid glyph ; in dynamic mode, keep track of the use of its page
+        UsePage(Found->Page);
+
+        return *Found;
+    }
+    else if (myFace)
     {
-        // Valid glyph
-        return It->second;
+        // Dynamic mode : render the glyph the first time it is requested
+        return LoadGlyph(CodePoint);
     }
     else
     {
@@ -149,7 +262,56 @@ const Glyph& Font::GetGlyph(Uint32 CodePoint) const
 ////////////////////////////////////////////////////////////
 const Image& Font::GetImage() const
 {
-    return myTexture;
+    return myPages[0].Texture;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get one of the images containing the rendered characters
+////////////////////////////////////////////////////////////
+const Image& Font::GetImage(unsigned int Page) const
+{
+    return myPages[Page < myPages.size() ? Page : 0].Texture;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the ratio of the pages area actually covered by
+/// glyphs (without the padding between them)
+////////////////////////////////////////////////////////////
+float Font::GetFillRatio() const
+{
+    double UsedArea  = 0;
+    double TotalArea = 0;
+    for (std::deque<Page>::const_iterator i = myPages.begin(); i != myPages.end(); ++i)
+    {
+        UsedArea  += i->UsedArea;
+        TotalArea += static_cast<double>(i->Texture.GetWidth()) * i->Texture.GetHeight();
+    }
+
+    return TotalArea > 0 ? static_cast<float>(UsedArea / TotalArea) : 0.f;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Assignment operator
+////////////////////////////////////////////////////////////
+Font& Font::operator =(const Font& Other)
+{
+    Font Temp(Other);
+
+    std::swap(myCharSize,    Temp.myCharSize);
+    std::swap(myGlyphs,      Temp.myGlyphs);
+    std::swap(myCurrentPage, Temp.myCurrentPage);
+    std::swap(myFace,        Temp.myFace);
+    std::swap(myUseCounter,  Temp.myUseCounter);
+    myPages.swap(Temp.myPages);
+    myFontData.swap(Temp.myFontData);
+
+    // Strings using this font must update their geometry
+    myGeneration++;
+
+    return *this;
 }
 
 
@@ -189,4 +351,357 @@ const Font& Font::GetDefaultFont()
     return DefaultFont;
 }
 
+
+////////////////////////////////////////////////////////////
+/// Reset the font to its initial (empty) state
+////////////////////////////////////////////////////////////
+void Font::Reset()
+{
+    if (myFace)
+    {
+        priv::FontLoader::GetInstance().CloseFace(static_cast<FT_Face>(myFace));
+        myFace = NULL;
+    }
+
+    myFontData.clear();
+    myGlyphs.Clear();
+    myPages.clear();
+    myPages.push_back(Page());
+    myCurrentPage = 0;
+    myCharSize    = 0;
+    myUseCounter  = 0;
+
+    // Strings using this font must update their geometry
+    myGeneration++;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Open the font data in dynamic mode
+////////////////////////////////////////////////////////////
+bool Font::OpenDynamic(unsigned int CharSize)
+{
+    if (myFontData.empty())
+        return false;
+
+    // Make sure that any glyph fits in a page
+    if (CharSize > PageSize / 2)
+        CharSize = PageSize / 2;
+
+    myFace = priv::FontLoader::GetInstance().OpenFace(&myFontData[0], myFontData.size(), CharSize);
+    if (!myFace)
+    {
+        myFontData.clear();
+        return false;
+    }
+
+    myCharSize = CharSize;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Render a glyph into the pages, in dynamic mode
+////////////////////////////////////////////////////////////
+const Glyph& Font::LoadGlyph(Uint32 CodePoint) const
+{
+    Glyph              NewGlyph;
+    std::vector<Uint8> Pixels;
+    unsigned int       Width  = 0;
+    unsigned int       Height = 0;
+
+    // Characters that can't be rendered are stored as invalid glyphs, so that we don't try again
+    if (priv::FontLoader::RenderGlyph(static_cast<FT_Face>(myFace), CodePoint, NewGlyph, Pixels, Width, Height) == 0)
+    {
+        // Glyphs which don't fit in a page (with their padding) are kept empty,
+        // and empty glyphs (like spaces) don't need any room in the pages
+        if ((Width + 1 > PageSize) || (Height + 1 > PageSize))
+        {
+            std::cerr << "Failed to render character " << CodePoint << " : its glyph (" << Width << "x" << Height
+                      << ") is bigger than the font pages (" << PageSize << "x" << PageSize << ")" << std::endl;
+            NewGlyph.Rectangle = IntRect(0, 0, 0, 0);
+        }
+        else if ((Width > 0) && (Height > 0))
+        {
+            IntRect      Rect;
+            unsigned int Index   = AllocateGlyph(Width, Height, Rect);
+            Page&        Current = myPages[Index];
+
+            // Copy the glyph into the page
+            Current.Texture.UpdatePixels(&Pixels[0], Rect);
+
+            NewGlyph.TexCoords = Current.Texture.GetTexCoords(Rect);
+            NewGlyph.Page      = Index;
+            Current.CodePoints.push_back(CodePoint);
+            Current.LastUse   = ++myUseCounter;
+            Current.UsedArea += Width * Height;
+        }
+    }
+
+    Glyph& Inserted = myGlyphs[CodePoint];
+    Inserted = NewGlyph;
+
+    return Inserted;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Mark a page as used, in dynamic mode
+////////////////////////////////////////////////////////////
+void Font::UsePage(unsigned int Page) const
+{
+    if (myFace)
+        myPages[Page].LastUse = ++myUseCounter;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Find room for a glyph in the pages, in dynamic mode
+////////////////////////////////////////////////////////////
+unsigned int Font::AllocateGlyph(unsigned int Width, unsigned int Height, IntRect& Rect) const
+{
+    // Glyphs are separated by one pixel, so that they don't bleed on each other when smoothed
+    unsigned int PaddedWidth  = Width + 1;
+    unsigned int PaddedHeight = Height + 1;
+
+    // Start a new row if the current one is full
+    Page* Current = &myPages[myCurrentPage];
+    if (Current->ShelfLeft + PaddedWidth > PageSize)
+    {
+        Current->ShelfTop   += Current->ShelfHeight;
+        Current->ShelfLeft   = 0;
+        Current->ShelfHeight = 0;
+    }
+
+    // Switch to another page if the current one is full
+    if (Current->ShelfTop + PaddedHeight > PageSize)
+    {
+        if (myPages.size() < MaxPages)
+        {
+            // Add a new page
+            myPages.push_back(Page());
+            myCurrentPage = static_cast<unsigned int>(myPages.size() - 1);
+        }
+        else
+        {
+            // Recycle the least recently used page ; its glyphs will be rendered again when requested
+            myCurrentPage = 0;
+            for (unsigned int i = 1; i < myPages.size(); ++i)
+            {
+                if (myPages[i].LastUse < myPages[myCurrentPage].LastUse)
+                    myCurrentPage = i;
+            }
+
+            Page& Recycled = myPages[myCurrentPage];
+            for (std::vector<Uint32>::const_iterator i = Recycled.CodePoints.begin(); i != Recycled.CodePoints.end(); ++i)
+                myGlyphs.Remove(*i);
+            Recycled.CodePoints.clear();
+            Recycled.ShelfLeft   = 0;
+            Recycled.ShelfTop    = 0;
+            Recycled.ShelfHeight = 0;
+            Recycled.UsedArea    = 0;
+            Recycled.Texture.Create(PageSize, PageSize, Color(255, 255, 255, 0), PixelFormat::A8);
+
+            // Strings using this font must update their geometry
+            myGeneration++;
+        }
+
+        Current = &myPages[myCurrentPage];
+    }
+
+    // Create the image of the page the first time it is used
+    if (Current->Texture.GetWidth() == 0)
+        Current->Texture.Create(PageSize, PageSize, Color(255, 255, 255, 0), PixelFormat::A8);
+
+    Rect = IntRect(Current->ShelfLeft, Current->ShelfTop, Current->ShelfLeft + Width, Current->ShelfTop + Height);
+    Current->ShelfLeft  += PaddedWidth;
+    Current->ShelfHeight = std::max(Current->ShelfHeight, PaddedHeight);
+
+    return myCurrentPage;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Default constructor for Page
+////////////////////////////////////////////////////////////
+Font::Page::Page() :
+ShelfLeft  (0),
+ShelfTop   (0),
+ShelfHeight(0),
+UsedArea   (0),
+LastUse    (0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+/// Default constructor
+////////////////////////////////////////////////////////////
+Font::GlyphTable::GlyphTable() :
+myCount(0)
+{
+    for (unsigned int i = 0; i < NbDirect; ++i)
+        myDirectUsed[i] = false;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the glyph of a code point, inserting it if needed
+////////////////////////////////////////////////////////////
+Glyph& Font::GlyphTable::operator [](Uint32 CodePoint)
+{
+    if (CodePoint < NbDirect)
+    {
+        myDirectUsed[CodePoint] = true;
+        return myDirect[CodePoint];
+    }
+
+    // Keep the load factor under 1/2, so that probing sequences stay short
+    if ((myCount + 1) * 2 > myKeys.size())
+        Grow();
+
+    std::size_t Slot = FindSlot(CodePoint);
+    if (myKeys[Slot] != EmptyKey)
+        return myValues[Slot];
+
+    myKeys[Slot] = CodePoint;
+    myCount++;
+
+    return myValues[Slot];
+}
+
+
+////////////////////////////////////////////////////////////
+/// Find the glyph of a code point
+////////////////////////////////////////////////////////////
+const Glyph* Font::GlyphTable::Find(Uint32 CodePoint) const
+{
+    if (CodePoint < NbDirect)
+        return myDirectUsed[CodePoint] ? &myDirect[CodePoint] : NULL;
+
+    if (myCount == 0)
+        return NULL;
+
+    std::size_t Slot = FindSlot(CodePoint);
+    return myKeys[Slot] == CodePoint ? &myValues[Slot] : NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove a glyph
+////////////////////////////////////////////////////////////
+void Font::GlyphTable::Remove(Uint32 CodePoint)
+{
+    if (CodePoint < NbDirect)
+    {
+        myDirect[CodePoint]     = Glyph();
+        myDirectUsed[CodePoint] = false;
+        return;
+    }
+
+    if (myCount == 0)
+        return;
+
+    std::size_t Slot = FindSlot(CodePoint);
+    if (myKeys[Slot] != CodePoint)
+        return;
+
+    // Move back the next entries of the probing sequence, so that it is not broken by an empty slot
+    std::size_t Mask = myKeys.size() - 1;
+    std::size_t Next = Slot;
+    for (;;)
+    {
+        Next = (Next + 1) & Mask;
+        if (myKeys[Next] == EmptyKey)
+            break;
+
+        // The entry can fill the hole only if its home slot is not between the hole and itself
+        std::size_t Home = Hash(myKeys[Next]) & Mask;
+        bool Between = (Slot <= Next) ? ((Slot < Home) && (Home <= Next)) : ((Slot < Home) || (Home <= Next));
+        if (!Between)
+        {
+            myKeys[Slot]   = myKeys[Next];
+            myValues[Slot] = myValues[Next];
+            Slot = Next;
+        }
+    }
+
+    myKeys[Slot]   = EmptyKey;
+    myValues[Slot] = Glyph();
+    myCount--;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove all the glyphs
+////////////////////////////////////////////////////////////
+void Font::GlyphTable::Clear()
+{
+    for (unsigned int i = 0; i < NbDirect; ++i)
+    {
+        myDirect[i]     = Glyph();
+        myDirectUsed[i] = false;
+    }
+
+    myKeys.clear();
+    myValues.clear();
+    myCount = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the slot of a code point in the hash table
+////////////////////////////////////////////////////////////
+std::size_t Font::GlyphTable::FindSlot(Uint32 CodePoint) const
+{
+    // Linear probing ; the table size is a power of two
+    std::size_t Mask = myKeys.size() - 1;
+    std::size_t Slot = Hash(CodePoint) & Mask;
+    while ((myKeys[Slot] != CodePoint) && (myKeys[Slot] != EmptyKey))
+        Slot = (Slot + 1) & Mask;
+
+    return Slot;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Compute the hash of a code point
+////////////////////////////////////////////////////////////
+Uint32 Font::GlyphTable::Hash(Uint32 CodePoint)
+{
+    // Scramble the code point, as consecutive ones are very common
+    Uint32 Result = CodePoint * 2654435761u;
+    Result ^= Result >> 16;
+
+    return Result;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Double the capacity of the hash table
+void Font::GlyphTable::Grow()
+{
+    std::vector<Uint32> OldKeys;
+    std::vector<Glyph>  OldValues;
+    OldKeys.swap(myKeys);
+    OldValues.swap(myValues);
+
+    std::size_t Capacity = OldKeys.empty() ? 64 : OldKeys.size() * 2;
+    myKeys.resize(Capacity, EmptyKey);
+    myValues.resize(Capacity);
+
+    // Reinsert the existing glyphs
+    for (std::size_t i = 0; i < OldKeys.size(); ++i)
+    {
+        if (OldKeys[i] != EmptyKey)
+        {
+            std::size_t Slot = FindSlot(OldKeys[i]);
+            myKeys[Slot]   = OldKeys[i];
+            myValues[Slot] = OldValues[i];
+        }
+    }
+}
+
 } // namespace sf
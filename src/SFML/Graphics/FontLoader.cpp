@@ -30,9 +30,12 @@
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/SkylinePacker.hpp>
+#include <SFML/System/Thread.hpp>
 #include FT_GLYPH_H
+#include <algorithm>
+#include <fstream>
 #include <iostream>
-#include <map>
 #include <vector>
 #include <math.h>
 
@@ -40,14 +43,97 @@
 namespace
 {
     ////////////////////////////////////////////////////////////
-    // Functor to sort glyphs by size
+    // Maximum number of threads rasterizing the glyphs of a font,
+    // and minimum number of glyphs to give to each of them
+    ////////////////////////////////////////////////////////////
+    const std::size_t MaxWorkers         = 4;
+    const std::size_t MinGlyphsPerWorker = 64;
+
+    ////////////////////////////////////////////////////////////
+    // Glyph rendered by a worker, waiting to be packed
+    ////////////////////////////////////////////////////////////
+    struct RenderedGlyph
+    {
+        sf::Glyph              Metrics; ///< Position, size and advance of the glyph
+        unsigned int           Width;   ///< Width of the bitmap
+        unsigned int           Height;  ///< Height of the bitmap
+        std::vector<sf::Uint8> Pixels;  ///< Alpha values of the bitmap
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Range of characters to be rendered by a worker
+    ////////////////////////////////////////////////////////////
+    struct RasterJob
+    {
+        const char*                     Data;        ///< Font file in memory
+        std::size_t                     SizeInBytes; ///< Size of the font file
+        unsigned int                    CharSize;    ///< Size of the characters
+        const sf::Unicode::UTF32String* Charset;     ///< Characters set to render
+        std::vector<RenderedGlyph>*     Results;     ///< Rendered glyphs, with the same indices as the characters set
+        std::size_t                     Begin;       ///< First character to render
+        std::size_t                     End;         ///< One past the last character to render
+        FT_Error                        Error;       ///< Error code of the job
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Render the characters of a job with the given face
+    ////////////////////////////////////////////////////////////
+    void RenderGlyphs(FT_Face FontFace, RasterJob& Job)
+    {
+        for (std::size_t i = Job.Begin; (i < Job.End) && !Job.Error; ++i)
+        {
+            RenderedGlyph& Result = (*Job.Results)[i];
+            Job.Error = sf::priv::FontLoader::RenderGlyph(FontFace, (*Job.Charset)[i], Result.Metrics, Result.Pixels, Result.Width, Result.Height);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Entry point of the worker threads
+    ////////////////////////////////////////////////////////////
+    void RenderGlyphsThread(void* UserData)
+    {
+        RasterJob& Job = *static_cast<RasterJob*>(UserData);
+
+        // FreeType objects must not be shared between threads : each worker has its own library and face
+        FT_Library Library;
+        Job.Error = FT_Init_FreeType(&Library);
+        if (Job.Error)
+            return;
+
+        FT_Face FontFace;
+        Job.Error = FT_New_Memory_Face(Library, reinterpret_cast<const FT_Byte*>(Job.Data), static_cast<FT_Long>(Job.SizeInBytes), 0, &FontFace);
+        if (!Job.Error)
+        {
+            Job.Error = FT_Set_Pixel_Sizes(FontFace, Job.CharSize, Job.CharSize);
+            if (!Job.Error)
+                Job.Error = FT_Select_Charmap(FontFace, FT_ENCODING_UNICODE);
+            if (!Job.Error)
+                RenderGlyphs(FontFace, Job);
+
+            FT_Done_Face(FontFace);
+        }
+
+        FT_Done_FreeType(Library);
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Functor to sort glyphs by decreasing size
     ////////////////////////////////////////////////////////////
     struct SizeCompare
     {
-        bool operator ()(FT_BitmapGlyph Glyph1, FT_BitmapGlyph Glyph2) const
+        SizeCompare(const std::vector<RenderedGlyph>& Glyphs) : myGlyphs(&Glyphs) {}
+
+        bool operator ()(std::size_t Index1, std::size_t Index2) const
         {
-            return Glyph2->bitmap.rows < Glyph1->bitmap.rows;
+            const RenderedGlyph& Glyph1 = (*myGlyphs)[Index1];
+            const RenderedGlyph& Glyph2 = (*myGlyphs)[Index2];
+            if (Glyph1.Height != Glyph2.Height)
+                return Glyph2.Height < Glyph1.Height;
+            else
+                return Glyph2.Width < Glyph1.Width;
         }
+
+        const std::vector<RenderedGlyph>* myGlyphs;
     };
 }
 
@@ -104,9 +190,27 @@ bool FontLoader::LoadFontFromFile(const std::string& Filename, unsigned int Char
         return false;
     }
 
-    // Create a new font face from the specified file
+    // Read the whole file, the rasterization workers will open their own face from it
+    std::ifstream File(Filename.c_str(), std::ios_base::binary);
+    if (!File)
+    {
+        std::cerr << "Failed to load font \"" << Filename << "\" (cannot open file)" << std::endl;
+        return false;
+    }
+    File.seekg(0, std::ios_base::end);
+    std::size_t Size = static_cast<std::size_t>(File.tellg());
+    File.seekg(0, std::ios_base::beg);
+    if (Size == 0)
+    {
+        std::cerr << "Failed to load font \"" << Filename << "\" (empty file)" << std::endl;
+        return false;
+    }
+    std::vector<char> Data(Size);
+    File.read(&Data[0], static_cast<std::streamsize>(Size));
+
+    // Create a new font face from the file data
     FT_Face FontFace;
-    FT_Error Error = FT_New_Face(myLibrary, Filename.c_str(), 0, &FontFace);
+    FT_Error Error = FT_New_Memory_Face(myLibrary, reinterpret_cast<const FT_Byte*>(&Data[0]), static_cast<FT_Long>(Size), 0, &FontFace);
     if (Error)
     {
         std::cerr << "Failed to load font \"" << Filename << "\" (" << GetErrorDesc(Error) << ")" << std::endl;
@@ -114,7 +218,7 @@ bool FontLoader::LoadFontFromFile(const std::string& Filename, unsigned int Char
     }
 
     // Create the bitmap font
-    Error = CreateBitmapFont(FontFace, CharSize, Charset, LoadedFont);
+    Error = CreateBitmapFont(FontFace, &Data[0], Size, CharSize, Charset, LoadedFont);
     if (Error)
         std::cerr << "Failed to load font \"" << Filename << "\" (" << GetErrorDesc(Error) << ")" << std::endl;
 
@@ -147,7 +251,7 @@ bool FontLoader::LoadFontFromMemory(const char* Data, std::size_t SizeInBytes, u
     }
 
     // Create the bitmap font
-    Error = CreateBitmapFont(FontFace, CharSize, Charset, LoadedFont);
+    Error = CreateBitmapFont(FontFace, Data, SizeInBytes, CharSize, Charset, LoadedFont);
     if (Error)
         std::cerr << "Failed to load font from memory (" << GetErrorDesc(Error) << ")" << std::endl;
 
@@ -158,10 +262,105 @@ bool FontLoader::LoadFontFromMemory(const char* Data, std::size_t SizeInBytes, u
 }
 
 
+////////////////////////////////////////////////////////////
+/// Open a font face from a file in memory, to render its
+/// glyphs on demand
+////////////////////////////////////////////////////////////
+FT_Face FontLoader::OpenFace(const char* Data, std::size_t SizeInBytes, unsigned int CharSize)
+{
+    // Check if Freetype is correctly initialized
+    if (!myLibrary)
+    {
+        std::cerr << "Failed to open font face, FreeType has not been initialized" << std::endl;
+        return NULL;
+    }
+
+    // Create a new font face from the specified memory data
+    FT_Face FontFace;
+    FT_Error Error = FT_New_Memory_Face(myLibrary, reinterpret_cast<const FT_Byte*>(Data), static_cast<FT_Long>(SizeInBytes), 0, &FontFace);
+    if (Error)
+    {
+        std::cerr << "Failed to open font face (" << GetErrorDesc(Error) << ")" << std::endl;
+        return NULL;
+    }
+
+    // Setup the font size
+    Error = FT_Set_Pixel_Sizes(FontFace, CharSize, CharSize);
+
+    // Select the unicode character map
+    if (!Error)
+        Error = FT_Select_Charmap(FontFace, FT_ENCODING_UNICODE);
+
+    if (Error)
+    {
+        std::cerr << "Failed to open font face (" << GetErrorDesc(Error) << ")" << std::endl;
+        FT_Done_Face(FontFace);
+        return NULL;
+    }
+
+    return FontFace;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Close a font face opened with OpenFace
+////////////////////////////////////////////////////////////
+void FontLoader::CloseFace(FT_Face FontFace)
+{
+    if (FontFace)
+        FT_Done_Face(FontFace);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Render a single glyph of a font face
+////////////////////////////////////////////////////////////
+FT_Error FontLoader::RenderGlyph(FT_Face FontFace, Uint32 CodePoint, Glyph& Result, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height)
+{
+    // Load the glyph corresponding to the character
+    FT_Error Error = FT_Load_Char(FontFace, CodePoint, FT_LOAD_TARGET_NORMAL);
+    if (Error)
+        return Error;
+
+    // Convert the glyph to a bitmap (ie. rasterize it)
+    FT_Glyph Glyph;
+    Error = FT_Get_Glyph(FontFace->glyph, &Glyph);
+    if (Error)
+        return Error;
+    FT_Glyph_To_Bitmap(&Glyph, FT_RENDER_MODE_NORMAL, 0, 1);
+    FT_BitmapGlyph BitmapGlyph = (FT_BitmapGlyph)Glyph;
+    FT_Bitmap&     Bitmap      = BitmapGlyph->bitmap;
+
+    // Store the character's position and size
+    Result.Rectangle.Left   = BitmapGlyph->left;
+    Result.Rectangle.Top    = -BitmapGlyph->top;
+    Result.Rectangle.Right  = Result.Rectangle.Left + Bitmap.width;
+    Result.Rectangle.Bottom = Bitmap.rows - BitmapGlyph->top;
+    Result.Advance          = BitmapGlyph->root.advance.x >> 16;
+
+    // Copy the pixels of the glyph
+    Width  = Bitmap.width;
+    Height = Bitmap.rows;
+    Pixels.resize(Width * Height);
+    const Uint8* Src = Bitmap.buffer;
+    for (unsigned int y = 0; y < Height; ++y)
+    {
+        for (unsigned int x = 0; x < Width; ++x)
+            Pixels[x + y * Width] = Src[x];
+        Src += Bitmap.pitch;
+    }
+
+    // Delete the glyph
+    FT_Done_Glyph(Glyph);
+
+    return 0;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Create a bitmap font from a font face and a characters set
 ////////////////////////////////////////////////////////////
-FT_Error FontLoader::CreateBitmapFont(FT_Face FontFace, unsigned int CharSize, const Unicode::UTF32String& Charset, Font& LoadedFont)
+FT_Error FontLoader::CreateBitmapFont(FT_Face FontFace, const char* Data, std::size_t SizeInBytes, unsigned int CharSize, const Unicode::UTF32String& Charset, Font& LoadedFont)
 {
     // Make sure we have a valid context
     priv::GraphicsContext Ctx;
@@ -169,22 +368,12 @@ FT_Error FontLoader::CreateBitmapFont(FT_Face FontFace, unsigned int CharSize, c
     // Let's find how many characters to put in each row to make them fit into a squared texture
     GLint MaxSize;
     GLCheck(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &MaxSize));
-    int NbChars = static_cast<int>(sqrt(static_cast<double>(Charset.length())) * 0.75);
+    int NbChars = std::max(static_cast<int>(sqrt(static_cast<double>(Charset.length())) * 0.75), 1);
 
     // Clamp the character size to make sure we won't create a texture too big
     if (NbChars * CharSize >= static_cast<unsigned int>(MaxSize))
         CharSize = MaxSize / NbChars;
 
-    // Initialize the dimensions
-    unsigned int Left      = 0;
-    unsigned int Top       = 0;
-    unsigned int TexWidth  = Image::GetValidTextureSize(CharSize * NbChars);
-    unsigned int TexHeight = CharSize * NbChars;
-    std::vector<unsigned int> Tops(TexWidth, 0);
-
-    // Create a pixel buffer for rendering every glyph
-    std::vector<Uint8> GlyphsBuffer(TexWidth * TexHeight * 4);
-
     // Setup the font size
     FT_Error Error = FT_Set_Pixel_Sizes(FontFace, CharSize, CharSize);
     if (Error)
@@ -195,101 +384,99 @@ FT_Error FontLoader::CreateBitmapFont(FT_Face FontFace, unsigned int CharSize, c
     if (Error)
         return Error;
 
-    // Render all glyphs and sort them by size to optimize texture space
-    typedef std::multimap<FT_BitmapGlyph, Uint32, SizeCompare> GlyphTable;
-    GlyphTable Glyphs;
-    for (std::size_t i = 0; i < Charset.length(); ++i)
+    // Split the characters set between the workers ; the first range is rendered by
+    // this thread with the main face, the other ones by threads having their own face
+    std::size_t NbGlyphs  = Charset.length();
+    std::size_t NbWorkers = std::max(std::min(MaxWorkers, NbGlyphs / MinGlyphsPerWorker), static_cast<std::size_t>(1));
+    std::vector<RenderedGlyph> Glyphs(NbGlyphs);
+    std::vector<RasterJob>     Jobs(NbWorkers);
+    for (std::size_t i = 0; i < NbWorkers; ++i)
     {
-        // Load the glyph corresponding to the current character
-        Error = FT_Load_Char(FontFace, Charset[i], FT_LOAD_TARGET_NORMAL);
-        if (Error)
-            return Error;
-
-        // Convert the glyph to a bitmap (ie. rasterize it)
-        FT_Glyph Glyph;
-        Error = FT_Get_Glyph(FontFace->glyph, &Glyph);
-        if (Error)
-            return Error;
-        FT_Glyph_To_Bitmap(&Glyph, FT_RENDER_MODE_NORMAL, 0, 1);
-        FT_BitmapGlyph BitmapGlyph = (FT_BitmapGlyph)Glyph;
-
-        // Add it to the sorted table of glyphs
-        Glyphs.insert(std::make_pair(BitmapGlyph, Charset[i]));
+        Jobs[i].Data        = Data;
+        Jobs[i].SizeInBytes = SizeInBytes;
+        Jobs[i].CharSize    = CharSize;
+        Jobs[i].Charset     = &Charset;
+        Jobs[i].Results     = &Glyphs;
+        Jobs[i].Begin       = NbGlyphs * i / NbWorkers;
+        Jobs[i].End         = NbGlyphs * (i + 1) / NbWorkers;
+        Jobs[i].Error       = 0;
     }
 
-    // Copy the rendered glyphs into the texture
-    unsigned int MaxHeight = 0;
-    std::map<Uint32, IntRect> Coords;
-    for (GlyphTable::const_iterator i = Glyphs.begin(); i != Glyphs.end(); ++i)
+    // Render all the glyphs
+    std::vector<Thread*> Workers;
+    for (std::size_t i = 1; i < NbWorkers; ++i)
     {
-        // Get the bitmap of the current glyph
-        Glyph&         CurGlyph    = LoadedFont.myGlyphs[i->second];
-        FT_BitmapGlyph BitmapGlyph = i->first;
-        FT_Bitmap&     Bitmap      = BitmapGlyph->bitmap;
-
-        // Make sure we don't go over the texture width
-        if (Left + Bitmap.width + 1 >= TexWidth)
-            Left = 0;
-
-        // Compute the top coordinate
-        Top = Tops[Left];
-        for (int x = 0; x < Bitmap.width + 1; ++x)
-            Top = std::max(Top, Tops[Left + x]);
-        Top++;
-
-        // Make sure we don't go over the texture height -- resize it if we need more space
-        if (Top + Bitmap.rows + 1 >= TexHeight)
-        {
-            TexHeight *= 2;
-            GlyphsBuffer.resize(TexWidth * TexHeight * 4);
-        }
+        Workers.push_back(new Thread(&RenderGlyphsThread, &Jobs[i]));
+        Workers.back()->Launch();
+    }
+    RenderGlyphs(FontFace, Jobs[0]);
+    for (std::vector<Thread*>::iterator i = Workers.begin(); i != Workers.end(); ++i)
+    {
+        (*i)->Wait();
+        delete *i;
+    }
+    for (std::size_t i = 0; i < NbWorkers; ++i)
+    {
+        if (Jobs[i].Error)
+            return Jobs[i].Error;
+    }
 
-        // Store the character's position and size
-        CurGlyph.Rectangle.Left   = BitmapGlyph->left;
-        CurGlyph.Rectangle.Top    = -BitmapGlyph->top;
-        CurGlyph.Rectangle.Right  = CurGlyph.Rectangle.Left + Bitmap.width;
-        CurGlyph.Rectangle.Bottom = Bitmap.rows - BitmapGlyph->top;
-        CurGlyph.Advance          = BitmapGlyph->root.advance.x >> 16;
+    // Sort the glyphs by decreasing size, which gives the tightest results when packing them
+    std::vector<std::size_t> Order(NbGlyphs);
+    unsigned int MaxWidth = 0;
+    for (std::size_t i = 0; i < NbGlyphs; ++i)
+    {
+        Order[i] = i;
+        MaxWidth = std::max(MaxWidth, Glyphs[i].Width);
+    }
+    std::sort(Order.begin(), Order.end(), SizeCompare(Glyphs));
+
+    // Pack the glyphs into the texture ; they are separated by one pixel,
+    // so that they don't bleed on each other when smoothed (the texture
+    // has an extra row at the bottom, which must fit in the maximum size too)
+    unsigned int TexWidth = Image::GetValidTextureSize(std::max(CharSize * NbChars, MaxWidth + 1));
+    SkylinePacker Packer(TexWidth, MaxSize - 1);
+    std::vector<IntRect> Coords(NbGlyphs);
+    unsigned long GlyphsArea = 0;
+    for (std::size_t i = 0; i < NbGlyphs; ++i)
+    {
+        const RenderedGlyph& CurGlyph = Glyphs[Order[i]];
+        if ((CurGlyph.Width == 0) || (CurGlyph.Height == 0))
+            continue;
+
+        unsigned int Left, Top;
+        if (!Packer.Insert(CurGlyph.Width + 1, CurGlyph.Height + 1, Left, Top))
+            return FT_Err_Out_Of_Memory;
 
-        // Texture size may change, so let the texture coordinates be calculated later
-        Coords[i->second] = IntRect(Left + 1, Top + 1, Left + Bitmap.width + 1, Top + Bitmap.rows + 1);
+        Coords[Order[i]] = IntRect(Left + 1, Top + 1, Left + CurGlyph.Width + 1, Top + CurGlyph.Height + 1);
+        GlyphsArea += CurGlyph.Width * CurGlyph.Height;
+    }
 
-        // Draw the glyph into our bitmap font
-        const Uint8* Pixels = Bitmap.buffer;
-        for (int y = 0; y < Bitmap.rows; ++y)
+    // Draw the glyphs into our bitmap font (only the alpha component is stored)
+    unsigned int TexHeight = Packer.GetUsedHeight() + 1;
+    std::vector<Uint8> GlyphsBuffer(TexWidth * TexHeight, 0);
+    for (std::size_t i = 0; i < NbGlyphs; ++i)
+    {
+        const RenderedGlyph& CurGlyph = Glyphs[i];
+        for (unsigned int y = 0; y < CurGlyph.Height; ++y)
         {
-            for (int x = 0; x < Bitmap.width; ++x)
-            {
-                std::size_t Index = x + Left + 1 + (y + Top + 1) * TexWidth;
-                GlyphsBuffer[Index * 4 + 0] = 255;
-                GlyphsBuffer[Index * 4 + 1] = 255;
-                GlyphsBuffer[Index * 4 + 2] = 255;
-                GlyphsBuffer[Index * 4 + 3] = Pixels[x];
-            }
-            Pixels += Bitmap.pitch;
+            const Uint8* Src = &CurGlyph.Pixels[y * CurGlyph.Width];
+            std::copy(Src, Src + CurGlyph.Width, &GlyphsBuffer[Coords[i].Left + (Coords[i].Top + y) * TexWidth]);
         }
-
-        // Update the rendering coordinates
-        for (int x = 0; x < Bitmap.width + 1; ++x)
-            Tops[Left + x] = Top + Bitmap.rows;
-        Left += Bitmap.width + 1;
-        if (Top + Bitmap.rows > MaxHeight)
-            MaxHeight = Top + Bitmap.rows;
-
-        // Delete the glyph
-        FT_Done_Glyph((FT_Glyph)BitmapGlyph);
     }
 
     // Create the font's texture
-    TexHeight = MaxHeight + 1;
-    GlyphsBuffer.resize(TexWidth * TexHeight * 4);
-    LoadedFont.myTexture.LoadFromPixels(TexWidth, TexHeight, &GlyphsBuffer[0]);
+    Font::Page& FontPage = LoadedFont.myPages[0];
+    if (!FontPage.Texture.LoadFromPixels(TexWidth, TexHeight, &GlyphsBuffer[0], PixelFormat::A8))
+        return FT_Err_Out_Of_Memory;
+    FontPage.UsedArea = GlyphsArea;
 
-    // Now that the texture is created, we can precompute texture coordinates
-    for (std::size_t i = 0; i < Charset.size(); ++i)
+    // Now that the texture is created, we can store the glyphs and compute their texture coordinates
+    for (std::size_t i = 0; i < NbGlyphs; ++i)
     {
-        Uint32 CurChar = Charset[i];
-        LoadedFont.myGlyphs[CurChar].TexCoords = LoadedFont.myTexture.GetTexCoords(Coords[CurChar]);
+        Glyph& CurGlyph = LoadedFont.myGlyphs[Charset[i]];
+        CurGlyph = Glyphs[i].Metrics;
+        CurGlyph.TexCoords = FontPage.Texture.GetTexCoords(Coords[i]);
     }
 
     // Update the character size (it may have been changed by the function)
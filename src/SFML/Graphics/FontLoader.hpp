@@ -33,11 +33,13 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <string>
+#include <vector>
 
 
 namespace sf
 {
 class Font;
+class Glyph;
 
 namespace priv
 {
@@ -83,6 +85,44 @@ public :
     ////////////////////////////////////////////////////////////
     bool LoadFontFromMemory(const char* Data, std::size_t SizeInBytes, unsigned int CharSize, const Unicode::UTF32String& Charset, Font& LoadedFont);
 
+    ////////////////////////////////////////////////////////////
+    /// Open a font face from a file in memory, to render its
+    /// glyphs on demand
+    ///
+    /// \param Data :        Pointer to the data to load (must stay valid until the face is closed)
+    /// \param SizeInBytes : Size of the data, in bytes
+    /// \param CharSize :    Size of characters in bitmap
+    ///
+    /// \return Font face, or NULL if loading failed
+    ///
+    ////////////////////////////////////////////////////////////
+    FT_Face OpenFace(const char* Data, std::size_t SizeInBytes, unsigned int CharSize);
+
+    ////////////////////////////////////////////////////////////
+    /// Close a font face opened with OpenFace
+    ///
+    /// \param FontFace : Font face to close
+    ///
+    ////////////////////////////////////////////////////////////
+    void CloseFace(FT_Face FontFace);
+
+    ////////////////////////////////////////////////////////////
+    /// Render a single glyph of a font face ; this function can
+    /// be called from any thread, as long as the face is not
+    /// shared with another thread
+    ///
+    /// \param FontFace :  Font face to use
+    /// \param CodePoint : Unicode value of the character to render
+    /// \param Result :    Glyph to fill up (texture coordinates are left untouched)
+    /// \param Pixels :    Receives the alpha values of the rendered glyph
+    /// \param Width :     Receives the width of the rendered glyph
+    /// \param Height :    Receives the height of the rendered glyph
+    ///
+    /// \return FreeType error code (0 if the glyph was successfully rendered)
+    ///
+    ////////////////////////////////////////////////////////////
+    static FT_Error RenderGlyph(FT_Face FontFace, Uint32 CodePoint, Glyph& Result, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height);
+
 private :
 
     ////////////////////////////////////////////////////////////
@@ -98,15 +138,19 @@ private :
     ~FontLoader();
 
     ////////////////////////////////////////////////////////////
-    /// Create a bitmap font from a font face and a characters set
+    /// Create a bitmap font from a font face and a characters set ;
+    /// large characters sets are rendered by several threads, each
+    /// one opening its own face from the font data
     ///
-    /// \param FontFace :   Font face containing the loaded font
-    /// \param CharSize :   Size of characters in bitmap
-    /// \param Charset :    Characters set to generate
-    /// \param LoadedFont : Font object to fill up
+    /// \param FontFace :    Font face containing the loaded font
+    /// \param Data :        Font file in memory, used to open the face
+    /// \param SizeInBytes : Size of the font file, in bytes
+    /// \param CharSize :    Size of characters in bitmap
+    /// \param Charset :     Characters set to generate
+    /// \param LoadedFont :  Font object to fill up
     ///
     ////////////////////////////////////////////////////////////
-    FT_Error CreateBitmapFont(FT_Face FontFace, unsigned int CharSize, const Unicode::UTF32String& Charset, Font& LoadedFont);
+    FT_Error CreateBitmapFont(FT_Face FontFace, const char* Data, std::size_t SizeInBytes, unsigned int CharSize, const Unicode::UTF32String& Charset, Font& LoadedFont);
 
     ////////////////////////////////////////////////////////////
     /// Get a description from a FT error code
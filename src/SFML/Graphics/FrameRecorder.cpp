@@ -0,0 +1,555 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/FrameRecorder.hpp>
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/ImageLoader.hpp>
+#include <SFML/System/Lock.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Check if pixel buffer objects are supported ; if not,
+    // frames are read synchronously
+    ////////////////////////////////////////////////////////////
+    bool CanUsePixelBuffers()
+    {
+        static bool Available = (GLEW_ARB_pixel_buffer_object != 0);
+        return Available;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Copy pixels read by OpenGL (bottom to top) into a frame
+    // (top to bottom)
+    ////////////////////////////////////////////////////////////
+    void CopyFlipped(sf::Uint8* Dst, const sf::Uint8* Src, unsigned int Width, unsigned int Height)
+    {
+        const unsigned int Pitch = Width * 4;
+        for (unsigned int y = 0; y < Height; ++y)
+            memcpy(Dst + y * Pitch, Src + (Height - y - 1) * Pitch, Pitch);
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Convert RGBA pixels to the 3 planes of a YUV 4:2:0 image
+    // (BT.601, video range), chroma being averaged on 2x2 blocks
+    ////////////////////////////////////////////////////////////
+    void ConvertToYUV420(const sf::Uint8* Pixels, unsigned int Width, unsigned int Height, std::vector<sf::Uint8>& Planes)
+    {
+        const unsigned int ChromaWidth  = (Width  + 1) / 2;
+        const unsigned int ChromaHeight = (Height + 1) / 2;
+        Planes.resize(Width * Height + 2 * ChromaWidth * ChromaHeight);
+
+        sf::Uint8* Y = &Planes[0];
+        sf::Uint8* U = Y + Width * Height;
+        sf::Uint8* V = U + ChromaWidth * ChromaHeight;
+
+        for (unsigned int i = 0; i < Width * Height; ++i, Pixels += 4)
+            Y[i] = static_cast<sf::Uint8>(((66 * Pixels[0] + 129 * Pixels[1] + 25 * Pixels[2] + 128) >> 8) + 16);
+
+        Pixels -= Width * Height * 4;
+        for (unsigned int y = 0; y < ChromaHeight; ++y)
+        {
+            const sf::Uint8* Row0 = Pixels + (y * 2) * Width * 4;
+            const sf::Uint8* Row1 = Pixels + std::min(y * 2 + 1, Height - 1) * Width * 4;
+            for (unsigned int x = 0; x < ChromaWidth; ++x)
+            {
+                unsigned int X0 = x * 8;
+                unsigned int X1 = std::min(x * 2 + 1, Width - 1) * 4;
+                int R = (Row0[X0 + 0] + Row0[X1 + 0] + Row1[X0 + 0] + Row1[X1 + 0] + 2) / 4;
+                int G = (Row0[X0 + 1] + Row0[X1 + 1] + Row1[X0 + 1] + Row1[X1 + 1] + 2) / 4;
+                int B = (Row0[X0 + 2] + Row0[X1 + 2] + Row1[X0 + 2] + Row1[X1 + 2] + 2) / 4;
+                *U++ = static_cast<sf::Uint8>(((-38 * R -  74 * G + 112 * B + 128) >> 8) + 128);
+                *V++ = static_cast<sf::Uint8>(((112 * R -  94 * G -  18 * B + 128) >> 8) + 128);
+            }
+        }
+    }
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// Default constructor
+////////////////////////////////////////////////////////////
+FrameRecorder::FrameRecorder() :
+myWindow     (NULL),
+myWidth      (0),
+myHeight     (0),
+myNextBuffer (0),
+myNbInFlight (0),
+myFormat     (RecordFormat::RawRGBA),
+myFile       (NULL),
+myCallback   (NULL),
+myUserData   (NULL),
+myNbWritten  (0),
+myNbDropped  (0),
+myWriteFailed(false),
+myWriter     (&FrameRecorder::RunWriter, this),
+myIsWriting  (false)
+{
+    for (int i = 0; i < NbBuffers; ++i)
+        myBuffers[i] = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destructor
+////////////////////////////////////////////////////////////
+FrameRecorder::~FrameRecorder()
+{
+    Stop();
+
+    for (std::vector<Frame*>::iterator i = myFreeFrames.begin(); i != myFreeFrames.end(); ++i)
+        delete *i;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Start recording a window into a file
+////////////////////////////////////////////////////////////
+bool FrameRecorder::Start(RenderWindow& Window, const std::string& Filename, RecordFormat::Format Format, unsigned int FrameRate)
+{
+    Stop();
+
+    myFormat   = Format;
+    myFilename = Filename;
+    myCallback = NULL;
+    myUserData = NULL;
+
+    // Single-file formats are opened now, so that errors are reported immediately
+    if (Format != RecordFormat::PngSequence)
+    {
+        myFile = fopen(Filename.c_str(), "wb");
+        if (!myFile)
+        {
+            std::cerr << "Failed to start recording, cannot open file \"" << Filename << "\"" << std::endl;
+            return false;
+        }
+
+        if (Format == RecordFormat::Y4M)
+            fprintf(myFile, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg\n", Window.GetWidth(), Window.GetHeight(), FrameRate ? FrameRate : 60);
+    }
+
+    return Begin(Window);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Start recording a window, passing the frames to a callback
+////////////////////////////////////////////////////////////
+bool FrameRecorder::Start(RenderWindow& Window, FrameCallback Callback, void* UserData)
+{
+    Stop();
+
+    if (!Callback)
+    {
+        std::cerr << "Failed to start recording, no callback given" << std::endl;
+        return false;
+    }
+
+    myFilename = "";
+    myCallback = Callback;
+    myUserData = UserData;
+
+    return Begin(Window);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Capture the current contents of the window
+////////////////////////////////////////////////////////////
+void FrameRecorder::Capture()
+{
+    if (!myWindow)
+        return;
+
+    // Execute the draw calls recorded since BeginFrame, if any
+    myWindow->Flush();
+    if (!myWindow->SetActive())
+        return;
+
+    // Make sure we have a valid context
+    priv::GraphicsContext Ctx;
+
+    // Handle a resized window
+    if ((myWindow->GetWidth() != myWidth) || (myWindow->GetHeight() != myHeight))
+    {
+        FlushBuffers();
+
+        // Single-file formats can't change their frame size
+        if (myFile)
+        {
+            std::cerr << "Recording stopped, the size of the window changed" << std::endl;
+            Stop();
+            return;
+        }
+
+        DestroyBuffers();
+        myWidth  = myWindow->GetWidth();
+        myHeight = myWindow->GetHeight();
+        CreateBuffers();
+    }
+
+    if (myBuffers[0])
+    {
+        // Start an asynchronous read of the frame into the next buffer
+        GLCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, myBuffers[myNextBuffer]));
+        GLCheck(glReadPixels(0, 0, myWidth, myHeight, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+        GLCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0));
+
+        myNextBuffer = (myNextBuffer + 1) % NbBuffers;
+        ++myNbInFlight;
+
+        // Once all the buffers are used, fetch the oldest frame : it has been
+        // read two frames ago, so the transfer should be finished by now
+        if (myNbInFlight == NbBuffers)
+            FetchOldestFrame();
+    }
+    else
+    {
+        // No pixel buffer objects : read the frame synchronously
+        Frame* NewFrame = AcquireFrame();
+        if (NewFrame)
+        {
+            Uint8* Pixels = &NewFrame->Pixels[0];
+            GLCheck(glReadPixels(0, 0, myWidth, myHeight, GL_RGBA, GL_UNSIGNED_BYTE, Pixels));
+
+            // Flip the pixels
+            unsigned int Pitch = myWidth * 4;
+            for (unsigned int y = 0; y < myHeight / 2; ++y)
+                std::swap_ranges(Pixels + y * Pitch, Pixels + (y + 1) * Pitch, Pixels + (myHeight - y - 1) * Pitch);
+
+            QueueFrame(NewFrame);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Stop recording
+////////////////////////////////////////////////////////////
+void FrameRecorder::Stop()
+{
+    if (!myWindow)
+        return;
+
+    // Fetch the last frames and release the buffers
+    if (myWindow->SetActive())
+    {
+        priv::GraphicsContext Ctx;
+        FlushBuffers();
+        DestroyBuffers();
+    }
+
+    // Wait until the writer thread has written all the frames
+    myWriter.Wait();
+
+    if (myFile)
+    {
+        fclose(myFile);
+        myFile = NULL;
+    }
+
+    myWindow = NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Tell whether a recording is in progress
+////////////////////////////////////////////////////////////
+bool FrameRecorder::IsRecording() const
+{
+    return myWindow != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the number of frames dropped since the recording
+/// started
+////////////////////////////////////////////////////////////
+unsigned int FrameRecorder::GetDroppedFrames() const
+{
+    return myNbDropped;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Start recording a window, once the destination of the
+/// frames is set
+////////////////////////////////////////////////////////////
+bool FrameRecorder::Begin(RenderWindow& Window)
+{
+    if (!Window.SetActive())
+    {
+        std::cerr << "Failed to start recording, cannot activate the window" << std::endl;
+        if (myFile)
+        {
+            fclose(myFile);
+            myFile = NULL;
+        }
+        return false;
+    }
+
+    priv::GraphicsContext Ctx;
+
+    myWindow      = &Window;
+    myWidth       = Window.GetWidth();
+    myHeight      = Window.GetHeight();
+    myNextBuffer  = 0;
+    myNbInFlight  = 0;
+    myNbWritten   = 0;
+    myNbDropped   = 0;
+    myWriteFailed = false;
+    CreateBuffers();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Create the pixel buffer objects for the current size,
+/// if supported
+////////////////////////////////////////////////////////////
+void FrameRecorder::CreateBuffers()
+{
+    if (!CanUsePixelBuffers() || !myWidth || !myHeight)
+        return;
+
+    for (int i = 0; i < NbBuffers; ++i)
+    {
+        GLuint Buffer = 0;
+        GLCheck(glGenBuffersARB(1, &Buffer));
+        GLCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, Buffer));
+        GLCheck(glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, myWidth * myHeight * 4, NULL, GL_STREAM_READ_ARB));
+        myBuffers[i] = static_cast<unsigned int>(Buffer);
+    }
+    GLCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0));
+
+    myNextBuffer = 0;
+    myNbInFlight = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destroy the pixel buffer objects
+////////////////////////////////////////////////////////////
+void FrameRecorder::DestroyBuffers()
+{
+    for (int i = 0; i < NbBuffers; ++i)
+    {
+        if (myBuffers[i])
+        {
+            GLuint Buffer = static_cast<GLuint>(myBuffers[i]);
+            GLCheck(glDeleteBuffersARB(1, &Buffer));
+            myBuffers[i] = 0;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Fetch the oldest frame still in a pixel buffer object
+////////////////////////////////////////////////////////////
+void FrameRecorder::FetchOldestFrame()
+{
+    unsigned int Oldest = (myNextBuffer + NbBuffers - myNbInFlight) % NbBuffers;
+    --myNbInFlight;
+
+    Frame* NewFrame = AcquireFrame();
+    if (!NewFrame)
+        return;
+
+    GLCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, myBuffers[Oldest]));
+    const Uint8* Pixels = static_cast<const Uint8*>(glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB));
+    if (Pixels)
+    {
+        CopyFlipped(&NewFrame->Pixels[0], Pixels, myWidth, myHeight);
+        GLCheck(glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB));
+    }
+    GLCheck(glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0));
+
+    if (Pixels)
+    {
+        QueueFrame(NewFrame);
+    }
+    else
+    {
+        Lock ScopedLock(myMutex);
+        myFreeFrames.push_back(NewFrame);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Fetch all the frames still in pixel buffer objects
+////////////////////////////////////////////////////////////
+void FrameRecorder::FlushBuffers()
+{
+    while (myNbInFlight > 0)
+        FetchOldestFrame();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get a frame to fill, unless the writer thread is too late
+////////////////////////////////////////////////////////////
+FrameRecorder::Frame* FrameRecorder::AcquireFrame()
+{
+    Frame* NewFrame = NULL;
+    {
+        Lock ScopedLock(myMutex);
+
+        // Drop the frame rather than stalling the rendering
+        if (myQueue.size() >= MaxQueuedFrames)
+        {
+            ++myNbDropped;
+            return NULL;
+        }
+
+        if (!myFreeFrames.empty())
+        {
+            NewFrame = myFreeFrames.back();
+            myFreeFrames.pop_back();
+        }
+    }
+
+    if (!NewFrame)
+        NewFrame = new Frame;
+
+    NewFrame->Width  = myWidth;
+    NewFrame->Height = myHeight;
+    NewFrame->Pixels.resize(myWidth * myHeight * 4);
+
+    return NewFrame;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Hand a filled frame to the writer thread
+////////////////////////////////////////////////////////////
+void FrameRecorder::QueueFrame(Frame* NewFrame)
+{
+    Lock ScopedLock(myMutex);
+    myQueue.push_back(NewFrame);
+
+    // Wake up the writer thread if it's idle
+    if (!myIsWriting)
+    {
+        myIsWriting = true;
+        myWriter.Launch();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Write a frame to its destination
+////////////////////////////////////////////////////////////
+bool FrameRecorder::WriteFrame(const Frame& Source)
+{
+    if (myCallback)
+    {
+        myCallback(&Source.Pixels[0], Source.Width, Source.Height, myUserData);
+        return true;
+    }
+
+    switch (myFormat)
+    {
+        case RecordFormat::RawRGBA :
+        {
+            return fwrite(&Source.Pixels[0], Source.Pixels.size(), 1, myFile) == 1;
+        }
+
+        case RecordFormat::Y4M :
+        {
+            std::vector<Uint8> Planes;
+            ConvertToYUV420(&Source.Pixels[0], Source.Width, Source.Height, Planes);
+            return (fputs("FRAME\n", myFile) >= 0) && (fwrite(&Planes[0], Planes.size(), 1, myFile) == 1);
+        }
+
+        default :
+        case RecordFormat::PngSequence :
+        {
+            std::ostringstream Filename;
+            Filename << myFilename << std::setw(6) << std::setfill('0') << myNbWritten << ".png";
+            return priv::ImageLoader::GetInstance().SaveImageToFile(Filename.str(), Source.Pixels, Source.Width, Source.Height);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Entry point of the writer thread
+////////////////////////////////////////////////////////////
+void FrameRecorder::RunWriter(void* UserData)
+{
+    FrameRecorder& Self = *static_cast<FrameRecorder*>(UserData);
+
+    for (;;)
+    {
+        // Get the next frame
+        Frame* Current;
+        {
+            Lock ScopedLock(Self.myMutex);
+            if (Self.myQueue.empty())
+            {
+                Self.myIsWriting = false;
+                return;
+            }
+
+            Current = Self.myQueue.front();
+            Self.myQueue.pop_front();
+        }
+
+        // Write it, unless a previous write failed
+        if (!Self.myWriteFailed)
+        {
+            if (Self.WriteFrame(*Current))
+            {
+                ++Self.myNbWritten;
+            }
+            else
+            {
+                std::cerr << "Failed to write recorded frame " << Self.myNbWritten << ", the next frames will be discarded" << std::endl;
+                Self.myWriteFailed = true;
+            }
+        }
+
+        // The frame can now be reused
+        Lock ScopedLock(Self.myMutex);
+        Self.myFreeFrames.push_back(Current);
+    }
+}
+
+} // namespace sf
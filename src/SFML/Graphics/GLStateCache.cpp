@@ -0,0 +1,374 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/GLStateCache.hpp>
+#include <SFML/Graphics/GraphicsContext.hpp>
+#include <set>
+
+
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Get the list of all the existing caches.
+    // We use a function with a static variable rather than
+    // directly a global variable, to avoid the randomness
+    // of global variables initializations across compile units.
+    ////////////////////////////////////////////////////////////
+    std::set<sf::priv::GLStateCache*>& GetCaches()
+    {
+        static std::set<sf::priv::GLStateCache*> Caches;
+        return Caches;
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+// Static member data
+////////////////////////////////////////////////////////////
+GLStateCache* GLStateCache::ourCurrent = NULL;
+
+
+////////////////////////////////////////////////////////////
+/// Default constructor
+////////////////////////////////////////////////////////////
+GLStateCache::GLStateCache() :
+myNbElidedCalls(0)
+{
+    Invalidate();
+    GetCaches().insert(this);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destructor
+////////////////////////////////////////////////////////////
+GLStateCache::~GLStateCache()
+{
+    if (ourCurrent == this)
+        ourCurrent = NULL;
+
+    GetCaches().erase(this);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Forget all the states
+////////////////////////////////////////////////////////////
+void GLStateCache::Invalidate()
+{
+    myTextureKnown   = false;
+    myTexture        = 0;
+    myTextureEnabled = -1;
+    myBlendEnabled   = -1;
+    myBlendMode      = -1;
+    myColorKnown     = false;
+    myViewportKnown  = false;
+    myMatrixMode     = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the number of OpenGL calls skipped since the last
+/// call to ResetCounter
+////////////////////////////////////////////////////////////
+unsigned int GLStateCache::GetNbElidedCalls() const
+{
+    return myNbElidedCalls;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Reset the counter of skipped calls
+////////////////////////////////////////////////////////////
+void GLStateCache::ResetCounter()
+{
+    myNbElidedCalls = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Change the current cache
+////////////////////////////////////////////////////////////
+void GLStateCache::SetCurrent(GLStateCache* Cache)
+{
+    ourCurrent = Cache;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Tell whether there is a current cache
+////////////////////////////////////////////////////////////
+bool GLStateCache::HasCurrent()
+{
+    return ourCurrent != NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Bind a texture to the 2D target of the active unit
+////////////////////////////////////////////////////////////
+void GLStateCache::BindTexture(GLuint Texture)
+{
+    if (ourCurrent)
+    {
+        if (ourCurrent->myTextureKnown && (ourCurrent->myTexture == Texture))
+        {
+            ourCurrent->myNbElidedCalls++;
+            return;
+        }
+
+        ourCurrent->myTextureKnown = true;
+        ourCurrent->myTexture      = Texture;
+    }
+    else
+    {
+        // The binding of a context we don't know is changed : no cache can be trusted anymore
+        ForgetTextures();
+    }
+
+    GLCheck(glBindTexture(GL_TEXTURE_2D, Texture));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Enable or disable 2D texturing
+////////////////////////////////////////////////////////////
+void GLStateCache::EnableTexture(bool Enable)
+{
+    if (ourCurrent)
+    {
+        if (ourCurrent->myTextureEnabled == static_cast<int>(Enable))
+        {
+            ourCurrent->myNbElidedCalls++;
+            return;
+        }
+
+        ourCurrent->myTextureEnabled = Enable;
+    }
+    else
+    {
+        ForgetTextures();
+    }
+
+    if (Enable)
+        GLCheck(glEnable(GL_TEXTURE_2D));
+    else
+        GLCheck(glDisable(GL_TEXTURE_2D));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Setup blending for a blending mode
+////////////////////////////////////////////////////////////
+void GLStateCache::SetBlendMode(Blend::Mode Mode)
+{
+    bool Enable      = (Mode != Blend::None);
+    bool ChangeState = true;
+    bool ChangeFunc  = Enable;
+
+    if (ourCurrent)
+    {
+        if (ourCurrent->myBlendEnabled == static_cast<int>(Enable))
+        {
+            ourCurrent->myNbElidedCalls++;
+            ChangeState = false;
+        }
+        if (Enable && (ourCurrent->myBlendMode == Mode))
+        {
+            ourCurrent->myNbElidedCalls++;
+            ChangeFunc = false;
+        }
+
+        ourCurrent->myBlendEnabled = Enable;
+        if (Enable)
+            ourCurrent->myBlendMode = Mode;
+    }
+
+    if (ChangeState)
+    {
+        if (Enable)
+            GLCheck(glEnable(GL_BLEND));
+        else
+            GLCheck(glDisable(GL_BLEND));
+    }
+
+    if (ChangeFunc)
+    {
+        switch (Mode)
+        {
+            case Blend::Alpha :    GLCheck(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)); break;
+            case Blend::Add :      GLCheck(glBlendFunc(GL_SRC_ALPHA, GL_ONE));                 break;
+            case Blend::Multiply : GLCheck(glBlendFunc(GL_DST_COLOR, GL_ZERO));                break;
+            default :                                                                          break;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Change the current color
+////////////////////////////////////////////////////////////
+void GLStateCache::SetColor(const Color& Col)
+{
+    if (ourCurrent)
+    {
+        if (ourCurrent->myColorKnown && (ourCurrent->myColor == Col))
+        {
+            ourCurrent->myNbElidedCalls++;
+            return;
+        }
+
+        ourCurrent->myColorKnown = true;
+        ourCurrent->myColor      = Col;
+    }
+
+    GLCheck(glColor4f(Col.r / 255.f, Col.g / 255.f, Col.b / 255.f, Col.a / 255.f));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Change the viewport
+////////////////////////////////////////////////////////////
+void GLStateCache::SetViewport(GLint Left, GLint Top, GLsizei Width, GLsizei Height)
+{
+    if (ourCurrent)
+    {
+        GLint* Viewport = ourCurrent->myViewport;
+        if (ourCurrent->myViewportKnown &&
+            (Viewport[0] == Left) && (Viewport[1] == Top) && (Viewport[2] == Width) && (Viewport[3] == Height))
+        {
+            ourCurrent->myNbElidedCalls++;
+            return;
+        }
+
+        ourCurrent->myViewportKnown = true;
+        Viewport[0] = Left;
+        Viewport[1] = Top;
+        Viewport[2] = Width;
+        Viewport[3] = Height;
+    }
+
+    GLCheck(glViewport(Left, Top, Width, Height));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Change the current matrix mode
+////////////////////////////////////////////////////////////
+void GLStateCache::SetMatrixMode(GLenum Mode)
+{
+    if (ourCurrent)
+    {
+        if (ourCurrent->myMatrixMode == Mode)
+        {
+            ourCurrent->myNbElidedCalls++;
+            return;
+        }
+
+        ourCurrent->myMatrixMode = Mode;
+    }
+
+    GLCheck(glMatrixMode(Mode));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Forget the current color
+////////////////////////////////////////////////////////////
+void GLStateCache::ForgetColor()
+{
+    if (ourCurrent)
+        ourCurrent->myColorKnown = false;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Forget the texture states
+////////////////////////////////////////////////////////////
+void GLStateCache::ForgetTextures()
+{
+    if (ourCurrent)
+    {
+        ourCurrent->myTextureKnown   = false;
+        ourCurrent->myTextureEnabled = -1;
+    }
+    else
+    {
+        // We don't know which context is affected
+        std::set<GLStateCache*>& Caches = GetCaches();
+        for (std::set<GLStateCache*>::iterator i = Caches.begin(); i != Caches.end(); ++i)
+        {
+            (*i)->myTextureKnown   = false;
+            (*i)->myTextureEnabled = -1;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove a texture from all the caches
+////////////////////////////////////////////////////////////
+void GLStateCache::ForgetTexture(GLuint Texture)
+{
+    std::set<GLStateCache*>& Caches = GetCaches();
+    for (std::set<GLStateCache*>::iterator i = Caches.begin(); i != Caches.end(); ++i)
+    {
+        if ((*i)->myTexture == Texture)
+            (*i)->myTextureKnown = false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Default constructor, save the bound texture
+////////////////////////////////////////////////////////////
+TextureSaver::TextureSaver() :
+myRestore        (!GLStateCache::HasCurrent()),
+myPreviousTexture(0)
+{
+    if (myRestore)
+        GLCheck(glGetIntegerv(GL_TEXTURE_BINDING_2D, &myPreviousTexture));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destructor, restore the bound texture
+////////////////////////////////////////////////////////////
+TextureSaver::~TextureSaver()
+{
+    if (myRestore)
+        GLCheck(glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(myPreviousTexture)));
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,233 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_GLSTATECACHE_HPP
+#define SFML_GLSTATECACHE_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Config.hpp>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/GLEW/glew.h>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// Shadow copy of the OpenGL states changed by SFML, used
+/// to skip the calls which wouldn't change anything.
+/// Each render target owns one for its context, which is
+/// made current while the target is drawing ; the static
+/// functions go through the current cache, or directly to
+/// OpenGL when there is none.
+/// This class is for internal use only
+////////////////////////////////////////////////////////////
+class GLStateCache : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    GLStateCache();
+
+    ////////////////////////////////////////////////////////////
+    /// Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~GLStateCache();
+
+    ////////////////////////////////////////////////////////////
+    /// Forget all the states, so that the next calls are
+    /// all sent to OpenGL
+    ///
+    ////////////////////////////////////////////////////////////
+    void Invalidate();
+
+    ////////////////////////////////////////////////////////////
+    /// Get the number of OpenGL calls skipped since the last
+    /// call to ResetCounter
+    ///
+    /// \return Number of skipped calls
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int GetNbElidedCalls() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Reset the counter of skipped calls
+    ///
+    ////////////////////////////////////////////////////////////
+    void ResetCounter();
+
+    ////////////////////////////////////////////////////////////
+    /// Change the current cache
+    ///
+    /// \param Cache : Cache to use (NULL to send all calls to OpenGL)
+    ///
+    ////////////////////////////////////////////////////////////
+    static void SetCurrent(GLStateCache* Cache);
+
+    ////////////////////////////////////////////////////////////
+    /// Tell whether there is a current cache
+    ///
+    /// \return True if calls are going through a cache
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool HasCurrent();
+
+    ////////////////////////////////////////////////////////////
+    /// Bind a texture to the 2D target of the active unit
+    ///
+    /// \param Texture : OpenGL identifier of the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    static void BindTexture(GLuint Texture);
+
+    ////////////////////////////////////////////////////////////
+    /// Enable or disable 2D texturing
+    ///
+    /// \param Enable : True to enable, false to disable
+    ///
+    ////////////////////////////////////////////////////////////
+    static void EnableTexture(bool Enable);
+
+    ////////////////////////////////////////////////////////////
+    /// Setup blending for a blending mode
+    ///
+    /// \param Mode : Blending mode to use
+    ///
+    ////////////////////////////////////////////////////////////
+    static void SetBlendMode(Blend::Mode Mode);
+
+    ////////////////////////////////////////////////////////////
+    /// Change the current color
+    ///
+    /// \param Col : New color
+    ///
+    ////////////////////////////////////////////////////////////
+    static void SetColor(const Color& Col);
+
+    ////////////////////////////////////////////////////////////
+    /// Change the viewport
+    ///
+    /// \param Left, Top, Width, Height : New viewport
+    ///
+    ////////////////////////////////////////////////////////////
+    static void SetViewport(GLint Left, GLint Top, GLsizei Width, GLsizei Height);
+
+    ////////////////////////////////////////////////////////////
+    /// Change the current matrix mode
+    ///
+    /// \param Mode : New matrix mode
+    ///
+    ////////////////////////////////////////////////////////////
+    static void SetMatrixMode(GLenum Mode);
+
+    ////////////////////////////////////////////////////////////
+    /// Forget the current color ; to be called after it has
+    /// been changed directly (immediate mode, color arrays)
+    ///
+    ////////////////////////////////////////////////////////////
+    static void ForgetColor();
+
+    ////////////////////////////////////////////////////////////
+    /// Forget the texture states ; to be called after textures
+    /// have been bound or enabled directly (other texture units)
+    ///
+    ////////////////////////////////////////////////////////////
+    static void ForgetTextures();
+
+    ////////////////////////////////////////////////////////////
+    /// Remove a texture from all the caches ; to be called
+    /// when it is destroyed
+    ///
+    /// \param Texture : OpenGL identifier of the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    static void ForgetTexture(GLuint Texture);
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    bool         myTextureKnown;   ///< Is the bound texture known ?
+    GLuint       myTexture;        ///< Bound texture
+    int          myTextureEnabled; ///< Is 2D texturing enabled (-1 if unknown) ?
+    int          myBlendEnabled;   ///< Is blending enabled (-1 if unknown) ?
+    int          myBlendMode;      ///< Current blending function, as a blending mode (-1 if unknown)
+    bool         myColorKnown;     ///< Is the current color known ?
+    Color        myColor;          ///< Current color
+    bool         myViewportKnown;  ///< Is the viewport known ?
+    GLint        myViewport[4];    ///< Current viewport
+    GLenum       myMatrixMode;     ///< Current matrix mode (0 if unknown)
+    unsigned int myNbElidedCalls;  ///< Number of calls skipped since the last reset
+
+    static GLStateCache* ourCurrent; ///< Cache of the target being drawn
+};
+
+
+////////////////////////////////////////////////////////////
+/// RAII class saving the bound texture and restoring it when
+/// destroyed ; nothing has to be saved if the bindings
+/// go through a cache
+////////////////////////////////////////////////////////////
+class TextureSaver : NonCopyable
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Default constructor, save the bound texture
+    ///
+    ////////////////////////////////////////////////////////////
+    TextureSaver();
+
+    ////////////////////////////////////////////////////////////
+    /// Destructor, restore the bound texture
+    ///
+    ////////////////////////////////////////////////////////////
+    ~TextureSaver();
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    bool  myRestore;         ///< Do we have to restore the texture ?
+    GLint myPreviousTexture; ///< Texture bound at construction
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_GLSTATECACHE_HPP
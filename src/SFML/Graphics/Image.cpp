@@ -27,14 +27,200 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/ImageLoader.hpp>
-#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/ImageResampler.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/GLStateCache.hpp>
+#include <SFML/Graphics/PixelKernels.hpp>
+#include <SFML/System/Thread.hpp>
 #include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string.h>
 
 
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Maximum number of threads building a mipmap, and minimum
+    // number of pixels to give to each of them
+    ////////////////////////////////////////////////////////////
+    const unsigned int MaxWorkers         = 4;
+    const unsigned int MinPixelsPerWorker = 128 * 128;
+
+    ////////////////////////////////////////////////////////////
+    /// Get the size of a pixel, in bytes
+    ////////////////////////////////////////////////////////////
+    unsigned int GetPixelSize(sf::PixelFormat::Format Format)
+    {
+        return Format == sf::PixelFormat::RGBA8 ? 4 : 1;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Get the OpenGL internal format and pixel format of a pixel format
+    ////////////////////////////////////////////////////////////
+    void GetGLFormat(sf::PixelFormat::Format Format, GLint& InternalFormat, GLenum& PixelFormat)
+    {
+        switch (Format)
+        {
+            default :
+            case sf::PixelFormat::RGBA8 : InternalFormat = GL_RGBA8;      PixelFormat = GL_RGBA;      break;
+            case sf::PixelFormat::A8 :    InternalFormat = GL_ALPHA8;     PixelFormat = GL_ALPHA;     break;
+            case sf::PixelFormat::L8 :    InternalFormat = GL_LUMINANCE8; PixelFormat = GL_LUMINANCE; break;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Get the OpenGL minification and magnification filters of
+    /// a texture filter
+    ////////////////////////////////////////////////////////////
+    void GetGLFilters(sf::TextureFilter::Mode Filter, GLint& MinFilter, GLint& MagFilter)
+    {
+        switch (Filter)
+        {
+            case sf::TextureFilter::Nearest :   MinFilter = GL_NEAREST;              MagFilter = GL_NEAREST; break;
+            default :
+            case sf::TextureFilter::Linear :    MinFilter = GL_LINEAR;               MagFilter = GL_LINEAR;  break;
+            case sf::TextureFilter::Trilinear : MinFilter = GL_LINEAR_MIPMAP_LINEAR; MagFilter = GL_LINEAR;  break;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Get the size of the area covered by the image in a mipmap ;
+    /// it's half the area of the previous level, but can't exceed
+    /// the size of the mipmap texture
+    ////////////////////////////////////////////////////////////
+    unsigned int GetMipmapSize(unsigned int PreviousSize, unsigned int TextureSize, unsigned int Level)
+    {
+        return std::min((PreviousSize + 1) / 2, std::max(TextureSize >> Level, 1u));
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Area of a mipmap to compute from the previous level
+    ////////////////////////////////////////////////////////////
+    struct MipmapJob
+    {
+        const sf::Uint8* Src;       ///< Pixels of the previous level
+        unsigned int     SrcWidth;  ///< Width of the previous level
+        unsigned int     SrcHeight; ///< Height of the previous level
+        sf::Uint8*       Dst;       ///< Pixels of the level to compute
+        unsigned int     DstWidth;  ///< Width of the level to compute
+        unsigned int     PixelSize; ///< Size of a pixel, in bytes
+        unsigned int     Left;      ///< Left of the area to compute
+        unsigned int     Top;       ///< Top of the area to compute
+        unsigned int     Right;     ///< Right of the area to compute (excluded)
+        unsigned int     Bottom;    ///< Bottom of the area to compute (excluded)
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Compute an area of a mipmap with a 2x2 box filter ; the
+    /// source pixels outside the previous level are clamped
+    ////////////////////////////////////////////////////////////
+    void ComputeMipmap(void* UserData)
+    {
+        const MipmapJob& Job = *static_cast<const MipmapJob*>(UserData);
+        const unsigned int Size = Job.PixelSize;
+
+        // Pixels whose 2x2 block is entirely inside the previous level
+        unsigned int FullRight = std::max(std::min(Job.Right, Job.SrcWidth / 2), Job.Left);
+
+        for (unsigned int y = Job.Top; y < Job.Bottom; ++y)
+        {
+            const sf::Uint8* Row0 = Job.Src + std::min(y * 2,     Job.SrcHeight - 1) * Job.SrcWidth * Size;
+            const sf::Uint8* Row1 = Job.Src + std::min(y * 2 + 1, Job.SrcHeight - 1) * Job.SrcWidth * Size;
+            sf::Uint8*       Out  = Job.Dst + (y * Job.DstWidth + Job.Left) * Size;
+
+            unsigned int x = Job.Left;
+            if (Size == 4)
+            {
+                sf::priv::PixelKernels::HalveRows(Out, Row0 + x * 8, Row1 + x * 8, FullRight - x);
+                Out += (FullRight - x) * 4;
+                x = FullRight;
+            }
+
+            for (; x < Job.Right; ++x)
+            {
+                unsigned int X0 = std::min(x * 2,     Job.SrcWidth - 1) * Size;
+                unsigned int X1 = std::min(x * 2 + 1, Job.SrcWidth - 1) * Size;
+                for (unsigned int c = 0; c < Size; ++c)
+                    *Out++ = static_cast<sf::Uint8>((Row0[X0 + c] + Row0[X1 + c] + Row1[X0 + c] + Row1[X1 + c] + 2) >> 2);
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Compute an area of a mipmap, splitting its rows between
+    /// several threads if it's big enough
+    ////////////////////////////////////////////////////////////
+    void ComputeMipmapParallel(const MipmapJob& Area)
+    {
+        unsigned int NbRows    = Area.Bottom - Area.Top;
+        unsigned int NbPixels  = NbRows * (Area.Right - Area.Left);
+        unsigned int NbWorkers = std::max(std::min(std::min(MaxWorkers, NbPixels / MinPixelsPerWorker), NbRows), 1u);
+
+        std::vector<MipmapJob> Jobs(NbWorkers, Area);
+        for (unsigned int i = 0; i < NbWorkers; ++i)
+        {
+            Jobs[i].Top    = Area.Top + NbRows * i / NbWorkers;
+            Jobs[i].Bottom = Area.Top + NbRows * (i + 1) / NbWorkers;
+        }
+
+        // The first part is computed by this thread
+        std::vector<sf::Thread*> Workers;
+        for (unsigned int i = 1; i < NbWorkers; ++i)
+        {
+            Workers.push_back(new sf::Thread(&ComputeMipmap, &Jobs[i]));
+            Workers.back()->Launch();
+        }
+        ComputeMipmap(&Jobs[0]);
+        for (std::vector<sf::Thread*>::iterator i = Workers.begin(); i != Workers.end(); ++i)
+        {
+            (*i)->Wait();
+            delete *i;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Decode a pixel into a color
+    ////////////////////////////////////////////////////////////
+    sf::Color ReadPixel(const sf::Uint8* Pixel, sf::PixelFormat::Format Format)
+    {
+        switch (Format)
+        {
+            default :
+            case sf::PixelFormat::RGBA8 : return sf::Color(Pixel[0], Pixel[1], Pixel[2], Pixel[3]);
+            case sf::PixelFormat::A8 :    return sf::Color(255, 255, 255, Pixel[0]);
+            case sf::PixelFormat::L8 :    return sf::Color(Pixel[0], Pixel[0], Pixel[0], 255);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Encode a color into a pixel
+    ////////////////////////////////////////////////////////////
+    void WritePixel(sf::Uint8* Pixel, const sf::Color& Col, sf::PixelFormat::Format Format)
+    {
+        switch (Format)
+        {
+            default :
+            case sf::PixelFormat::RGBA8 :
+                Pixel[0] = Col.r;
+                Pixel[1] = Col.g;
+                Pixel[2] = Col.b;
+                Pixel[3] = Col.a;
+                break;
+
+            case sf::PixelFormat::A8 :
+                Pixel[0] = Col.a;
+                break;
+
+            case sf::PixelFormat::L8 :
+                Pixel[0] = static_cast<sf::Uint8>((Col.r * 77 + Col.g * 150 + Col.b * 29) >> 8);
+                break;
+        }
+    }
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
@@ -43,12 +229,16 @@ namespace sf
 Image::Image() :
 myWidth            (0),
 myHeight           (0),
+myFormat           (PixelFormat::RGBA8),
 myTextureWidth     (0),
 myTextureHeight    (0),
 myTexture          (0),
-myIsSmooth         (true),
+myFilter           (TextureFilter::Linear),
+myDirtyRect        (0, 0, 0, 0),
 myNeedTextureUpdate(false),
-myNeedArrayUpdate  (false)
+myNeedArrayUpdate  (false),
+myNeedMipmapsUpdate(false),
+myAsyncRequest     (NULL)
 {
 
 }
@@ -61,13 +251,17 @@ Image::Image(const Image& Copy) :
 Resource<Image>    (Copy),
 myWidth            (Copy.myWidth),
 myHeight           (Copy.myHeight),
+myFormat           (Copy.myFormat),
 myTextureWidth     (Copy.myTextureWidth),
 myTextureHeight    (Copy.myTextureHeight),
 myTexture          (0),
-myIsSmooth         (Copy.myIsSmooth),
+myFilter           (Copy.myFilter),
 myPixels           (Copy.myPixels),
+myDirtyRect        (0, 0, 0, 0),
 myNeedTextureUpdate(false),
-myNeedArrayUpdate  (false)
+myNeedArrayUpdate  (false),
+myNeedMipmapsUpdate(false),
+myAsyncRequest     (NULL)
 {
     CreateTexture();
 }
@@ -76,34 +270,42 @@ myNeedArrayUpdate  (false)
 ////////////////////////////////////////////////////////////
 /// Construct an empty image
 ////////////////////////////////////////////////////////////
-Image::Image(unsigned int Width, unsigned int Height, const Color& Col) :
+Image::Image(unsigned int Width, unsigned int Height, const Color& Col, PixelFormat::Format Format) :
 myWidth            (0),
 myHeight           (0),
+myFormat           (PixelFormat::RGBA8),
 myTextureWidth     (0),
 myTextureHeight    (0),
 myTexture          (0),
-myIsSmooth         (true),
+myFilter           (TextureFilter::Linear),
+myDirtyRect        (0, 0, 0, 0),
 myNeedTextureUpdate(false),
-myNeedArrayUpdate  (false)
+myNeedArrayUpdate  (false),
+myNeedMipmapsUpdate(false),
+myAsyncRequest     (NULL)
 {
-    Create(Width, Height, Col);
+    Create(Width, Height, Col, Format);
 }
 
 
 ////////////////////////////////////////////////////////////
 /// Construct the image from pixels in memory
 ////////////////////////////////////////////////////////////
-Image::Image(unsigned int Width, unsigned int Height, const Uint8* Data) :
+Image::Image(unsigned int Width, unsigned int Height, const Uint8* Data, PixelFormat::Format Format) :
 myWidth            (0),
 myHeight           (0),
+myFormat           (PixelFormat::RGBA8),
 myTextureWidth     (0),
 myTextureHeight    (0),
 myTexture          (0),
-myIsSmooth         (true),
+myFilter           (TextureFilter::Linear),
+myDirtyRect        (0, 0, 0, 0),
 myNeedTextureUpdate(false),
-myNeedArrayUpdate  (false)
+myNeedArrayUpdate  (false),
+myNeedMipmapsUpdate(false),
+myAsyncRequest     (NULL)
 {
-    LoadFromPixels(Width, Height, Data);
+    LoadFromPixels(Width, Height, Data, Format);
 }
 
 
@@ -112,6 +314,9 @@ myNeedArrayUpdate  (false)
 ////////////////////////////////////////////////////////////
 Image::~Image()
 {
+    // Abandon the background loading
+    CancelLoading();
+
     // Destroy the OpenGL texture
     DestroyTexture();
 }
@@ -122,12 +327,16 @@ Image::~Image()
 ////////////////////////////////////////////////////////////
 bool Image::LoadFromFile(const std::string& Filename)
 {
+    CancelLoading();
+
     // Let the image loader load the image into our pixel array
-    bool Success = priv::ImageLoader::GetInstance().LoadImageFromFile(Filename, myPixels, myWidth, myHeight);
+    PixelFormat::Format Format;
+    bool Success = priv::ImageLoader::GetInstance().LoadImageFromFile(Filename, myPixels, myWidth, myHeight, Format);
 
     if (Success)
     {
         // Loading succeeded : we can create the texture
+        SetFormat(Format);
         if (CreateTexture())
             return true;
     }
@@ -139,11 +348,89 @@ bool Image::LoadFromFile(const std::string& Filename)
 }
 
 
+////////////////////////////////////////////////////////////
+/// Load the image from a file, reduced to fit into a maximum size
+////////////////////////////////////////////////////////////
+bool Image::LoadFromFile(const std::string& Filename, unsigned int MaxWidth, unsigned int MaxHeight)
+{
+    CancelLoading();
+
+    // Check parameters
+    if ((MaxWidth == 0) || (MaxHeight == 0))
+    {
+        std::cerr << "Failed to load image \"" << Filename << "\", invalid maximum size (" << MaxWidth << "x" << MaxHeight << ")" << std::endl;
+        Reset();
+        return false;
+    }
+
+    // Let the image loader load and reduce the image into our pixel array
+    PixelFormat::Format Format;
+    bool Success = priv::ImageLoader::GetInstance().LoadImageFromFile(Filename, myPixels, myWidth, myHeight, Format, MaxWidth, MaxHeight);
+
+    if (Success)
+    {
+        // Loading succeeded : we can create the texture
+        SetFormat(Format);
+        if (CreateTexture())
+            return true;
+    }
+
+    // Oops... something failed
+    Reset();
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Start loading the image from a file in the background
+////////////////////////////////////////////////////////////
+void Image::LoadFromFileAsync(const std::string& Filename)
+{
+    // The image stays empty until the loading is finished ; like
+    // LoadFromFile, we keep the filter chosen for the image
+    CancelLoading();
+    TextureFilter::Mode Filter = myFilter;
+    Reset();
+    myFilter = Filter;
+
+    myAsyncRequest = priv::ImageLoader::GetInstance().LoadImageFromFileAsync(Filename);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Tell whether a loading started with LoadFromFileAsync is
+/// still in progress
+////////////////////////////////////////////////////////////
+bool Image::IsLoading()
+{
+    if (!myAsyncRequest)
+        return false;
+
+    // Check if the worker has decoded the file
+    bool Success = false;
+    PixelFormat::Format Format = PixelFormat::RGBA8;
+    if (!priv::ImageLoader::GetInstance().GetAsyncResult(myAsyncRequest, myPixels, myWidth, myHeight, Format, Success))
+        return true;
+
+    myAsyncRequest = NULL;
+    SetFormat(Format);
+
+    // Decoding is finished : we can create the texture in this thread
+    if (!Success || !CreateTexture())
+        Reset();
+
+    return false;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Load the image from a file in memory
 ////////////////////////////////////////////////////////////
 bool Image::LoadFromMemory(const char* Data, std::size_t SizeInBytes)
 {
+    CancelLoading();
+
     // Check parameters
     if (!Data || (SizeInBytes == 0))
     {
@@ -152,11 +439,13 @@ bool Image::LoadFromMemory(const char* Data, std::size_t SizeInBytes)
     }
 
     // Let the image loader load the image into our pixel array
-    bool Success = priv::ImageLoader::GetInstance().LoadImageFromMemory(Data, SizeInBytes, myPixels, myWidth, myHeight);
+    PixelFormat::Format Format;
+    bool Success = priv::ImageLoader::GetInstance().LoadImageFromMemory(Data, SizeInBytes, myPixels, myWidth, myHeight, Format);
 
     if (Success)
     {
         // Loading succeeded : we can create the texture
+        SetFormat(Format);
         if (CreateTexture())
             return true;
     }
@@ -171,17 +460,19 @@ bool Image::LoadFromMemory(const char* Data, std::size_t SizeInBytes)
 ////////////////////////////////////////////////////////////
 /// Load the image directly from an array of pixels
 ////////////////////////////////////////////////////////////
-bool Image::LoadFromPixels(unsigned int Width, unsigned int Height, const Uint8* Data)
+bool Image::LoadFromPixels(unsigned int Width, unsigned int Height, const Uint8* Data, PixelFormat::Format Format)
 {
+    CancelLoading();
+
     if (Data)
     {
-        // Store the texture dimensions
+        // Store the texture dimensions and format
         myWidth  = Width;
         myHeight = Height;
+        SetFormat(Format);
 
         // Fill the pixel buffer with the specified raw data
-        const Color* Ptr = reinterpret_cast<const Color*>(Data);
-        myPixels.assign(Ptr, Ptr + Width * Height);
+        myPixels.assign(Data, Data + Width * Height * GetPixelSize(myFormat));
 
         // We can create the texture
         if (CreateTexture())
@@ -198,7 +489,7 @@ bool Image::LoadFromPixels(unsigned int Width, unsigned int Height, const Uint8*
     else
     {
         // No data provided : create a white image
-        return Create(Width, Height, Color(255, 255, 255, 255));
+        return Create(Width, Height, Color(255, 255, 255, 255), Format);
     }
 }
 
@@ -211,23 +502,66 @@ bool Image::SaveToFile(const std::string& Filename) const
     // Check if the array of pixels needs to be updated
     EnsureArrayUpdate();
 
+    // The image loader only deals with RGBA pixels
+    if (myFormat != PixelFormat::RGBA8)
+    {
+        std::vector<Uint8> Pixels(myWidth * myHeight * 4);
+        for (std::size_t i = 0; i < myPixels.size(); ++i)
+            WritePixel(&Pixels[i * 4], ReadPixel(&myPixels[i], myFormat), PixelFormat::RGBA8);
+
+        return priv::ImageLoader::GetInstance().SaveImageToFile(Filename, Pixels, myWidth, myHeight);
+    }
+
     // Let the image loader save our pixel array into the image
     return priv::ImageLoader::GetInstance().SaveImageToFile(Filename, myPixels, myWidth, myHeight);
 }
 
 
+////////////////////////////////////////////////////////////
+/// Save the content of the image to a cache file
+////////////////////////////////////////////////////////////
+bool Image::SaveToCache(const std::string& Filename, bool Compress) const
+{
+    // Check if the array of pixels needs to be updated
+    EnsureArrayUpdate();
+
+    if (myPixels.empty())
+    {
+        std::cerr << "Failed to save image cache \"" << Filename << "\", the image is empty" << std::endl;
+        return false;
+    }
+
+    // Pixels are stored in their own format, so that nothing has to be converted when loading them back
+    return priv::ImageLoader::GetInstance().SaveImageToCache(Filename, myPixels, myWidth, myHeight, myFormat, Compress);
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Create an empty image
 ////////////////////////////////////////////////////////////
-bool Image::Create(unsigned int Width, unsigned int Height, Color Col)
+bool Image::Create(unsigned int Width, unsigned int Height, Color Col, PixelFormat::Format Format)
 {
-    // Store the texture dimensions
+    CancelLoading();
+
+    // Store the texture dimensions and format
     myWidth  = Width;
     myHeight = Height;
+    SetFormat(Format);
 
     // Recreate the pixel buffer and fill it with the specified color
     myPixels.clear();
-    myPixels.resize(Width * Height, Col);
+    myPixels.resize(Width * Height * GetPixelSize(myFormat));
+    if (myFormat == PixelFormat::RGBA8)
+    {
+        if (!myPixels.empty())
+            priv::PixelKernels::Fill(&myPixels[0], Width * Height, Col);
+    }
+    else
+    {
+        Uint8 Value;
+        WritePixel(&Value, Col, myFormat);
+        std::fill(myPixels.begin(), myPixels.end(), Value);
+    }
 
     // We can create the texture
     if (CreateTexture())
@@ -255,10 +589,23 @@ void Image::CreateMaskFromColor(Color ColorKey, Uint8 Alpha)
     Color NewColor(ColorKey.r, ColorKey.g, ColorKey.b, Alpha);
 
     // Replace the old color by the new one
-    std::replace(myPixels.begin(), myPixels.end(), ColorKey, NewColor);
+    if (myFormat == PixelFormat::RGBA8)
+    {
+        if (!myPixels.empty())
+            priv::PixelKernels::ReplaceColor(&myPixels[0], myWidth * myHeight, ColorKey, NewColor);
+    }
+    else
+    {
+        unsigned int PixelSize = GetPixelSize(myFormat);
+        for (std::size_t i = 0; i < myPixels.size(); i += PixelSize)
+        {
+            if (ReadPixel(&myPixels[i], myFormat) == ColorKey)
+                WritePixel(&myPixels[i], NewColor, myFormat);
+        }
+    }
 
     // The texture will need to be updated
-    myNeedTextureUpdate = true;
+    AddDirtyRect(IntRect(0, 0, myWidth, myHeight));
 }
 
 
@@ -305,36 +652,61 @@ void Image::Copy(const Image& Source, unsigned int DestX, unsigned int DestY, co
         return;
 
     // Precompute as much as possible
-    int          Pitch     = Width * 4;
+    unsigned int SrcSize   = GetPixelSize(Source.myFormat);
+    unsigned int DstSize   = GetPixelSize(myFormat);
+    int          Pitch     = Width * DstSize;
     int          Rows      = Height;
-    int          SrcStride = Source.myWidth * 4;
-    int          DstStride = myWidth * 4;
-    const Uint8* SrcPixels = Source.GetPixelsPtr() + (SrcRect.Left + SrcRect.Top * Source.myWidth) * 4;
-    Uint8*       DstPixels = reinterpret_cast<Uint8*>(&myPixels[0]) + (DestX + DestY * myWidth) * 4;
+    int          SrcStride = Source.myWidth * SrcSize;
+    int          DstStride = myWidth * DstSize;
+    const Uint8* SrcPixels = Source.GetPixelsPtr() + (SrcRect.Left + SrcRect.Top * Source.myWidth) * SrcSize;
+    Uint8*       DstPixels = &myPixels[0] + (DestX + DestY * myWidth) * DstSize;
 
     // Copy the pixels
-    if (ApplyAlpha)
+    if (ApplyAlpha && (Source.myFormat == PixelFormat::RGBA8) && (myFormat == PixelFormat::RGBA8))
     {
-        // Interpolation using alpha values, pixel by pixel (slower)
+        // Interpolation using alpha values, row by row
+        for (int i = 0; i < Rows; ++i)
+        {
+            priv::PixelKernels::BlendRGB(DstPixels, SrcPixels, Width);
+            SrcPixels += SrcStride;
+            DstPixels += DstStride;
+        }
+    }
+    else if (ApplyAlpha)
+    {
+        // Interpolation using alpha values and format conversion, pixel by pixel (slower)
         for (int i = 0; i < Rows; ++i)
         {
             for (int j = 0; j < Width; ++j)
             {
-                // Get a direct pointer to the components of the current pixel
-                const Uint8* Src   = SrcPixels + j * 4;
-                Uint8*       Dst   = DstPixels + j * 4;
+                // Get the colors of the current pixels
+                Color Src = ReadPixel(SrcPixels + j * SrcSize, Source.myFormat);
+                Color Dst = ReadPixel(DstPixels + j * DstSize, myFormat);
 
                 // Interpolate RGB components using the alpha value of the source pixel
-                Uint8 Alpha = Src[3];
-                Dst[0] = (Src[0] * Alpha + Dst[0] * (255 - Alpha)) / 255;
-                Dst[1] = (Src[1] * Alpha + Dst[1] * (255 - Alpha)) / 255;
-                Dst[2] = (Src[2] * Alpha + Dst[2] * (255 - Alpha)) / 255;
+                Uint8 Alpha = Src.a;
+                Dst.r = (Src.r * Alpha + Dst.r * (255 - Alpha)) / 255;
+                Dst.g = (Src.g * Alpha + Dst.g * (255 - Alpha)) / 255;
+                Dst.b = (Src.b * Alpha + Dst.b * (255 - Alpha)) / 255;
+                WritePixel(DstPixels + j * DstSize, Dst, myFormat);
             }
 
             SrcPixels += SrcStride;
             DstPixels += DstStride;
         }
     }
+    else if (Source.myFormat != myFormat)
+    {
+        // Conversion between the two formats, pixel by pixel (slower)
+        for (int i = 0; i < Rows; ++i)
+        {
+            for (int j = 0; j < Width; ++j)
+                WritePixel(DstPixels + j * DstSize, ReadPixel(SrcPixels + j * SrcSize, Source.myFormat), myFormat);
+
+            SrcPixels += SrcStride;
+            DstPixels += DstStride;
+        }
+    }
     else
     {
         // Optimized copy ignoring alpha values, row by row (faster)
@@ -346,52 +718,93 @@ void Image::Copy(const Image& Source, unsigned int DestX, unsigned int DestY, co
         }
     }
 
-    // The texture will need an update
-    myNeedTextureUpdate = true;
+    // The modified area of the texture will need an update
+    AddDirtyRect(IntRect(DestX, DestY, DestX + Width, DestY + Height));
 }
 
 
 ////////////////////////////////////////////////////////////
 /// Create the image from the current contents of the
-/// given window
+/// given render target
 ////////////////////////////////////////////////////////////
-bool Image::CopyScreen(RenderWindow& Window, const IntRect& SourceRect)
+bool Image::CopyScreen(RenderTarget& Target, const IntRect& SourceRect)
 {
+    CancelLoading();
+
     // Adjust the source rectangle
     IntRect SrcRect = SourceRect;
     if (SrcRect.GetWidth() == 0 || (SrcRect.GetHeight() == 0))
     {
         SrcRect.Left   = 0;
         SrcRect.Top    = 0;
-        SrcRect.Right  = Window.GetWidth();
-        SrcRect.Bottom = Window.GetHeight();
+        SrcRect.Right  = Target.GetWidth();
+        SrcRect.Bottom = Target.GetHeight();
     }
     else
     {
         if (SrcRect.Left   < 0) SrcRect.Left = 0;
         if (SrcRect.Top    < 0) SrcRect.Top  = 0;
-        if (SrcRect.Right  > static_cast<int>(Window.GetWidth()))  SrcRect.Right  = Window.GetWidth();
-        if (SrcRect.Bottom > static_cast<int>(Window.GetHeight())) SrcRect.Bottom = Window.GetHeight();
+        if (SrcRect.Right  > static_cast<int>(Target.GetWidth()))  SrcRect.Right  = Target.GetWidth();
+        if (SrcRect.Bottom > static_cast<int>(Target.GetHeight())) SrcRect.Bottom = Target.GetHeight();
     }
 
-    // Store the texture dimensions
+    // Store the texture dimensions and format
     myWidth  = SrcRect.GetWidth();
     myHeight = SrcRect.GetHeight();
+    SetFormat(PixelFormat::RGBA8);
 
     // We can then create the texture
-    if (Window.SetActive() && CreateTexture())
+    if (Target.Activate(true) && CreateTexture())
     {
-        GLint PreviousTexture;
-        GLCheck(glGetIntegerv(GL_TEXTURE_BINDING_2D, &PreviousTexture));
+        priv::TextureSaver Saver;
 
-        GLCheck(glBindTexture(GL_TEXTURE_2D, myTexture));
+        priv::GLStateCache::BindTexture(myTexture);
         GLCheck(glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, SrcRect.Left, SrcRect.Top, myWidth, myHeight));
 
-        GLCheck(glBindTexture(GL_TEXTURE_2D, PreviousTexture));
+        NotifyTextureModified();
 
-        myNeedTextureUpdate = false;
-        myNeedArrayUpdate = true;
+        return true;
+    }
+    else
+    {
+        Reset();
+        return false;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Resize the image, resampling its pixels with the given
+/// filter
+////////////////////////////////////////////////////////////
+bool Image::Resize(unsigned int Width, unsigned int Height, ResizeFilter::Mode Filter)
+{
+    CancelLoading();
+
+    if (!Width || !Height)
+    {
+        std::cerr << "Failed to resize image, invalid size (" << Width << "x" << Height << ")" << std::endl;
+        return false;
+    }
+
+    // The pixels are resampled from the array, which must be up-to-date
+    EnsureArrayUpdate();
+    if (myPixels.empty())
+    {
+        std::cerr << "Failed to resize image, it is empty" << std::endl;
+        return false;
+    }
 
+    std::vector<Uint8> Pixels(Width * Height * GetPixelSize(myFormat));
+    priv::ImageResampler::Resample(&myPixels[0], myWidth, myHeight, &Pixels[0], Width, Height, GetPixelSize(myFormat), Filter);
+
+    // Replace the pixels and recreate the texture
+    myPixels.swap(Pixels);
+    myWidth  = Width;
+    myHeight = Height;
+
+    if (CreateTexture())
+    {
         return true;
     }
     else
@@ -418,17 +831,48 @@ void Image::SetPixel(unsigned int X, unsigned int Y, const Color& Col)
         return;
     }
 
-    myPixels[X + Y * myWidth] = Col;
+    WritePixel(&myPixels[(X + Y * myWidth) * GetPixelSize(myFormat)], Col, myFormat);
 
-    // The texture will need to be updated
-    myNeedTextureUpdate = true;
+    // The pixel will need to be updated in the texture
+    AddDirtyRect(IntRect(X, Y, X + 1, Y + 1));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Change the pixels of a rectangle of the image at once
+////////////////////////////////////////////////////////////
+void Image::UpdatePixels(const Uint8* Pixels, const IntRect& Rect)
+{
+    // First check if the array of pixels needs to be updated
+    EnsureArrayUpdate();
+
+    // Check if the rectangle is whithin the image bounds
+    if (!Pixels || (Rect.Left < 0) || (Rect.Top < 0) || (Rect.Right > static_cast<int>(myWidth)) || (Rect.Bottom > static_cast<int>(myHeight)) ||
+        (Rect.GetWidth() <= 0) || (Rect.GetHeight() <= 0))
+    {
+        std::cerr << "Cannot update pixels (" << Rect.Left << "," << Rect.Top << "," << Rect.Right << "," << Rect.Bottom << ") for image "
+                  << "(width = " << myWidth << ", height = " << myHeight << ")" << std::endl;
+        return;
+    }
+
+    // Copy the pixels row by row
+    unsigned int PixelSize = GetPixelSize(myFormat);
+    std::size_t  Pitch     = Rect.GetWidth() * PixelSize;
+    for (int y = Rect.Top; y < Rect.Bottom; ++y)
+    {
+        memcpy(&myPixels[(Rect.Left + y * myWidth) * PixelSize], Pixels, Pitch);
+        Pixels += Pitch;
+    }
+
+    // The rectangle will need to be updated in the texture
+    AddDirtyRect(Rect);
 }
 
 
 ////////////////////////////////////////////////////////////
 /// Get a pixel from the image
 ////////////////////////////////////////////////////////////
-const Color& Image::GetPixel(unsigned int X, unsigned int Y) const
+Color Image::GetPixel(unsigned int X, unsigned int Y) const
 {
     // First check if the array of pixels needs to be updated
     EnsureArrayUpdate();
@@ -441,13 +885,14 @@ const Color& Image::GetPixel(unsigned int X, unsigned int Y) const
         return Color::Black;
     }
 
-    return myPixels[X + Y * myWidth];
+    return ReadPixel(&myPixels[(X + Y * myWidth) * GetPixelSize(myFormat)], myFormat);
 }
 
 
 ////////////////////////////////////////////////////////////
-/// Get a read-only pointer to the array of pixels (RGBA 8 bits integers components)
-/// Array size is GetWidth() x GetHeight() x 4
+/// Get a read-only pointer to the array of pixels (8 bits integers components,
+/// in the format of the image). Array size is GetWidth() x GetHeight() x 4
+/// for RGBA8 images, and GetWidth() x GetHeight() for A8 and L8 images.
 /// This pointer becomes invalid if you reload or resize the image
 ////////////////////////////////////////////////////////////
 const Uint8* Image::GetPixelsPtr() const
@@ -457,7 +902,7 @@ const Uint8* Image::GetPixelsPtr() const
 
     if (!myPixels.empty())
     {
-        return reinterpret_cast<const Uint8*>(&myPixels[0]);
+        return &myPixels[0];
     }
     else
     {
@@ -474,12 +919,13 @@ void Image::Bind() const
 {
     // First check if the texture needs to be updated
     EnsureTextureUpdate();
+    EnsureMipmapsUpdate();
 
     // Bind it
     if (myTexture)
     {
-        GLCheck(glEnable(GL_TEXTURE_2D));
-        GLCheck(glBindTexture(GL_TEXTURE_2D, myTexture));
+        priv::GLStateCache::EnableTexture(true);
+        priv::GLStateCache::BindTexture(myTexture);
     }
 }
 
@@ -489,23 +935,48 @@ void Image::Bind() const
 ////////////////////////////////////////////////////////////
 void Image::SetSmooth(bool Smooth)
 {
-    if (Smooth != myIsSmooth)
+    SetFilter(Smooth ? TextureFilter::Linear : TextureFilter::Nearest);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Change the filter used to sample the image
+////////////////////////////////////////////////////////////
+void Image::SetFilter(TextureFilter::Mode Filter)
+{
+    if (Filter != myFilter)
     {
-        myIsSmooth = Smooth;
+        myFilter = Filter;
+
+        // The mipmaps are only kept for the trilinear filter
+        if (myFilter != TextureFilter::Trilinear)
+        {
+            myMipmaps.clear();
+            myNeedMipmapsUpdate = false;
+        }
 
         if (myTexture)
         {
             // Make sure we have a valid context
             priv::GraphicsContext Ctx;
 
-            GLint PreviousTexture;
-            GLCheck(glGetIntegerv(GL_TEXTURE_BINDING_2D, &PreviousTexture));
+            // The mipmaps will be built with the next texture update, or when the image
+            // is next bound if its pixels are only in the texture
+            if (myFilter == TextureFilter::Trilinear)
+            {
+                if (myNeedArrayUpdate)
+                    myNeedMipmapsUpdate = true;
+                else
+                    AddDirtyRect(IntRect(0, 0, myWidth, myHeight));
+            }
 
-            GLCheck(glBindTexture(GL_TEXTURE_2D, myTexture));
-            GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, myIsSmooth ? GL_LINEAR : GL_NEAREST));
-            GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, myIsSmooth ? GL_LINEAR : GL_NEAREST));
+            priv::TextureSaver Saver;
 
-            GLCheck(glBindTexture(GL_TEXTURE_2D, PreviousTexture));
+            GLint MinFilter, MagFilter;
+            GetGLFilters(myFilter, MinFilter, MagFilter);
+            priv::GLStateCache::BindTexture(myTexture);
+            GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, MagFilter));
+            GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, MinFilter));
         }
     }
 }
@@ -529,12 +1000,30 @@ unsigned int Image::GetHeight() const
 }
 
 
+////////////////////////////////////////////////////////////
+/// Return the format of the pixels of the image
+////////////////////////////////////////////////////////////
+PixelFormat::Format Image::GetFormat() const
+{
+    return myFormat;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Tells whether the smooth filtering is enabled or not
 ////////////////////////////////////////////////////////////
 bool Image::IsSmooth() const
 {
-    return myIsSmooth;
+    return myFilter != TextureFilter::Nearest;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the filter used to sample the image
+////////////////////////////////////////////////////////////
+TextureFilter::Mode Image::GetFilter() const
+{
+    return myFilter;
 }
 
 
@@ -588,13 +1077,18 @@ Image& Image::operator =(const Image& Other)
 
     std::swap(myWidth,             Temp.myWidth);
     std::swap(myHeight,            Temp.myHeight);
+    std::swap(myFormat,            Temp.myFormat);
     std::swap(myTextureWidth,      Temp.myTextureWidth);
     std::swap(myTextureHeight,     Temp.myTextureHeight);
     std::swap(myTexture,           Temp.myTexture);
-    std::swap(myIsSmooth,          Temp.myIsSmooth);
+    std::swap(myFilter,            Temp.myFilter);
     std::swap(myNeedArrayUpdate,   Temp.myNeedArrayUpdate);
     std::swap(myNeedTextureUpdate, Temp.myNeedTextureUpdate);
+    std::swap(myNeedMipmapsUpdate, Temp.myNeedMipmapsUpdate);
+    std::swap(myAsyncRequest,      Temp.myAsyncRequest);
+    std::swap(myDirtyRect,         Temp.myDirtyRect);
     myPixels.swap(Temp.myPixels);
+    myMipmaps.swap(Temp.myMipmaps);
 
     return *this;
 }
@@ -636,28 +1130,70 @@ bool Image::CreateTexture()
     // Create the OpenGL texture
     if (!myTexture)
     {
-        GLint PreviousTexture;
-        GLCheck(glGetIntegerv(GL_TEXTURE_BINDING_2D, &PreviousTexture));
+        priv::TextureSaver Saver;
+
+        GLint  GLInternalFormat;
+        GLenum GLPixelFormat;
+        GetGLFormat(myFormat, GLInternalFormat, GLPixelFormat);
 
         GLuint Texture = 0;
         GLCheck(glGenTextures(1, &Texture));
-        GLCheck(glBindTexture(GL_TEXTURE_2D, Texture));
-        GLCheck(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, myTextureWidth, myTextureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL));
+        priv::GLStateCache::BindTexture(Texture);
+        GLCheck(glTexImage2D(GL_TEXTURE_2D, 0, GLInternalFormat, myTextureWidth, myTextureHeight, 0, GLPixelFormat, GL_UNSIGNED_BYTE, NULL));
         GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP));
         GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP));
-        GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, myIsSmooth ? GL_LINEAR : GL_NEAREST));
-        GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, myIsSmooth ? GL_LINEAR : GL_NEAREST));
+        GLint MinFilter, MagFilter;
+        GetGLFilters(myFilter, MinFilter, MagFilter);
+        GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, MagFilter));
+        GLCheck(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, MinFilter));
         myTexture = static_cast<unsigned int>(Texture);
-
-        GLCheck(glBindTexture(GL_TEXTURE_2D, PreviousTexture));
     }
 
-    myNeedTextureUpdate = true;
+    // The size of the image may have changed : the mipmaps will be rebuilt
+    myMipmaps.clear();
+    AddDirtyRect(IntRect(0, 0, myWidth, myHeight));
 
     return true;
 }
 
 
+////////////////////////////////////////////////////////////
+/// Change the format of the pixels, destroying the OpenGL
+/// texture if it doesn't match the new format
+////////////////////////////////////////////////////////////
+void Image::SetFormat(PixelFormat::Format Format)
+{
+    if (Format != myFormat)
+    {
+        DestroyTexture();
+        myFormat = Format;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Add an area to the part of the pixels array which must
+/// be copied to the texture
+////////////////////////////////////////////////////////////
+void Image::AddDirtyRect(const IntRect& Rect)
+{
+    if (myNeedTextureUpdate)
+    {
+        // Merge with the area already modified
+        myDirtyRect.Left   = std::min(myDirtyRect.Left,   Rect.Left);
+        myDirtyRect.Top    = std::min(myDirtyRect.Top,    Rect.Top);
+        myDirtyRect.Right  = std::max(myDirtyRect.Right,  Rect.Right);
+        myDirtyRect.Bottom = std::max(myDirtyRect.Bottom, Rect.Bottom);
+    }
+    else
+    {
+        myDirtyRect = Rect;
+    }
+
+    myNeedTextureUpdate = true;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Make sure the texture in video memory is updated with the
 /// array of pixels
@@ -669,14 +1205,43 @@ void Image::EnsureTextureUpdate() const
         // Copy the pixels
         if (myTexture && !myPixels.empty())
         {
-            GLint PreviousTexture;
-            GLCheck(glGetIntegerv(GL_TEXTURE_BINDING_2D, &PreviousTexture));
+            priv::TextureSaver Saver;
+
+            GLint  GLInternalFormat;
+            GLenum GLPixelFormat;
+            GetGLFormat(myFormat, GLInternalFormat, GLPixelFormat);
+
+            // Rows of single-component pixels are not aligned on 4 bytes
+            if (GetPixelSize(myFormat) != 4)
+                GLCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+            // Only the modified area is read from the pixels array
+            bool Partial = (myDirtyRect.GetWidth() != static_cast<int>(myWidth)) || (myDirtyRect.GetHeight() != static_cast<int>(myHeight));
+            if (Partial)
+            {
+                GLCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, myWidth));
+                GLCheck(glPixelStorei(GL_UNPACK_SKIP_PIXELS, myDirtyRect.Left));
+                GLCheck(glPixelStorei(GL_UNPACK_SKIP_ROWS, myDirtyRect.Top));
+            }
 
             // Update the texture with the pixels array in RAM
-            GLCheck(glBindTexture(GL_TEXTURE_2D, myTexture));
-            GLCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, myWidth, myHeight, GL_RGBA, GL_UNSIGNED_BYTE, &myPixels[0]));
+            priv::GLStateCache::BindTexture(myTexture);
+            GLCheck(glTexSubImage2D(GL_TEXTURE_2D, 0, myDirtyRect.Left, myDirtyRect.Top, myDirtyRect.GetWidth(), myDirtyRect.GetHeight(),
+                                    GLPixelFormat, GL_UNSIGNED_BYTE, &myPixels[0]));
+
+            if (Partial)
+            {
+                GLCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+                GLCheck(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+                GLCheck(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+            }
+
+            // Propagate the modified area to the mipmaps
+            if (myFilter == TextureFilter::Trilinear)
+                UpdateMipmaps(myDirtyRect);
 
-            GLCheck(glBindTexture(GL_TEXTURE_2D, PreviousTexture));
+            if (GetPixelSize(myFormat) != 4)
+                GLCheck(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
         }
 
         myNeedTextureUpdate = false;
@@ -684,6 +1249,112 @@ void Image::EnsureTextureUpdate() const
 }
 
 
+////////////////////////////////////////////////////////////
+/// Update an area of the mipmaps from the pixels array, and
+/// copy it to the texture
+////////////////////////////////////////////////////////////
+void Image::UpdateMipmaps(const IntRect& Rect) const
+{
+    GLint  GLInternalFormat;
+    GLenum GLPixelFormat;
+    GetGLFormat(myFormat, GLInternalFormat, GLPixelFormat);
+    unsigned int PixelSize = GetPixelSize(myFormat);
+
+    // Create the mipmaps, down to 1x1, in RAM and in the texture
+    unsigned int Left   = Rect.Left;
+    unsigned int Top    = Rect.Top;
+    unsigned int Right  = Rect.Right;
+    unsigned int Bottom = Rect.Bottom;
+    if (myMipmaps.empty())
+    {
+        unsigned int Width  = myWidth;
+        unsigned int Height = myHeight;
+        for (unsigned int Level = 1; (myTextureWidth >> (Level - 1) > 1) || (myTextureHeight >> (Level - 1) > 1); ++Level)
+        {
+            Width  = GetMipmapSize(Width,  myTextureWidth,  Level);
+            Height = GetMipmapSize(Height, myTextureHeight, Level);
+            myMipmaps.push_back(std::vector<Uint8>(Width * Height * PixelSize));
+
+            unsigned int TextureWidth  = std::max(myTextureWidth  >> Level, 1u);
+            unsigned int TextureHeight = std::max(myTextureHeight >> Level, 1u);
+            GLCheck(glTexImage2D(GL_TEXTURE_2D, Level, GLInternalFormat, TextureWidth, TextureHeight, 0, GLPixelFormat, GL_UNSIGNED_BYTE, NULL));
+        }
+
+        // New mipmaps must be entirely computed
+        myNeedMipmapsUpdate = false;
+        Left   = 0;
+        Top    = 0;
+        Right  = myWidth;
+        Bottom = myHeight;
+    }
+
+    // Compute each level from the previous one ; only the area covering the
+    // modified pixels has to be computed
+    const Uint8* Src       = &myPixels[0];
+    unsigned int SrcWidth  = myWidth;
+    unsigned int SrcHeight = myHeight;
+    for (unsigned int Level = 1; Level <= myMipmaps.size(); ++Level)
+    {
+        std::vector<Uint8>& Mipmap = myMipmaps[Level - 1];
+        unsigned int Width  = GetMipmapSize(SrcWidth,  myTextureWidth,  Level);
+        unsigned int Height = GetMipmapSize(SrcHeight, myTextureHeight, Level);
+        Left   = std::min(Left / 2, Width - 1);
+        Top    = std::min(Top / 2,  Height - 1);
+        Right  = std::max(std::min((Right + 1) / 2,  Width),  Left + 1);
+        Bottom = std::max(std::min((Bottom + 1) / 2, Height), Top + 1);
+
+        MipmapJob Area = {Src, SrcWidth, SrcHeight, &Mipmap[0], Width, PixelSize, Left, Top, Right, Bottom};
+        ComputeMipmapParallel(Area);
+
+        // Copy the area to the texture
+        GLCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, Width));
+        GLCheck(glPixelStorei(GL_UNPACK_SKIP_PIXELS, Left));
+        GLCheck(glPixelStorei(GL_UNPACK_SKIP_ROWS, Top));
+        GLCheck(glTexSubImage2D(GL_TEXTURE_2D, Level, Left, Top, Right - Left, Bottom - Top, GLPixelFormat, GL_UNSIGNED_BYTE, &Mipmap[0]));
+
+        Src       = &Mipmap[0];
+        SrcWidth  = Width;
+        SrcHeight = Height;
+    }
+
+    GLCheck(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+    GLCheck(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+    GLCheck(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Make sure the mipmaps are updated after OpenGL has
+/// written into the texture
+////////////////////////////////////////////////////////////
+void Image::EnsureMipmapsUpdate() const
+{
+    if (myNeedMipmapsUpdate)
+    {
+        if (myTexture)
+        {
+            priv::TextureSaver Saver;
+            priv::GLStateCache::BindTexture(myTexture);
+
+            if (GLEW_EXT_framebuffer_object)
+            {
+                // Let the GPU build the mipmaps from the texture, which avoids reading it back
+                GLCheck(glGenerateMipmapEXT(GL_TEXTURE_2D));
+            }
+            else
+            {
+                // Read the texture back and build the mipmaps on the CPU
+                EnsureArrayUpdate();
+                priv::GLStateCache::BindTexture(myTexture);
+                UpdateMipmaps(IntRect(0, 0, myWidth, myHeight));
+            }
+        }
+
+        myNeedMipmapsUpdate = false;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Make sure the array of pixels is updated with the
 /// texture in video memory
@@ -693,48 +1364,73 @@ void Image::EnsureArrayUpdate() const
     if (myNeedArrayUpdate)
     {
         // Save the previous texture
-        GLint PreviousTexture;
-        GLCheck(glGetIntegerv(GL_TEXTURE_BINDING_2D, &PreviousTexture));
+        priv::TextureSaver Saver;
+
+        GLint  GLInternalFormat;
+        GLenum GLPixelFormat;
+        GetGLFormat(myFormat, GLInternalFormat, GLPixelFormat);
+        unsigned int PixelSize = GetPixelSize(myFormat);
 
         // Resize the destination array of pixels
-        myPixels.resize(myWidth * myHeight);
+        myPixels.resize(myWidth * myHeight * PixelSize);
+
+        // Rows of single-component pixels are not aligned on 4 bytes
+        if (PixelSize != 4)
+            GLCheck(glPixelStorei(GL_PACK_ALIGNMENT, 1));
 
         if ((myWidth == myTextureWidth) && (myHeight == myTextureHeight))
         {
             // Texture and array have the same size, we can use a direct copy
 
             // Copy pixels from texture to array
-            GLCheck(glBindTexture(GL_TEXTURE_2D, myTexture));
-            GLCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &myPixels[0]));
+            priv::GLStateCache::BindTexture(myTexture);
+            GLCheck(glGetTexImage(GL_TEXTURE_2D, 0, GLPixelFormat, GL_UNSIGNED_BYTE, &myPixels[0]));
         }
         else
         {
             // Texture and array don't have the same size, we have to use a slower algorithm
 
             // All the pixels will first be copied to a temporary array
-            std::vector<Color> AllPixels(myTextureWidth * myTextureHeight);
-            GLCheck(glBindTexture(GL_TEXTURE_2D, myTexture));
-            GLCheck(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, &AllPixels[0]));
+            std::vector<Uint8> AllPixels(myTextureWidth * myTextureHeight * PixelSize);
+            priv::GLStateCache::BindTexture(myTexture);
+            GLCheck(glGetTexImage(GL_TEXTURE_2D, 0, GLPixelFormat, GL_UNSIGNED_BYTE, &AllPixels[0]));
 
             // The we copy the useful pixels from the temporary array to the final one
-            const Color* Src = &AllPixels[0];
-            Color* Dst = &myPixels[0];
+            const Uint8* Src = &AllPixels[0];
+            Uint8* Dst = &myPixels[0];
             for (unsigned int i = 0; i < myHeight; ++i)
             {
-                std::copy(Src, Src + myWidth, Dst);
-                Src += myTextureWidth;
-                Dst += myWidth;
+                std::copy(Src, Src + myWidth * PixelSize, Dst);
+                Src += myTextureWidth * PixelSize;
+                Dst += myWidth * PixelSize;
             }
         }
 
-        // Restore the previous texture
-        GLCheck(glBindTexture(GL_TEXTURE_2D, PreviousTexture));
+        if (PixelSize != 4)
+            GLCheck(glPixelStorei(GL_PACK_ALIGNMENT, 4));
 
         myNeedArrayUpdate = false;
     }
 }
 
 
+////////////////////////////////////////////////////////////
+/// Tell the image that OpenGL has written into its texture
+////////////////////////////////////////////////////////////
+void Image::NotifyTextureModified()
+{
+    myNeedTextureUpdate = false;
+    myNeedArrayUpdate   = true;
+
+    // The mipmaps no longer match the texture ; they are rebuilt when the image is next bound
+    if (myFilter == TextureFilter::Trilinear)
+    {
+        myMipmaps.clear();
+        myNeedMipmapsUpdate = true;
+    }
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Reset the image attributes
 ////////////////////////////////////////////////////////////
@@ -744,13 +1440,29 @@ void Image::Reset()
 
     myWidth             = 0;
     myHeight            = 0;
+    myFormat            = PixelFormat::RGBA8;
     myTextureWidth      = 0;
     myTextureHeight     = 0;
     myTexture           = 0;
-    myIsSmooth          = true;
+    myFilter            = TextureFilter::Linear;
     myNeedTextureUpdate = false;
     myNeedArrayUpdate   = false;
+    myNeedMipmapsUpdate = false;
     myPixels.clear();
+    myMipmaps.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Abandon the loading started with LoadFromFileAsync, if any
+////////////////////////////////////////////////////////////
+void Image::CancelLoading()
+{
+    if (myAsyncRequest)
+    {
+        priv::ImageLoader::GetInstance().CancelAsync(myAsyncRequest);
+        myAsyncRequest = NULL;
+    }
 }
 
 
@@ -767,9 +1479,12 @@ void Image::DestroyTexture()
 
         GLuint Texture = static_cast<GLuint>(myTexture);
         GLCheck(glDeleteTextures(1, &Texture));
+        priv::GLStateCache::ForgetTexture(Texture);
         myTexture           = 0;
+        myMipmaps.clear();
         myNeedTextureUpdate = false;
         myNeedArrayUpdate   = false;
+        myNeedMipmapsUpdate = false;
     }
 }
 
@@ -26,18 +26,67 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/ImageLoader.hpp>
+#include <SFML/Graphics/ImageResampler.hpp>
 extern "C"
 {
     #include <SFML/Graphics/libjpeg/jpeglib.h>
     #include <SFML/Graphics/libjpeg/jerror.h>
 }
 #include <SFML/Graphics/libpng/png.h>
+#include <SFML/Graphics/zlib/zlib.h>
 #include <SFML/Graphics/SOIL/SOIL.h>
+#include <SFML/Graphics/PixelKernels.hpp>
+#include <SFML/System/Lock.hpp>
+#include <algorithm>
 #include <iostream>
+#include <string.h>
+
+#if defined(SFML_SYSTEM_WINDOWS)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 
 namespace
 {
+    ////////////////////////////////////////////////////////////
+    // Layout of the image cache files : a header made of the magic
+    // number and 5 little-endian 32 bits values (version, width,
+    // height, pixel format, compression), then the stored size of
+    // the pixels followed by the pixels
+    ////////////////////////////////////////////////////////////
+    const char         CacheMagic[4]   = {'S', 'F', 'I', 'C'};
+    const sf::Uint32   CacheVersion    = 2;
+    const std::size_t  CacheHeaderSize = 24;
+    const sf::Uint32   CacheMaxSize    = 16384; // Largest width / height accepted ; keeps the size of the pixels below 1 GB, even on 32 bits systems
+    enum CacheCompression {CacheRaw, CacheZlib};
+
+    ////////////////////////////////////////////////////////////
+    /// Read / write a little-endian 32 bits value
+    ////////////////////////////////////////////////////////////
+    sf::Uint32 ReadUint32(const unsigned char* Data)
+    {
+        return Data[0] | (Data[1] << 8) | (Data[2] << 16) | (static_cast<sf::Uint32>(Data[3]) << 24);
+    }
+
+    bool WriteUint32(FILE* File, sf::Uint32 Value)
+    {
+        unsigned char Bytes[4] = {static_cast<unsigned char>(Value), static_cast<unsigned char>(Value >> 8), static_cast<unsigned char>(Value >> 16), static_cast<unsigned char>(Value >> 24)};
+        return fwrite(Bytes, 4, 1, File) == 1;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Get the number of bytes of a pixel in a given format
+    ////////////////////////////////////////////////////////////
+    std::size_t GetPixelSize(sf::PixelFormat::Format Format)
+    {
+        return Format == sf::PixelFormat::RGBA8 ? 4 : 1;
+    }
+
     ////////////////////////////////////////////////////////////
     /// Error callback for PNG writing
     ////////////////////////////////////////////////////////////
@@ -46,6 +95,238 @@ namespace
         std::cerr << "Failed to write PNG image. Reason : " << Message << std::endl;
         longjmp(Png->jmpbuf, 1);
     }
+
+    ////////////////////////////////////////////////////////////
+    /// Error callback for PNG reading ; the message is stored
+    /// in the string passed as error pointer
+    ////////////////////////////////////////////////////////////
+    void PngReadErrorHandler(png_structp Png, png_const_charp Message)
+    {
+        *static_cast<std::string*>(png_get_error_ptr(Png)) = Message;
+        longjmp(Png->jmpbuf, 1);
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Warning callback for PNG reading (warnings are ignored)
+    ////////////////////////////////////////////////////////////
+    void PngWarningHandler(png_structp, png_const_charp)
+    {
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Position of the PNG reader in the file data
+    ////////////////////////////////////////////////////////////
+    struct PngSource
+    {
+        const unsigned char* Data;
+        std::size_t          Size;
+        std::size_t          Offset;
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Read callback feeding the PNG reader from memory
+    ////////////////////////////////////////////////////////////
+    void PngReadData(png_structp Png, png_bytep Data, png_size_t Length)
+    {
+        PngSource* Source = static_cast<PngSource*>(png_get_io_ptr(Png));
+        if (Length > Source->Size - Source->Offset)
+            png_error(Png, "unexpected end of file");
+
+        memcpy(Data, Source->Data + Source->Offset, Length);
+        Source->Offset += Length;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Error manager for JPEG reading, which returns to the
+    /// reader instead of exiting the program
+    ////////////////////////////////////////////////////////////
+    struct JpegErrorManager
+    {
+        jpeg_error_mgr Base;
+        jmp_buf        Jump;
+        char           Message[JMSG_LENGTH_MAX];
+    };
+
+    void JpegErrorExit(j_common_ptr Info)
+    {
+        JpegErrorManager* Manager = reinterpret_cast<JpegErrorManager*>(Info->err);
+        Manager->Base.format_message(Info, Manager->Message);
+        longjmp(Manager->Jump, 1);
+    }
+
+    void JpegOutputMessage(j_common_ptr)
+    {
+        // Warnings are ignored
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Source manager feeding the JPEG reader from memory ; the
+    /// whole data is given at once, so there's nothing to refill
+    ////////////////////////////////////////////////////////////
+    void JpegInitSource(j_decompress_ptr)
+    {
+    }
+
+    boolean JpegFillInputBuffer(j_decompress_ptr Info)
+    {
+        // Premature end of file : insert a fake EOI marker, as the standard sources do
+        static const JOCTET EndOfImage[2] = {0xFF, JPEG_EOI};
+        WARNMS(Info, JWRN_JPEG_EOF);
+        Info->src->next_input_byte = EndOfImage;
+        Info->src->bytes_in_buffer = 2;
+
+        return TRUE;
+    }
+
+    void JpegSkipInputData(j_decompress_ptr Info, long NbBytes)
+    {
+        if (NbBytes <= 0)
+            return;
+
+        if (static_cast<std::size_t>(NbBytes) > Info->src->bytes_in_buffer)
+        {
+            JpegFillInputBuffer(Info);
+        }
+        else
+        {
+            Info->src->next_input_byte += NbBytes;
+            Info->src->bytes_in_buffer -= NbBytes;
+        }
+    }
+
+    void JpegTermSource(j_decompress_ptr)
+    {
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Compute the size of an image fitted into a maximum size,
+    /// keeping its aspect ratio and never enlarging it ; a
+    /// maximum of 0 means no limit
+    ////////////////////////////////////////////////////////////
+    void FitSize(unsigned int Width, unsigned int Height, unsigned int MaxWidth, unsigned int MaxHeight, unsigned int& FitWidth, unsigned int& FitHeight)
+    {
+        double Scale = 1.0;
+        if ((MaxWidth > 0) && (Width > MaxWidth))
+            Scale = static_cast<double>(MaxWidth) / Width;
+        if ((MaxHeight > 0) && (Height * Scale > MaxHeight))
+            Scale = static_cast<double>(MaxHeight) / Height;
+
+        FitWidth  = std::max(static_cast<unsigned int>(Width  * Scale + 0.5), 1u);
+        FitHeight = std::max(static_cast<unsigned int>(Height * Scale + 0.5), 1u);
+        FitWidth  = std::min(FitWidth,  Width);
+        FitHeight = std::min(FitHeight, Height);
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Reduce pixels to a smaller size, if they're bigger
+    ////////////////////////////////////////////////////////////
+    void Downscale(std::vector<sf::Uint8>& Pixels, unsigned int& Width, unsigned int& Height, unsigned int NewWidth, unsigned int NewHeight, sf::PixelFormat::Format Format)
+    {
+        if ((NewWidth < Width) || (NewHeight < Height))
+        {
+            NewWidth  = std::min(NewWidth, Width);
+            NewHeight = std::min(NewHeight, Height);
+
+            // The box filter gives a true area average, which is the best choice for reductions
+            unsigned int           NbChannels = (Format == sf::PixelFormat::RGBA8) ? 4 : 1;
+            std::vector<sf::Uint8> Reduced(NewWidth * NewHeight * NbChannels);
+            sf::priv::ImageResampler::Resample(&Pixels[0], Width, Height, &Reduced[0], NewWidth, NewHeight, NbChannels, sf::ResizeFilter::Box);
+
+            Pixels.swap(Reduced);
+            Width  = NewWidth;
+            Height = NewHeight;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Read-only mapping of a file in memory
+    ////////////////////////////////////////////////////////////
+    class MappedFile
+    {
+    public :
+
+        MappedFile(const std::string& Filename) :
+        myData(NULL),
+        mySize(0)
+        {
+        #if defined(SFML_SYSTEM_WINDOWS)
+
+            myMapping = NULL;
+            HANDLE File = CreateFileA(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (File == INVALID_HANDLE_VALUE)
+                return;
+
+            DWORD Size = GetFileSize(File, NULL);
+            if ((Size != INVALID_FILE_SIZE) && (Size > 0))
+                myMapping = CreateFileMappingA(File, NULL, PAGE_READONLY, 0, 0, NULL);
+            CloseHandle(File);
+
+            if (myMapping)
+            {
+                myData = static_cast<const unsigned char*>(MapViewOfFile(myMapping, FILE_MAP_READ, 0, 0, 0));
+                if (myData)
+                    mySize = Size;
+            }
+
+        #else
+
+            int File = open(Filename.c_str(), O_RDONLY);
+            if (File < 0)
+                return;
+
+            struct stat Infos;
+            if ((fstat(File, &Infos) == 0) && (Infos.st_size > 0))
+            {
+                void* Data = mmap(NULL, Infos.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+                if (Data != MAP_FAILED)
+                {
+                    myData = static_cast<const unsigned char*>(Data);
+                    mySize = Infos.st_size;
+                }
+            }
+            close(File);
+
+        #endif
+        }
+
+        ~MappedFile()
+        {
+        #if defined(SFML_SYSTEM_WINDOWS)
+
+            if (myData)
+                UnmapViewOfFile(myData);
+            if (myMapping)
+                CloseHandle(myMapping);
+
+        #else
+
+            if (myData)
+                munmap(const_cast<unsigned char*>(myData), mySize);
+
+        #endif
+        }
+
+        const unsigned char* GetData() const
+        {
+            return myData;
+        }
+
+        std::size_t GetSize() const
+        {
+            return mySize;
+        }
+
+    private :
+
+        MappedFile(const MappedFile&);
+        MappedFile& operator =(const MappedFile&);
+
+        const unsigned char* myData;
+        std::size_t          mySize;
+    #if defined(SFML_SYSTEM_WINDOWS)
+        HANDLE               myMapping;
+    #endif
+    };
 }
 
 
@@ -69,7 +350,12 @@ ImageLoader& ImageLoader::GetInstance()
 ////////////////////////////////////////////////////////////
 ImageLoader::ImageLoader()
 {
-    // Nothing to do
+    for (int i = 0; i < NbWorkers; ++i)
+    {
+        myWorkers[i].Owner   = this;
+        myWorkers[i].Handle  = NULL;
+        myWorkers[i].Running = false;
+    }
 }
 
 
@@ -78,90 +364,83 @@ ImageLoader::ImageLoader()
 ////////////////////////////////////////////////////////////
 ImageLoader::~ImageLoader()
 {
-    // Nothing to do
+    // Fail the requests that are still waiting, so that the workers stop
+    {
+        Lock ScopedLock(myMutex);
+        for (std::deque<AsyncImageRequest*>::iterator i = myRequests.begin(); i != myRequests.end(); ++i)
+        {
+            if ((*i)->Cancelled)
+            {
+                delete *i;
+            }
+            else
+            {
+                (*i)->Success = false;
+                (*i)->Done    = true;
+            }
+        }
+        myRequests.clear();
+    }
+
+    // Wait for the workers to finish their current request
+    for (int i = 0; i < NbWorkers; ++i)
+        delete myWorkers[i].Handle;
 }
 
 
 ////////////////////////////////////////////////////////////
 /// Load pixels from an image file
 ////////////////////////////////////////////////////////////
-bool ImageLoader::LoadImageFromFile(const std::string& Filename, std::vector<Color>& Pixels, unsigned int& Width, unsigned int& Height)
+bool ImageLoader::LoadImageFromFile(const std::string& Filename, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format, unsigned int MaxWidth, unsigned int MaxHeight)
 {
     // Clear the array (just in case)
     Pixels.clear();
 
-    // Load the image and get a pointer to the pixels in memory
-    int ImgWidth, ImgHeight, ImgChannels;
-    unsigned char* PixelsPtr = SOIL_load_image(Filename.c_str(), &ImgWidth, &ImgHeight, &ImgChannels, SOIL_LOAD_RGBA);
-
-    if (PixelsPtr)
+    // Map the file in memory, so that the decoders read it directly
+    MappedFile File(Filename);
+    if (!File.GetData())
     {
-        // Assign the image properties
-        Width  = ImgWidth;
-        Height = ImgHeight;
-
-        // Copy the loaded pixels to the pixel buffer
-        Pixels.resize(Width * Height);
-        memcpy(&Pixels[0], PixelsPtr, Width * Height * 4);
-
-        // Free the loaded pixels (they are now in our own pixel buffer)
-        SOIL_free_image_data(PixelsPtr);
-
-        return true;
+        std::cerr << "Failed to load image \"" << Filename << "\". Reason : cannot open file" << std::endl;
+        return false;
     }
-    else
-    {
-        // Error, failed to load the image
-        std::cerr << "Failed to load image \"" << Filename << "\". Reason : " << SOIL_last_result() << std::endl;
 
+    // Decode the image
+    std::string Error;
+    if (!DecodeImage(File.GetData(), File.GetSize(), Pixels, Width, Height, Format, Error, MaxWidth, MaxHeight))
+    {
+        std::cerr << "Failed to load image \"" << Filename << "\". Reason : " << Error << std::endl;
         return false;
     }
+
+    return true;
 }
 
 
 ////////////////////////////////////////////////////////////
 /// Load pixels from an image file in memory
 ////////////////////////////////////////////////////////////
-bool ImageLoader::LoadImageFromMemory(const char* Data, std::size_t SizeInBytes, std::vector<Color>& Pixels, unsigned int& Width, unsigned int& Height)
+bool ImageLoader::LoadImageFromMemory(const char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format)
 {
     // Clear the array (just in case)
     Pixels.clear();
 
-    // Load the image and get a pointer to the pixels in memory
+    // Decode the image
+    std::string Error;
     const unsigned char* Buffer = reinterpret_cast<const unsigned char*>(Data);
-    int Size = static_cast<int>(SizeInBytes);
-    int ImgWidth, ImgHeight, ImgChannels;
-    unsigned char* PixelsPtr = SOIL_load_image_from_memory(Buffer, Size, &ImgWidth, &ImgHeight, &ImgChannels, SOIL_LOAD_RGBA);
-
-    if (PixelsPtr)
-    {
-        // Assign the image properties
-        Width  = ImgWidth;
-        Height = ImgHeight;
-
-        // Copy the loaded pixels to the pixel buffer
-        Pixels.resize(Width * Height);
-        memcpy(&Pixels[0], PixelsPtr, Width * Height * 4);
-
-        // Free the loaded pixels (they are now in our own pixel buffer)
-        SOIL_free_image_data(PixelsPtr);
-
-        return true;
-    }
-    else
+    if (!DecodeImage(Buffer, SizeInBytes, Pixels, Width, Height, Format, Error))
     {
-        // Error, failed to load the image
-        std::cerr << "Failed to load image from memory. Reason : " << SOIL_last_result() << std::endl;
-
+        std::cerr << "Failed to load image from memory. Reason : " << Error << std::endl;
         return false;
     }
+
+    return true;
 }
 
 
 ////////////////////////////////////////////////////////////
 /// Save pixels to an image file
 ////////////////////////////////////////////////////////////
-bool ImageLoader::SaveImageToFile(const std::string& Filename, const std::vector<Color>& Pixels, unsigned int Width, unsigned int Height)
+bool ImageLoader::SaveImageToFile(const std::string& Filename, const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height)
 {
     // Deduce the image type from its extension
     int Type = -1;
@@ -197,10 +476,400 @@ bool ImageLoader::SaveImageToFile(const std::string& Filename, const std::vector
 }
 
 
+////////////////////////////////////////////////////////////
+/// Save pixels to an image cache file
+////////////////////////////////////////////////////////////
+bool ImageLoader::SaveImageToCache(const std::string& Filename, const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height, PixelFormat::Format Format, bool Compress)
+{
+    // Compress the pixels if requested
+    std::vector<Uint8> Compressed;
+    if (Compress)
+    {
+        uLongf CompressedSize = compressBound(static_cast<uLong>(Pixels.size()));
+        Compressed.resize(CompressedSize);
+        if (compress(&Compressed[0], &CompressedSize, &Pixels[0], static_cast<uLong>(Pixels.size())) != Z_OK)
+        {
+            std::cerr << "Failed to save image cache \"" << Filename << "\". Reason : compression failed" << std::endl;
+            return false;
+        }
+        Compressed.resize(CompressedSize);
+    }
+    const std::vector<Uint8>& Stored = Compress ? Compressed : Pixels;
+
+    // Open the file to write in
+    FILE* File = fopen(Filename.c_str(), "wb");
+    if (!File)
+    {
+        std::cerr << "Failed to save image cache \"" << Filename << "\". Reason : cannot open file" << std::endl;
+        return false;
+    }
+
+    // Write the header, then the pixels
+    bool Success = (fwrite(CacheMagic, sizeof(CacheMagic), 1, File) == 1) &&
+                   WriteUint32(File, CacheVersion)                       &&
+                   WriteUint32(File, Width)                              &&
+                   WriteUint32(File, Height)                             &&
+                   WriteUint32(File, Format)                             &&
+                   WriteUint32(File, Compress ? CacheZlib : CacheRaw)    &&
+                   WriteUint32(File, static_cast<Uint32>(Stored.size())) &&
+                   (fwrite(&Stored[0], Stored.size(), 1, File) == 1);
+    fclose(File);
+
+    if (!Success)
+        std::cerr << "Failed to save image cache \"" << Filename << "\". Reason : cannot write file" << std::endl;
+
+    return Success;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Start loading an image file in the background
+////////////////////////////////////////////////////////////
+AsyncImageRequest* ImageLoader::LoadImageFromFileAsync(const std::string& Filename)
+{
+    AsyncImageRequest* Request = new AsyncImageRequest;
+    Request->Filename  = Filename;
+    Request->Width     = 0;
+    Request->Height    = 0;
+    Request->Format    = PixelFormat::RGBA8;
+    Request->Success   = false;
+    Request->Done      = false;
+    Request->Cancelled = false;
+
+    Lock ScopedLock(myMutex);
+    myRequests.push_back(Request);
+
+    // Wake up an idle worker, if any
+    for (int i = 0; i < NbWorkers; ++i)
+    {
+        Worker& CurWorker = myWorkers[i];
+        if (!CurWorker.Running)
+        {
+            if (!CurWorker.Handle)
+                CurWorker.Handle = new Thread(&ImageLoader::RunWorker, &CurWorker);
+
+            CurWorker.Running = true;
+            CurWorker.Handle->Launch();
+            break;
+        }
+    }
+
+    return Request;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the result of a background loading, if it's finished
+////////////////////////////////////////////////////////////
+bool ImageLoader::GetAsyncResult(AsyncImageRequest* Request, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format, bool& Success)
+{
+    {
+        Lock ScopedLock(myMutex);
+        if (!Request->Done)
+            return false;
+    }
+
+    // The workers don't use a processed request anymore
+    Pixels.swap(Request->Pixels);
+    Width   = Request->Width;
+    Height  = Request->Height;
+    Format  = Request->Format;
+    Success = Request->Success;
+    delete Request;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Abandon a background loading
+////////////////////////////////////////////////////////////
+void ImageLoader::CancelAsync(AsyncImageRequest* Request)
+{
+    Lock ScopedLock(myMutex);
+
+    // Pending requests are destroyed by the worker which processes them
+    if (Request->Done)
+        delete Request;
+    else
+        Request->Cancelled = true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Decode an image file in memory
+////////////////////////////////////////////////////////////
+bool ImageLoader::DecodeImage(const unsigned char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format, std::string& Error, unsigned int MaxWidth, unsigned int MaxHeight)
+{
+    // All the image files but the cache ones give RGBA pixels
+    Format = PixelFormat::RGBA8;
+
+    // JPG can be reduced while it's decoded, so it handles the maximum size itself
+    if ((SizeInBytes >= 3) && (Data[0] == 0xFF) && (Data[1] == 0xD8) && (Data[2] == 0xFF))
+        return ReadJpg(Data, SizeInBytes, Pixels, Width, Height, Error, MaxWidth, MaxHeight);
+
+    if ((SizeInBytes >= CacheHeaderSize) && (memcmp(Data, CacheMagic, sizeof(CacheMagic)) == 0))
+    {
+        // Cache files are copied (or inflated) directly into the pixel array
+        if (!ReadCache(Data, SizeInBytes, Pixels, Width, Height, Format, Error))
+            return false;
+    }
+    else if ((SizeInBytes >= 8) && (png_sig_cmp(const_cast<png_bytep>(Data), 0, 8) == 0))
+    {
+        // PNG is decoded directly into the pixel array
+        if (!ReadPng(Data, SizeInBytes, Pixels, Width, Height, Error))
+            return false;
+    }
+    else
+    {
+        // Other formats are handled by SOIL
+        int ImgWidth, ImgHeight, ImgChannels;
+        unsigned char* PixelsPtr = SOIL_load_image_from_memory(Data, static_cast<int>(SizeInBytes), &ImgWidth, &ImgHeight, &ImgChannels, SOIL_LOAD_RGBA);
+        if (!PixelsPtr)
+        {
+            Error = SOIL_last_result();
+            return false;
+        }
+
+        // Assign the image properties
+        Width  = ImgWidth;
+        Height = ImgHeight;
+
+        // Copy the loaded pixels to the pixel buffer
+        Pixels.assign(PixelsPtr, PixelsPtr + Width * Height * 4);
+
+        // Free the loaded pixels (they are now in our own pixel buffer)
+        SOIL_free_image_data(PixelsPtr);
+    }
+
+    // Reduce the image to the requested size, if any
+    unsigned int NewWidth, NewHeight;
+    FitSize(Width, Height, MaxWidth, MaxHeight, NewWidth, NewHeight);
+    Downscale(Pixels, Width, Height, NewWidth, NewHeight, Format);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Read an image cache file in memory
+////////////////////////////////////////////////////////////
+bool ImageLoader::ReadCache(const unsigned char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format, std::string& Error)
+{
+    // Read and check the header
+    Uint32 Version     = ReadUint32(Data + 4);
+    Uint32 ImgWidth    = ReadUint32(Data + 8);
+    Uint32 ImgHeight   = ReadUint32(Data + 12);
+    Uint32 ImgFormat   = ReadUint32(Data + 16);
+    Uint32 Compression = ReadUint32(Data + 20);
+    if (Version != CacheVersion)
+    {
+        Error = "unsupported image cache version";
+        return false;
+    }
+    if ((ImgWidth == 0) || (ImgHeight == 0) || (ImgFormat > PixelFormat::L8) || (Compression > CacheZlib))
+    {
+        Error = "corrupt image cache header";
+        return false;
+    }
+    if ((ImgWidth > CacheMaxSize) || (ImgHeight > CacheMaxSize))
+    {
+        Error = "image cache dimensions are too large";
+        return false;
+    }
+
+    // Read the size of the stored pixels
+    const unsigned char* Stored = Data + CacheHeaderSize;
+    std::size_t Remaining       = SizeInBytes - CacheHeaderSize;
+    std::size_t StoredSize      = Remaining >= 4 ? ReadUint32(Stored) : 0;
+    std::size_t PixelsSize      = static_cast<std::size_t>(ImgWidth) * ImgHeight * GetPixelSize(static_cast<PixelFormat::Format>(ImgFormat));
+    if ((Remaining < 4) || (StoredSize > Remaining - 4) || ((Compression == CacheRaw) && (StoredSize != PixelsSize)))
+    {
+        Error = "truncated image cache file";
+        return false;
+    }
+    Stored += 4;
+
+    if (Compression == CacheRaw)
+    {
+        Pixels.assign(Stored, Stored + PixelsSize);
+    }
+    else
+    {
+        Pixels.resize(PixelsSize);
+        uLongf InflatedSize = static_cast<uLongf>(PixelsSize);
+        if ((uncompress(&Pixels[0], &InflatedSize, Stored, static_cast<uLong>(StoredSize)) != Z_OK) || (InflatedSize != PixelsSize))
+        {
+            Pixels.clear();
+            Error = "corrupt compressed pixels in image cache file";
+            return false;
+        }
+    }
+
+    Width  = ImgWidth;
+    Height = ImgHeight;
+    Format = static_cast<PixelFormat::Format>(ImgFormat);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Decode a JPG image file in memory
+////////////////////////////////////////////////////////////
+bool ImageLoader::ReadJpg(const unsigned char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, std::string& Error, unsigned int MaxWidth, unsigned int MaxHeight)
+{
+    // Initialize the error handler
+    jpeg_decompress_struct DecompressInfo;
+    JpegErrorManager ErrorManager;
+    DecompressInfo.err = jpeg_std_error(&ErrorManager.Base);
+    ErrorManager.Base.error_exit     = &JpegErrorExit;
+    ErrorManager.Base.output_message = &JpegOutputMessage;
+
+    // The row buffer is declared here so that it's still valid after an error
+    std::vector<Uint8> RowBuffer;
+
+    // For proper error handling...
+    if (setjmp(ErrorManager.Jump))
+    {
+        jpeg_destroy_decompress(&DecompressInfo);
+        Pixels.clear();
+        Error = ErrorManager.Message;
+        return false;
+    }
+
+    // Read directly from the file data
+    jpeg_create_decompress(&DecompressInfo);
+    jpeg_source_mgr Source;
+    Source.next_input_byte   = Data;
+    Source.bytes_in_buffer   = SizeInBytes;
+    Source.init_source       = &JpegInitSource;
+    Source.fill_input_buffer = &JpegFillInputBuffer;
+    Source.skip_input_data   = &JpegSkipInputData;
+    Source.resync_to_restart = &jpeg_resync_to_restart;
+    Source.term_source       = &JpegTermSource;
+    DecompressInfo.src = &Source;
+
+    // Read the header and ask for RGB output, whatever the source color space
+    jpeg_read_header(&DecompressInfo, TRUE);
+    DecompressInfo.out_color_space = JCS_RGB;
+
+    // If the image has to be reduced, let the IDCT produce the smallest
+    // size (1/2, 1/4 or 1/8) that is still at least as big as the target
+    unsigned int NewWidth, NewHeight;
+    FitSize(DecompressInfo.image_width, DecompressInfo.image_height, MaxWidth, MaxHeight, NewWidth, NewHeight);
+    for (unsigned int Denom = 8; Denom > 1; Denom /= 2)
+    {
+        if (((DecompressInfo.image_width  + Denom - 1) / Denom >= NewWidth) &&
+            ((DecompressInfo.image_height + Denom - 1) / Denom >= NewHeight))
+        {
+            DecompressInfo.scale_num   = 1;
+            DecompressInfo.scale_denom = Denom;
+            break;
+        }
+    }
+
+    jpeg_start_decompress(&DecompressInfo);
+
+    Width  = DecompressInfo.output_width;
+    Height = DecompressInfo.output_height;
+    Pixels.resize(Width * Height * 4);
+    RowBuffer.resize(Width * 3);
+
+    // Decode each row, and expand it to RGBA into its final place
+    while (DecompressInfo.output_scanline < DecompressInfo.output_height)
+    {
+        JSAMPROW RowPointer = &RowBuffer[0];
+        jpeg_read_scanlines(&DecompressInfo, &RowPointer, 1);
+        PixelKernels::ExpandRGB(&Pixels[(DecompressInfo.output_scanline - 1) * Width * 4], &RowBuffer[0], Width);
+    }
+
+    // Finish decompression
+    jpeg_finish_decompress(&DecompressInfo);
+    jpeg_destroy_decompress(&DecompressInfo);
+
+    // Finish the reduction with a high-quality filter
+    Downscale(Pixels, Width, Height, NewWidth, NewHeight, PixelFormat::RGBA8);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Decode a PNG image file in memory
+////////////////////////////////////////////////////////////
+bool ImageLoader::ReadPng(const unsigned char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, std::string& Error)
+{
+    // Create the main PNG structure
+    png_structp Png = png_create_read_struct(PNG_LIBPNG_VER_STRING, &Error, &PngReadErrorHandler, &PngWarningHandler);
+    if (!Png)
+    {
+        Error = "cannot allocate PNG read structure";
+        return false;
+    }
+
+    // Create the image informations
+    png_infop PngInfo = png_create_info_struct(Png);
+    if (!PngInfo)
+    {
+        png_destroy_read_struct(&Png, NULL, NULL);
+        Error = "cannot allocate PNG info structure";
+        return false;
+    }
+
+    // The row pointers are declared here so that they're still valid after an error
+    std::vector<png_bytep> RowPointers;
+
+    // For proper error handling...
+    if (setjmp(Png->jmpbuf))
+    {
+        png_destroy_read_struct(&Png, &PngInfo, NULL);
+        Pixels.clear();
+        return false;
+    }
+
+    // Read directly from the file data
+    PngSource Source = {Data, SizeInBytes, 0};
+    png_set_read_fn(Png, &Source, &PngReadData);
+
+    // Read the header
+    png_read_info(Png, PngInfo);
+    png_uint_32 ImgWidth, ImgHeight;
+    int BitDepth, ColorType;
+    png_get_IHDR(Png, PngInfo, &ImgWidth, &ImgHeight, &BitDepth, &ColorType, NULL, NULL, NULL);
+
+    // Let libpng convert any kind of pixels to 8 bits RGBA
+    png_set_expand(Png);
+    if (BitDepth == 16)
+        png_set_strip_16(Png);
+    if ((ColorType == PNG_COLOR_TYPE_GRAY) || (ColorType == PNG_COLOR_TYPE_GRAY_ALPHA))
+        png_set_gray_to_rgb(Png);
+    if (!(ColorType & PNG_COLOR_MASK_ALPHA) && !png_get_valid(Png, PngInfo, PNG_INFO_tRNS))
+        png_set_filler(Png, 0xFF, PNG_FILLER_AFTER);
+    png_set_interlace_handling(Png);
+    png_read_update_info(Png, PngInfo);
+
+    // Decode the rows into their final place
+    Width  = ImgWidth;
+    Height = ImgHeight;
+    Pixels.resize(Width * Height * 4);
+    RowPointers.resize(Height);
+    for (unsigned int i = 0; i < Height; ++i)
+        RowPointers[i] = &Pixels[i * Width * 4];
+    png_read_image(Png, &RowPointers[0]);
+    png_read_end(Png, NULL);
+
+    // Cleanup resources
+    png_destroy_read_struct(&Png, &PngInfo, NULL);
+
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Save a JPG image file
 ////////////////////////////////////////////////////////////
-bool ImageLoader::WriteJpg(const std::string& Filename, const std::vector<Color>& Pixels, unsigned int Width, unsigned int Height)
+bool ImageLoader::WriteJpg(const std::string& Filename, const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height)
 {
     // Open the file to write in
     FILE* File = fopen(Filename.c_str(), "wb");
@@ -227,11 +896,11 @@ bool ImageLoader::WriteJpg(const std::string& Filename, const std::vector<Color>
 
     // Get rid of the aplha channel
     std::vector<Uint8> PixelsBuffer(Width * Height * 3);
-    for (std::size_t i = 0; i < Pixels.size(); ++i)
+    for (std::size_t i = 0; i < Width * Height; ++i)
     {
-        PixelsBuffer[i * 3 + 0] = Pixels[i].r;
-        PixelsBuffer[i * 3 + 1] = Pixels[i].g;
-        PixelsBuffer[i * 3 + 2] = Pixels[i].b;
+        PixelsBuffer[i * 3 + 0] = Pixels[i * 4 + 0];
+        PixelsBuffer[i * 3 + 1] = Pixels[i * 4 + 1];
+        PixelsBuffer[i * 3 + 2] = Pixels[i * 4 + 2];
     }
     Uint8* PixelsPtr = &PixelsBuffer[0];
 
@@ -259,7 +928,7 @@ bool ImageLoader::WriteJpg(const std::string& Filename, const std::vector<Color>
 ////////////////////////////////////////////////////////////
 /// Save a PNG image file
 ////////////////////////////////////////////////////////////
-bool ImageLoader::WritePng(const std::string& Filename, const std::vector<Color>& Pixels, unsigned int Width, unsigned int Height)
+bool ImageLoader::WritePng(const std::string& Filename, const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height)
 {
     // Open the file to write in
     FILE* File = fopen(Filename.c_str(), "wb");
@@ -327,6 +996,51 @@ bool ImageLoader::WritePng(const std::string& Filename, const std::vector<Color>
     return true;
 }
 
+////////////////////////////////////////////////////////////
+/// Entry point of the worker threads : process the pending
+/// requests until there's none left
+////////////////////////////////////////////////////////////
+void ImageLoader::RunWorker(void* UserData)
+{
+    Worker&      Self   = *static_cast<Worker*>(UserData);
+    ImageLoader& Loader = *Self.Owner;
+
+    for (;;)
+    {
+        // Get the next request, skipping the cancelled ones
+        AsyncImageRequest* Request = NULL;
+        {
+            Lock ScopedLock(Loader.myMutex);
+            while (!Request && !Loader.myRequests.empty())
+            {
+                Request = Loader.myRequests.front();
+                Loader.myRequests.pop_front();
+                if (Request->Cancelled)
+                {
+                    delete Request;
+                    Request = NULL;
+                }
+            }
+
+            if (!Request)
+            {
+                Self.Running = false;
+                return;
+            }
+        }
+
+        // Decode the image
+        Request->Success = Loader.LoadImageFromFile(Request->Filename, Request->Pixels, Request->Width, Request->Height, Request->Format);
+
+        // Hand the result to the image, unless it doesn't want it anymore
+        Lock ScopedLock(Loader.myMutex);
+        if (Request->Cancelled)
+            delete Request;
+        else
+            Request->Done = true;
+    }
+}
+
 } // namespace priv
 
 } // namespace sf
@@ -28,8 +28,11 @@
 ////////////////////////////////////////////////////////////
 // Headers
 ////////////////////////////////////////////////////////////
-#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Mutex.hpp>
 #include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -38,9 +41,26 @@ namespace sf
 {
 namespace priv
 {
+////////////////////////////////////////////////////////////
+/// Image file loaded in the background by the workers of
+/// the ImageLoader
+////////////////////////////////////////////////////////////
+struct AsyncImageRequest
+{
+    std::string         Filename;  ///< Path of the image file to load
+    std::vector<Uint8>  Pixels;    ///< Loaded pixels
+    unsigned int        Width;     ///< Width of the loaded image
+    unsigned int        Height;    ///< Height of the loaded image
+    PixelFormat::Format Format;    ///< Format of the loaded pixels
+    bool                Success;   ///< Did the loading succeed ?
+    bool                Done;      ///< Has the request been processed ?
+    bool                Cancelled; ///< Has the request been abandoned by its image ?
+};
+
 ////////////////////////////////////////////////////////////
 /// ImageLoader load and save images from files ;
-/// Supported formats are : bmp, dds, jpg, png, tga, psd
+/// Supported formats are : bmp, dds, jpg, png, tga, psd,
+/// and SFML image cache files
 ////////////////////////////////////////////////////////////
 class ImageLoader : NonCopyable
 {
@@ -55,17 +75,21 @@ public :
     static ImageLoader& GetInstance();
 
     ////////////////////////////////////////////////////////////
-    /// Load pixels from an image file
+    /// Load pixels from an image file, optionally reduced to fit
+    /// into a maximum size
     ///
-    /// \param Filename : Path of image file to load
-    /// \param Pixels :   Array of pixels to fill with loaded image
-    /// \param Width :    Width of loaded image, in pixels
-    /// \param Height :   Height of loaded image, in pixels
+    /// \param Filename :  Path of image file to load
+    /// \param Pixels :    Array of pixels to fill with loaded image
+    /// \param Width :     Width of loaded image, in pixels
+    /// \param Height :    Height of loaded image, in pixels
+    /// \param Format :    Format of loaded pixels
+    /// \param MaxWidth :  Maximum width of the loaded image (0 for no limit)
+    /// \param MaxHeight : Maximum height of the loaded image (0 for no limit)
     ///
     /// \return True if loading was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool LoadImageFromFile(const std::string& Filename, std::vector<Color>& Pixels, unsigned int& Width, unsigned int& Height);
+    bool LoadImageFromFile(const std::string& Filename, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format, unsigned int MaxWidth = 0, unsigned int MaxHeight = 0);
 
     ////////////////////////////////////////////////////////////
     /// Load pixels from an image file in memory
@@ -75,24 +99,77 @@ public :
     /// \param Pixels :      Array of pixels to fill with loaded image
     /// \param Width :       Width of loaded image, in pixels
     /// \param Height :      Height of loaded image, in pixels
+    /// \param Format :      Format of loaded pixels
     ///
     /// \return True if loading was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool LoadImageFromMemory(const char* Data, std::size_t SizeInBytes, std::vector<Color>& Pixels, unsigned int& Width, unsigned int& Height);
+    bool LoadImageFromMemory(const char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format);
 
     ////////////////////////////////////////////////////////////
     /// Save pixels to an image file
     ///
     /// \param Filename : Path of image file to save
-    /// \param Pixels :   Array of pixels to save to image
+    /// \param Pixels :   Array of RGBA pixels to save to image
     /// \param Width :    Width of image to save, in pixels
     /// \param Height :   Height of image to save, in pixels
     ///
     /// \return True if saving was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool SaveImageToFile(const std::string& Filename, const std::vector<Color>& Pixels, unsigned int Width, unsigned int Height);
+    bool SaveImageToFile(const std::string& Filename, const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height);
+
+    ////////////////////////////////////////////////////////////
+    /// Save pixels to an image cache file, which can be loaded
+    /// back with almost no decoding work
+    ///
+    /// \param Filename : Path of the cache file to save
+    /// \param Pixels :   Array of pixels to save
+    /// \param Width :    Width of image to save, in pixels
+    /// \param Height :   Height of image to save, in pixels
+    /// \param Format :   Format of the pixels
+    /// \param Compress : Compress the pixels with zlib ?
+    ///
+    /// \return True if saving was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool SaveImageToCache(const std::string& Filename, const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height, PixelFormat::Format Format, bool Compress);
+
+    ////////////////////////////////////////////////////////////
+    /// Start loading an image file in the background ; the file
+    /// is decoded by a pool of worker threads
+    ///
+    /// \param Filename : Path of image file to load
+    ///
+    /// \return Request to pass to GetAsyncResult or CancelAsync
+    ///
+    ////////////////////////////////////////////////////////////
+    AsyncImageRequest* LoadImageFromFileAsync(const std::string& Filename);
+
+    ////////////////////////////////////////////////////////////
+    /// Get the result of a background loading, if it's finished ;
+    /// the request is destroyed when the result is returned
+    ///
+    /// \param Request : Request returned by LoadImageFromFileAsync
+    /// \param Pixels :  Array of pixels to fill with loaded image
+    /// \param Width :   Width of loaded image, in pixels
+    /// \param Height :  Height of loaded image, in pixels
+    /// \param Format :  Format of loaded pixels
+    /// \param Success : Receives the status of the loading
+    ///
+    /// \return True if the loading is finished, false if it's still in progress
+    ///
+    ////////////////////////////////////////////////////////////
+    bool GetAsyncResult(AsyncImageRequest* Request, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format, bool& Success);
+
+    ////////////////////////////////////////////////////////////
+    /// Abandon a background loading ; the request is destroyed
+    /// as soon as no worker uses it anymore
+    ///
+    /// \param Request : Request returned by LoadImageFromFileAsync
+    ///
+    ////////////////////////////////////////////////////////////
+    void CancelAsync(AsyncImageRequest* Request);
 
 private :
 
@@ -108,31 +185,131 @@ private :
     ////////////////////////////////////////////////////////////
     ~ImageLoader();
 
+    ////////////////////////////////////////////////////////////
+    /// Decode an image file in memory ; PNG, JPG and cache files
+    /// are decoded directly into the pixel array, other formats
+    /// go through SOIL
+    ///
+    /// \param Data :        Pointer to the file data in memory
+    /// \param SizeInBytes : Size of the data to decode, in bytes
+    /// \param Pixels :      Array of pixels to fill with decoded image
+    /// \param Width :       Width of decoded image, in pixels
+    /// \param Height :      Height of decoded image, in pixels
+    /// \param Format :      Format of decoded pixels
+    /// \param Error :       Receives the reason of the failure, if any
+    /// \param MaxWidth :    Maximum width of the decoded image (0 for no limit)
+    /// \param MaxHeight :   Maximum height of the decoded image (0 for no limit)
+    ///
+    /// \return True if decoding was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool DecodeImage(const unsigned char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format, std::string& Error, unsigned int MaxWidth = 0, unsigned int MaxHeight = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// Read an image cache file in memory
+    ///
+    /// \param Data :        Pointer to the file data in memory
+    /// \param SizeInBytes : Size of the data to read, in bytes
+    /// \param Pixels :      Array of pixels to fill with the image
+    /// \param Width :       Width of the image, in pixels
+    /// \param Height :      Height of the image, in pixels
+    /// \param Format :      Format of the pixels
+    /// \param Error :       Receives the reason of the failure, if any
+    ///
+    /// \return True if reading was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool ReadCache(const unsigned char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, PixelFormat::Format& Format, std::string& Error);
+
+    ////////////////////////////////////////////////////////////
+    /// Decode a JPG image file in memory ; when the image has to
+    /// be reduced, libjpeg's DCT scaling does most of the work
+    ///
+    /// \param Data :        Pointer to the file data in memory
+    /// \param SizeInBytes : Size of the data to decode, in bytes
+    /// \param Pixels :      Array of RGBA pixels to fill with decoded image
+    /// \param Width :       Width of decoded image, in pixels
+    /// \param Height :      Height of decoded image, in pixels
+    /// \param Error :       Receives the reason of the failure, if any
+    /// \param MaxWidth :    Maximum width of the decoded image (0 for no limit)
+    /// \param MaxHeight :   Maximum height of the decoded image (0 for no limit)
+    ///
+    /// \return True if decoding was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool ReadJpg(const unsigned char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, std::string& Error, unsigned int MaxWidth, unsigned int MaxHeight);
+
+    ////////////////////////////////////////////////////////////
+    /// Decode a PNG image file in memory
+    ///
+    /// \param Data :        Pointer to the file data in memory
+    /// \param SizeInBytes : Size of the data to decode, in bytes
+    /// \param Pixels :      Array of RGBA pixels to fill with decoded image
+    /// \param Width :       Width of decoded image, in pixels
+    /// \param Height :      Height of decoded image, in pixels
+    /// \param Error :       Receives the reason of the failure, if any
+    ///
+    /// \return True if decoding was successful
+    ///
+    ////////////////////////////////////////////////////////////
+    bool ReadPng(const unsigned char* Data, std::size_t SizeInBytes, std::vector<Uint8>& Pixels, unsigned int& Width, unsigned int& Height, std::string& Error);
+
     ////////////////////////////////////////////////////////////
     /// Save a JPG image file
     ///
     /// \param Filename : Path of image file to save
-    /// \param Pixels :   Array of pixels to save to image
+    /// \param Pixels :   Array of RGBA pixels to save to image
     /// \param Width :    Width of image to save, in pixels
     /// \param Height :   Height of image to save, in pixels
     ///
     /// \return True if saving was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool WriteJpg(const std::string& Filename, const std::vector<Color>& Pixels, unsigned int Width, unsigned int Height);
+    bool WriteJpg(const std::string& Filename, const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height);
 
     ////////////////////////////////////////////////////////////
     /// Save a PNG image file
     ///
     /// \param Filename : Path of image file to save
-    /// \param Pixels :   Array of pixels to save to image
+    /// \param Pixels :   Array of RGBA pixels to save to image
     /// \param Width :    Width of image to save, in pixels
     /// \param Height :   Height of image to save, in pixels
     ///
     /// \return True if saving was successful
     ///
     ////////////////////////////////////////////////////////////
-    bool WritePng(const std::string& Filename, const std::vector<Color>& Pixels, unsigned int Width, unsigned int Height);
+    bool WritePng(const std::string& Filename, const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height);
+
+    ////////////////////////////////////////////////////////////
+    /// Entry point of the worker threads : process the pending
+    /// requests until there's none left
+    ///
+    /// \param UserData : Worker running the function
+    ///
+    ////////////////////////////////////////////////////////////
+    static void RunWorker(void* UserData);
+
+    ////////////////////////////////////////////////////////////
+    /// Maximum number of worker threads
+    ////////////////////////////////////////////////////////////
+    enum {NbWorkers = 4};
+
+    ////////////////////////////////////////////////////////////
+    /// Defines a thread loading images in the background
+    ////////////////////////////////////////////////////////////
+    struct Worker
+    {
+        ImageLoader* Owner;   ///< Image loader owning the worker
+        Thread*      Handle;  ///< Thread running the worker (created on first use)
+        bool         Running; ///< Is the worker processing requests ?
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Mutex                          myMutex;              ///< Mutex protecting the requests and the workers state
+    std::deque<AsyncImageRequest*> myRequests;           ///< Requests waiting for a worker
+    Worker                         myWorkers[NbWorkers]; ///< Worker threads
 };
 
 } // namespace priv
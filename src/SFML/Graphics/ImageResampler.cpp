@@ -0,0 +1,370 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/ImageResampler.hpp>
+#include <SFML/Graphics/PixelKernels.hpp>
+#include <SFML/System/Thread.hpp>
+#include <algorithm>
+#include <vector>
+#include <math.h>
+
+
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Maximum number of threads running a pass, and minimum
+    // number of pixels to give to each of them
+    ////////////////////////////////////////////////////////////
+    const unsigned int MaxWorkers         = 4;
+    const unsigned int MinPixelsPerWorker = 64 * 64;
+
+    ////////////////////////////////////////////////////////////
+    /// Normalized sinc function
+    ////////////////////////////////////////////////////////////
+    double Sinc(double X)
+    {
+        X *= 3.141592653589793;
+        return fabs(X) < 1e-6 ? 1.0 : sin(X) / X;
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Get the radius of a filter, in source pixels
+    ////////////////////////////////////////////////////////////
+    double GetSupport(sf::ResizeFilter::Mode Filter)
+    {
+        switch (Filter)
+        {
+            case sf::ResizeFilter::Box :      return 0.5;
+            case sf::ResizeFilter::Bilinear : return 1.0;
+            case sf::ResizeFilter::Bicubic :  return 2.0;
+            default :
+            case sf::ResizeFilter::Lanczos :  return 3.0;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Evaluate a filter at a given distance from its center
+    ////////////////////////////////////////////////////////////
+    double Evaluate(sf::ResizeFilter::Mode Filter, double X)
+    {
+        X = fabs(X);
+        switch (Filter)
+        {
+            case sf::ResizeFilter::Box :
+                return X < 0.5 ? 1.0 : 0.0;
+
+            case sf::ResizeFilter::Bilinear :
+                return X < 1.0 ? 1.0 - X : 0.0;
+
+            case sf::ResizeFilter::Bicubic :
+                // Catmull-Rom spline
+                if (X < 1.0) return (1.5 * X - 2.5) * X * X + 1.0;
+                if (X < 2.0) return ((-0.5 * X + 2.5) * X - 4.0) * X + 2.0;
+                return 0.0;
+
+            default :
+            case sf::ResizeFilter::Lanczos :
+                return X < 3.0 ? Sinc(X) * Sinc(X / 3.0) : 0.0;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Weights of the source pixels contributing to each pixel
+    /// of a resized row or column ; every destination pixel has
+    /// the same number of taps, unused ones having a null weight
+    ////////////////////////////////////////////////////////////
+    struct AxisWeights
+    {
+        unsigned int              NbTaps; ///< Number of source pixels per destination pixel
+        std::vector<unsigned int> First;  ///< First source pixel of each destination pixel
+        std::vector<float>        Values; ///< Weights of the source pixels, NbTaps per destination pixel
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Compute the weights for resizing a row or a column
+    ////////////////////////////////////////////////////////////
+    void ComputeWeights(unsigned int SrcSize, unsigned int DstSize, sf::ResizeFilter::Mode Filter, AxisWeights& Weights)
+    {
+        // When reducing, the filter is stretched so that it covers all the source pixels
+        double Scale       = static_cast<double>(SrcSize) / DstSize;
+        double FilterScale = std::max(Scale, 1.0);
+        double Support     = GetSupport(Filter) * FilterScale;
+
+        Weights.NbTaps = std::min(static_cast<unsigned int>(ceil(Support * 2)) + 2, SrcSize);
+        Weights.First.resize(DstSize);
+        Weights.Values.assign(DstSize * Weights.NbTaps, 0.f);
+
+        for (unsigned int i = 0; i < DstSize; ++i)
+        {
+            double Center = (i + 0.5) * Scale;
+            int    Begin  = std::max(static_cast<int>(floor(Center - Support)), 0);
+            int    End    = std::min(static_cast<int>(ceil(Center + Support)), static_cast<int>(SrcSize));
+
+            // Keep all the taps inside the source
+            unsigned int First = std::min(static_cast<unsigned int>(Begin), SrcSize - Weights.NbTaps);
+            float*       Taps  = &Weights.Values[i * Weights.NbTaps];
+
+            double Sum = 0;
+            for (int j = Begin; j < End; ++j)
+            {
+                double Weight;
+                if (Filter == sf::ResizeFilter::Box)
+                {
+                    // The box filter uses the exact coverage of the source pixels, which gives a true area average
+                    double Left  = Center - 0.5 * FilterScale;
+                    double Right = Center + 0.5 * FilterScale;
+                    Weight = std::max(std::min<double>(j + 1, Right) - std::max<double>(j, Left), 0.0);
+                }
+                else
+                {
+                    Weight = Evaluate(Filter, (j + 0.5 - Center) / FilterScale);
+                }
+
+                Taps[j - First] = static_cast<float>(Weight);
+                Sum += Weight;
+            }
+
+            // Normalize the weights so that they don't change the brightness
+            if (Sum != 0)
+            {
+                for (unsigned int j = 0; j < Weights.NbTaps; ++j)
+                    Taps[j] = static_cast<float>(Taps[j] / Sum);
+            }
+            else
+            {
+                Taps[std::min(static_cast<unsigned int>(Center), SrcSize - 1) - First] = 1.f;
+            }
+
+            Weights.First[i] = First;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Rows of a pass, processed by one thread
+    ////////////////////////////////////////////////////////////
+    struct PassJob
+    {
+        const sf::Uint8*   Src;        ///< Source pixels (horizontal pass)
+        float*             Temp;       ///< Horizontally resized pixels (output of the horizontal pass, input of the vertical one)
+        sf::Uint8*         Dst;        ///< Destination pixels (vertical pass)
+        unsigned int       SrcWidth;   ///< Width of the source pixels
+        unsigned int       DstWidth;   ///< Width of the destination pixels
+        unsigned int       NbChannels; ///< Number of components per pixel
+        const AxisWeights* Weights;    ///< Weights of the pass
+        unsigned int       Begin;      ///< First row to process
+        unsigned int       End;        ///< Last row to process (excluded)
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Resize source rows to the destination width ; RGBA pixels
+    /// are premultiplied by their alpha
+    ////////////////////////////////////////////////////////////
+    void HorizontalPass(void* UserData)
+    {
+        const PassJob&     Job      = *static_cast<const PassJob*>(UserData);
+        const AxisWeights& Weights  = *Job.Weights;
+        const unsigned int Channels = Job.NbChannels;
+
+        std::vector<float> Row(Job.SrcWidth * Channels);
+        for (unsigned int y = Job.Begin; y < Job.End; ++y)
+        {
+            // Convert the source row to floats
+            const sf::Uint8* In = Job.Src + y * Job.SrcWidth * Channels;
+            if (Channels == 4)
+            {
+                for (unsigned int x = 0; x < Job.SrcWidth * 4; x += 4)
+                {
+                    float Alpha = In[x + 3] / 255.f;
+                    Row[x + 0] = In[x + 0] * Alpha;
+                    Row[x + 1] = In[x + 1] * Alpha;
+                    Row[x + 2] = In[x + 2] * Alpha;
+                    Row[x + 3] = In[x + 3];
+                }
+            }
+            else
+            {
+                for (unsigned int x = 0; x < Job.SrcWidth * Channels; ++x)
+                    Row[x] = In[x];
+            }
+
+            // Apply the filter
+            float* Out = Job.Temp + y * Job.DstWidth * Channels;
+            if (Channels == 4)
+            {
+                sf::priv::PixelKernels::ConvolveRGBA(Out, &Row[0], &Weights.First[0], &Weights.Values[0], Weights.NbTaps, Job.DstWidth);
+            }
+            else
+            {
+                for (unsigned int x = 0; x < Job.DstWidth; ++x)
+                {
+                    const float* Taps = &Weights.Values[x * Weights.NbTaps];
+                    for (unsigned int c = 0; c < Channels; ++c)
+                    {
+                        float Sum = 0.f;
+                        for (unsigned int j = 0; j < Weights.NbTaps; ++j)
+                            Sum += Row[(Weights.First[x] + j) * Channels + c] * Taps[j];
+                        Out[x * Channels + c] = Sum;
+                    }
+                }
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Clamp and round a filtered component to 8 bits
+    ////////////////////////////////////////////////////////////
+    sf::Uint8 ToComponent(float Value)
+    {
+        return static_cast<sf::Uint8>(std::min(std::max(Value + 0.5f, 0.f), 255.f));
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Resize the columns of the horizontally resized pixels
+    /// to the destination height, and write the final pixels
+    ////////////////////////////////////////////////////////////
+    void VerticalPass(void* UserData)
+    {
+        const PassJob&     Job      = *static_cast<const PassJob*>(UserData);
+        const AxisWeights& Weights  = *Job.Weights;
+        const unsigned int Channels = Job.NbChannels;
+        const unsigned int RowSize  = Job.DstWidth * Channels;
+
+        std::vector<float> Row(RowSize);
+        for (unsigned int y = Job.Begin; y < Job.End; ++y)
+        {
+            // Apply the filter, one whole row at a time
+            std::fill(Row.begin(), Row.end(), 0.f);
+            const float* Taps = &Weights.Values[y * Weights.NbTaps];
+            for (unsigned int j = 0; j < Weights.NbTaps; ++j)
+            {
+                if (Taps[j] != 0.f)
+                    sf::priv::PixelKernels::MultiplyAdd(&Row[0], Job.Temp + (Weights.First[y] + j) * RowSize, Taps[j], RowSize);
+            }
+
+            // Convert back to 8 bits, removing the alpha premultiplication
+            sf::Uint8* Out = Job.Dst + y * RowSize;
+            if (Channels == 4)
+            {
+                for (unsigned int x = 0; x < RowSize; x += 4)
+                {
+                    float Alpha = Row[x + 3];
+                    if (Alpha > 0.f)
+                    {
+                        float Factor = 255.f / Alpha;
+                        Out[x + 0] = ToComponent(Row[x + 0] * Factor);
+                        Out[x + 1] = ToComponent(Row[x + 1] * Factor);
+                        Out[x + 2] = ToComponent(Row[x + 2] * Factor);
+                        Out[x + 3] = ToComponent(Alpha);
+                    }
+                    else
+                    {
+                        Out[x + 0] = Out[x + 1] = Out[x + 2] = Out[x + 3] = 0;
+                    }
+                }
+            }
+            else
+            {
+                for (unsigned int x = 0; x < RowSize; ++x)
+                    Out[x] = ToComponent(Row[x]);
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////
+    /// Run a pass, splitting its rows between several threads
+    /// if there are enough pixels to process
+    ////////////////////////////////////////////////////////////
+    void RunPass(void (*Pass)(void*), const PassJob& Rows)
+    {
+        unsigned int NbRows    = Rows.End - Rows.Begin;
+        unsigned int NbPixels  = NbRows * Rows.DstWidth;
+        unsigned int NbWorkers = std::max(std::min(std::min(MaxWorkers, NbPixels / MinPixelsPerWorker), NbRows), 1u);
+
+        std::vector<PassJob> Jobs(NbWorkers, Rows);
+        for (unsigned int i = 0; i < NbWorkers; ++i)
+        {
+            Jobs[i].Begin = Rows.Begin + NbRows * i / NbWorkers;
+            Jobs[i].End   = Rows.Begin + NbRows * (i + 1) / NbWorkers;
+        }
+
+        // The first part is processed by this thread
+        std::vector<sf::Thread*> Workers;
+        for (unsigned int i = 1; i < NbWorkers; ++i)
+        {
+            Workers.push_back(new sf::Thread(Pass, &Jobs[i]));
+            Workers.back()->Launch();
+        }
+        Pass(&Jobs[0]);
+        for (std::vector<sf::Thread*>::iterator i = Workers.begin(); i != Workers.end(); ++i)
+        {
+            (*i)->Wait();
+            delete *i;
+        }
+    }
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// Resize an array of pixels
+////////////////////////////////////////////////////////////
+void ImageResampler::Resample(const Uint8* Src, unsigned int SrcWidth, unsigned int SrcHeight, Uint8* Dst, unsigned int DstWidth, unsigned int DstHeight, unsigned int NbChannels, ResizeFilter::Mode Filter)
+{
+    AxisWeights Horizontal, Vertical;
+    ComputeWeights(SrcWidth,  DstWidth,  Filter, Horizontal);
+    ComputeWeights(SrcHeight, DstHeight, Filter, Vertical);
+
+    std::vector<float> Temp(DstWidth * SrcHeight * NbChannels);
+
+    PassJob Rows;
+    Rows.Src        = Src;
+    Rows.Temp       = &Temp[0];
+    Rows.Dst        = Dst;
+    Rows.SrcWidth   = SrcWidth;
+    Rows.DstWidth   = DstWidth;
+    Rows.NbChannels = NbChannels;
+
+    // Resize the rows
+    Rows.Weights = &Horizontal;
+    Rows.Begin   = 0;
+    Rows.End     = SrcHeight;
+    RunPass(&HorizontalPass, Rows);
+
+    // Resize the columns
+    Rows.Weights = &Vertical;
+    Rows.Begin   = 0;
+    Rows.End     = DstHeight;
+    RunPass(&VerticalPass, Rows);
+}
+
+} // namespace priv
+
+} // namespace sf
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_IMAGERESAMPLER_HPP
+#define SFML_IMAGERESAMPLER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/Image.hpp>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// Resizes arrays of pixels with a separable filter : rows
+/// are filtered first, then columns, and both passes are
+/// split between several threads for big images.
+/// RGBA pixels are weighted by their alpha, so that the
+/// color of transparent pixels doesn't bleed into the
+/// visible ones.
+/// This class is for internal use only
+////////////////////////////////////////////////////////////
+class ImageResampler
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Resize an array of pixels
+    ///
+    /// \param Src :        Source pixels
+    /// \param SrcWidth :   Width of the source pixels
+    /// \param SrcHeight :  Height of the source pixels
+    /// \param Dst :        Destination pixels
+    /// \param DstWidth :   Width of the destination pixels
+    /// \param DstHeight :  Height of the destination pixels
+    /// \param NbChannels : Number of components per pixel (4 for RGBA, 1 for single-channel)
+    /// \param Filter :     Filter to use
+    ///
+    ////////////////////////////////////////////////////////////
+    static void Resample(const Uint8* Src, unsigned int SrcWidth, unsigned int SrcHeight, Uint8* Dst, unsigned int DstWidth, unsigned int DstHeight, unsigned int NbChannels, ResizeFilter::Mode Filter);
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_IMAGERESAMPLER_HPP
@@ -0,0 +1,458 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/PixelKernels.hpp>
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    #define SFML_PIXELKERNELS_SSE2
+    #include <emmintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+// GCC only accepts SSE2 intrinsics in functions compiled for SSE2
+#if defined(SFML_PIXELKERNELS_SSE2) && defined(__GNUC__)
+    #define SFML_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+    #define SFML_TARGET_SSE2
+#endif
+
+
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Get the 32 bits value of a RGBA pixel, as stored in memory
+    ////////////////////////////////////////////////////////////
+    sf::Uint32 ToPixel(const sf::Color& Col)
+    {
+        sf::Uint8  Components[4] = {Col.r, Col.g, Col.b, Col.a};
+        sf::Uint32 Pixel;
+        memcpy(&Pixel, Components, 4);
+
+        return Pixel;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Divide a value in range [0, 255 * 255] by 255 ; this is
+    // exact, and matches the SSE2 version
+    ////////////////////////////////////////////////////////////
+    inline unsigned int Div255(unsigned int Value)
+    {
+        return (Value + 1 + (Value >> 8)) >> 8;
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Plain C++ versions
+    ////////////////////////////////////////////////////////////
+    void BlendRGBScalar(sf::Uint8* Dst, const sf::Uint8* Src, std::size_t Count)
+    {
+        for (std::size_t i = 0; i < Count; ++i, Src += 4, Dst += 4)
+        {
+            unsigned int Alpha = Src[3];
+            Dst[0] = static_cast<sf::Uint8>(Div255(Src[0] * Alpha + Dst[0] * (255 - Alpha)));
+            Dst[1] = static_cast<sf::Uint8>(Div255(Src[1] * Alpha + Dst[1] * (255 - Alpha)));
+            Dst[2] = static_cast<sf::Uint8>(Div255(Src[2] * Alpha + Dst[2] * (255 - Alpha)));
+        }
+    }
+
+    void ReplaceColorScalar(sf::Uint8* Pixels, std::size_t Count, sf::Uint32 Key, sf::Uint32 Replacement)
+    {
+        for (std::size_t i = 0; i < Count; ++i, Pixels += 4)
+        {
+            sf::Uint32 Pixel;
+            memcpy(&Pixel, Pixels, 4);
+            if (Pixel == Key)
+                memcpy(Pixels, &Replacement, 4);
+        }
+    }
+
+    void FillScalar(sf::Uint8* Pixels, std::size_t Count, sf::Uint32 Value)
+    {
+        for (std::size_t i = 0; i < Count; ++i, Pixels += 4)
+            memcpy(Pixels, &Value, 4);
+    }
+
+    void ExpandRGBScalar(sf::Uint8* Dst, const sf::Uint8* Src, std::size_t Count)
+    {
+        for (std::size_t i = 0; i < Count; ++i, Src += 3, Dst += 4)
+        {
+            Dst[0] = Src[0];
+            Dst[1] = Src[1];
+            Dst[2] = Src[2];
+            Dst[3] = 255;
+        }
+    }
+
+    void MultiplyAddScalar(float* Acc, const float* Src, float Weight, std::size_t Count)
+    {
+        for (std::size_t i = 0; i < Count; ++i)
+            Acc[i] += Src[i] * Weight;
+    }
+
+    void ConvolveRGBAScalar(float* Dst, const float* Src, const unsigned int* First, const float* Weights, std::size_t NbTaps, std::size_t Count)
+    {
+        for (std::size_t i = 0; i < Count; ++i, Dst += 4)
+        {
+            const float* In = Src + First[i] * 4;
+            Dst[0] = Dst[1] = Dst[2] = Dst[3] = 0.f;
+            for (std::size_t j = 0; j < NbTaps; ++j, In += 4, ++Weights)
+            {
+                Dst[0] += In[0] * *Weights;
+                Dst[1] += In[1] * *Weights;
+                Dst[2] += In[2] * *Weights;
+                Dst[3] += In[3] * *Weights;
+            }
+        }
+    }
+
+    void HalveRowsScalar(sf::Uint8* Dst, const sf::Uint8* Row0, const sf::Uint8* Row1, std::size_t Count)
+    {
+        for (std::size_t i = 0; i < Count * 4; ++i, ++Dst)
+        {
+            std::size_t Src = (i / 4) * 8 + i % 4;
+            *Dst = static_cast<sf::Uint8>((Row0[Src] + Row0[Src + 4] + Row1[Src] + Row1[Src + 4] + 2) >> 2);
+        }
+    }
+
+#ifdef SFML_PIXELKERNELS_SSE2
+
+    ////////////////////////////////////////////////////////////
+    // SSE2 versions, processing 4 pixels at once ; the remaining
+    // pixels are given to the plain C++ versions
+    ////////////////////////////////////////////////////////////
+    SFML_TARGET_SSE2 __m128i BlendHalfSSE2(__m128i Src, __m128i Dst, __m128i Alpha)
+    {
+        // Src * Alpha + Dst * (255 - Alpha), divided by 255 ; all in 16 bits
+        const __m128i Max = _mm_set1_epi16(255);
+        const __m128i One = _mm_set1_epi16(1);
+        __m128i Sum = _mm_add_epi16(_mm_mullo_epi16(Src, Alpha), _mm_mullo_epi16(Dst, _mm_sub_epi16(Max, Alpha)));
+
+        return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(Sum, One), _mm_srli_epi16(Sum, 8)), 8);
+    }
+
+    SFML_TARGET_SSE2 void BlendRGBSSE2(sf::Uint8* Dst, const sf::Uint8* Src, std::size_t Count)
+    {
+        const __m128i Zero      = _mm_setzero_si128();
+        const __m128i AlphaMask = _mm_set1_epi32(0x00FFFFFF);
+
+        std::size_t NbBlocks = Count / 4;
+        for (std::size_t i = 0; i < NbBlocks; ++i, Src += 16, Dst += 16)
+        {
+            __m128i S = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src));
+            __m128i D = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Dst));
+
+            // Spread the source alpha over the RGB components ; the alpha component gets 0, which keeps the destination alpha
+            __m128i A = _mm_srli_epi32(S, 24);
+            A = _mm_or_si128(A, _mm_slli_epi32(A, 8));
+            A = _mm_or_si128(A, _mm_slli_epi32(A, 8));
+            A = _mm_and_si128(A, AlphaMask);
+
+            __m128i Low  = BlendHalfSSE2(_mm_unpacklo_epi8(S, Zero), _mm_unpacklo_epi8(D, Zero), _mm_unpacklo_epi8(A, Zero));
+            __m128i High = BlendHalfSSE2(_mm_unpackhi_epi8(S, Zero), _mm_unpackhi_epi8(D, Zero), _mm_unpackhi_epi8(A, Zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Dst), _mm_packus_epi16(Low, High));
+        }
+
+        BlendRGBScalar(Dst, Src, Count % 4);
+    }
+
+    SFML_TARGET_SSE2 void ReplaceColorSSE2(sf::Uint8* Pixels, std::size_t Count, sf::Uint32 Key, sf::Uint32 Replacement)
+    {
+        const __m128i K = _mm_set1_epi32(static_cast<int>(Key));
+        const __m128i R = _mm_set1_epi32(static_cast<int>(Replacement));
+
+        std::size_t NbBlocks = Count / 4;
+        for (std::size_t i = 0; i < NbBlocks; ++i, Pixels += 16)
+        {
+            __m128i P    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Pixels));
+            __m128i Mask = _mm_cmpeq_epi32(P, K);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Pixels), _mm_or_si128(_mm_and_si128(Mask, R), _mm_andnot_si128(Mask, P)));
+        }
+
+        ReplaceColorScalar(Pixels, Count % 4, Key, Replacement);
+    }
+
+    SFML_TARGET_SSE2 void FillSSE2(sf::Uint8* Pixels, std::size_t Count, sf::Uint32 Value)
+    {
+        const __m128i V = _mm_set1_epi32(static_cast<int>(Value));
+
+        std::size_t NbBlocks = Count / 4;
+        for (std::size_t i = 0; i < NbBlocks; ++i, Pixels += 16)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Pixels), V);
+
+        FillScalar(Pixels, Count % 4, Value);
+    }
+
+    SFML_TARGET_SSE2 void ExpandRGBSSE2(sf::Uint8* Dst, const sf::Uint8* Src, std::size_t Count)
+    {
+        const __m128i Alpha = _mm_set1_epi32(static_cast<int>(ToPixel(sf::Color(0, 0, 0, 255))));
+
+        // Each block reads 16 bytes but only consumes 12, so the last
+        // block must stop early enough to stay inside the source
+        std::size_t NbBlocks = Count > 2 ? (Count - 2) / 4 : 0;
+        for (std::size_t i = 0; i < NbBlocks; ++i, Src += 12, Dst += 16)
+        {
+            // Bring each of the 4 pixels to the first lane of a register, then gather the first lanes
+            __m128i P0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src));
+            __m128i P1 = _mm_srli_si128(P0, 3);
+            __m128i P2 = _mm_srli_si128(P0, 6);
+            __m128i P3 = _mm_srli_si128(P0, 9);
+            __m128i P  = _mm_unpacklo_epi64(_mm_unpacklo_epi32(P0, P1), _mm_unpacklo_epi32(P2, P3));
+
+            // The 4th byte of each lane belongs to the next pixel : overwrite it with an opaque alpha
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Dst), _mm_or_si128(P, Alpha));
+        }
+
+        ExpandRGBScalar(Dst, Src, Count - NbBlocks * 4);
+    }
+
+    SFML_TARGET_SSE2 void MultiplyAddSSE2(float* Acc, const float* Src, float Weight, std::size_t Count)
+    {
+        const __m128 W = _mm_set1_ps(Weight);
+
+        std::size_t NbBlocks = Count / 4;
+        for (std::size_t i = 0; i < NbBlocks; ++i, Acc += 4, Src += 4)
+            _mm_storeu_ps(Acc, _mm_add_ps(_mm_loadu_ps(Acc), _mm_mul_ps(_mm_loadu_ps(Src), W)));
+
+        MultiplyAddScalar(Acc, Src, Weight, Count % 4);
+    }
+
+    SFML_TARGET_SSE2 void ConvolveRGBASSE2(float* Dst, const float* Src, const unsigned int* First, const float* Weights, std::size_t NbTaps, std::size_t Count)
+    {
+        // A RGBA pixel fills exactly one register
+        for (std::size_t i = 0; i < Count; ++i, Dst += 4)
+        {
+            const float* In  = Src + First[i] * 4;
+            __m128       Sum = _mm_setzero_ps();
+            for (std::size_t j = 0; j < NbTaps; ++j, In += 4, ++Weights)
+                Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_loadu_ps(In), _mm_set1_ps(*Weights)));
+            _mm_storeu_ps(Dst, Sum);
+        }
+    }
+
+    SFML_TARGET_SSE2 __m128i SumPairsSSE2(const sf::Uint8* Row0, const sf::Uint8* Row1)
+    {
+        // Sum the 2 rows of 4 pixels in 16 bits, then the pixels 0 + 1 and 2 + 3
+        const __m128i Zero = _mm_setzero_si128();
+        __m128i A  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row0));
+        __m128i B  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Row1));
+        __m128i Lo = _mm_add_epi16(_mm_unpacklo_epi8(A, Zero), _mm_unpacklo_epi8(B, Zero));
+        __m128i Hi = _mm_add_epi16(_mm_unpackhi_epi8(A, Zero), _mm_unpackhi_epi8(B, Zero));
+
+        return _mm_add_epi16(_mm_unpacklo_epi64(Lo, Hi), _mm_unpackhi_epi64(Lo, Hi));
+    }
+
+    SFML_TARGET_SSE2 void HalveRowsSSE2(sf::Uint8* Dst, const sf::Uint8* Row0, const sf::Uint8* Row1, std::size_t Count)
+    {
+        const __m128i Two = _mm_set1_epi16(2);
+
+        std::size_t NbBlocks = Count / 4;
+        for (std::size_t i = 0; i < NbBlocks; ++i, Row0 += 32, Row1 += 32, Dst += 16)
+        {
+            __m128i First  = _mm_srli_epi16(_mm_add_epi16(SumPairsSSE2(Row0,      Row1),      Two), 2);
+            __m128i Second = _mm_srli_epi16(_mm_add_epi16(SumPairsSSE2(Row0 + 16, Row1 + 16), Two), 2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(Dst), _mm_packus_epi16(First, Second));
+        }
+
+        HalveRowsScalar(Dst, Row0, Row1, Count % 4);
+    }
+
+    ////////////////////////////////////////////////////////////
+    // Ask the CPU whether it supports SSE2
+    ////////////////////////////////////////////////////////////
+    bool DetectSSE2()
+    {
+        #if defined(_M_X64) || defined(__x86_64__)
+
+            // Every 64 bits x86 CPU has SSE2
+            return true;
+
+        #elif defined(_MSC_VER)
+
+            int Info[4];
+            __cpuid(Info, 1);
+            return (Info[3] & (1 << 26)) != 0;
+
+        #else
+
+            unsigned int A, B, C, D;
+            if (!__get_cpuid(1, &A, &B, &C, &D))
+                return false;
+            return (D & (1 << 26)) != 0;
+
+        #endif
+    }
+
+#endif // SFML_PIXELKERNELS_SSE2
+}
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// Interpolate the RGB components of destination pixels
+/// with source pixels, using the alpha of the source
+////////////////////////////////////////////////////////////
+void PixelKernels::BlendRGB(Uint8* Dst, const Uint8* Src, std::size_t Count)
+{
+#ifdef SFML_PIXELKERNELS_SSE2
+    if (HasSSE2())
+    {
+        BlendRGBSSE2(Dst, Src, Count);
+        return;
+    }
+#endif
+
+    BlendRGBScalar(Dst, Src, Count);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Replace the pixels of a given color by another one
+////////////////////////////////////////////////////////////
+void PixelKernels::ReplaceColor(Uint8* Pixels, std::size_t Count, const Color& Key, const Color& Replacement)
+{
+#ifdef SFML_PIXELKERNELS_SSE2
+    if (HasSSE2())
+    {
+        ReplaceColorSSE2(Pixels, Count, ToPixel(Key), ToPixel(Replacement));
+        return;
+    }
+#endif
+
+    ReplaceColorScalar(Pixels, Count, ToPixel(Key), ToPixel(Replacement));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Fill pixels with a color
+////////////////////////////////////////////////////////////
+void PixelKernels::Fill(Uint8* Pixels, std::size_t Count, const Color& Col)
+{
+#ifdef SFML_PIXELKERNELS_SSE2
+    if (HasSSE2())
+    {
+        FillSSE2(Pixels, Count, ToPixel(Col));
+        return;
+    }
+#endif
+
+    FillScalar(Pixels, Count, ToPixel(Col));
+}
+
+
+////////////////////////////////////////////////////////////
+/// Convert RGB pixels to opaque RGBA pixels
+////////////////////////////////////////////////////////////
+void PixelKernels::ExpandRGB(Uint8* Dst, const Uint8* Src, std::size_t Count)
+{
+#ifdef SFML_PIXELKERNELS_SSE2
+    if (HasSSE2())
+    {
+        ExpandRGBSSE2(Dst, Src, Count);
+        return;
+    }
+#endif
+
+    ExpandRGBScalar(Dst, Src, Count);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Reduce two rows of pixels to one row of half the width
+////////////////////////////////////////////////////////////
+void PixelKernels::HalveRows(Uint8* Dst, const Uint8* Row0, const Uint8* Row1, std::size_t Count)
+{
+#ifdef SFML_PIXELKERNELS_SSE2
+    if (HasSSE2())
+    {
+        HalveRowsSSE2(Dst, Row0, Row1, Count);
+        return;
+    }
+#endif
+
+    HalveRowsScalar(Dst, Row0, Row1, Count);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Add values multiplied by a weight to an accumulator
+////////////////////////////////////////////////////////////
+void PixelKernels::MultiplyAdd(float* Acc, const float* Src, float Weight, std::size_t Count)
+{
+#ifdef SFML_PIXELKERNELS_SSE2
+    if (HasSSE2())
+    {
+        MultiplyAddSSE2(Acc, Src, Weight, Count);
+        return;
+    }
+#endif
+
+    MultiplyAddScalar(Acc, Src, Weight, Count);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Compute a row of float RGBA pixels as weighted sums of
+/// consecutive pixels of a source row
+////////////////////////////////////////////////////////////
+void PixelKernels::ConvolveRGBA(float* Dst, const float* Src, const unsigned int* First, const float* Weights, std::size_t NbTaps, std::size_t Count)
+{
+#ifdef SFML_PIXELKERNELS_SSE2
+    if (HasSSE2())
+    {
+        ConvolveRGBASSE2(Dst, Src, First, Weights, NbTaps, Count);
+        return;
+    }
+#endif
+
+    ConvolveRGBAScalar(Dst, Src, First, Weights, NbTaps, Count);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Tell whether the SSE2 versions of the routines are used
+////////////////////////////////////////////////////////////
+bool PixelKernels::HasSSE2()
+{
+#ifdef SFML_PIXELKERNELS_SSE2
+    static bool Supported = DetectSSE2();
+    return Supported;
+#else
+    return false;
+#endif
+}
+
+} // namespace priv
+
+} // namespace sf
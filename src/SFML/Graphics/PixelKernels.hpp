@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_PIXELKERNELS_HPP
+#define SFML_PIXELKERNELS_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <cstddef>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// Routines processing runs of pixels ; SSE2 versions
+/// are used when the CPU supports them, the other ones
+/// fall back to plain C++ with the same results.
+/// This class is for internal use only
+////////////////////////////////////////////////////////////
+class PixelKernels
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Interpolate the RGB components of destination pixels
+    /// with source pixels, using the alpha of the source ;
+    /// the alpha of the destination is left untouched
+    ///
+    /// \param Dst :   Pixels to modify
+    /// \param Src :   Pixels to blend
+    /// \param Count : Number of pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    static void BlendRGB(Uint8* Dst, const Uint8* Src, std::size_t Count);
+
+    ////////////////////////////////////////////////////////////
+    /// Replace the pixels of a given color by another one
+    ///
+    /// \param Pixels :      Pixels to modify
+    /// \param Count :       Number of pixels
+    /// \param Key :         Color to replace
+    /// \param Replacement : New color of the replaced pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    static void ReplaceColor(Uint8* Pixels, std::size_t Count, const Color& Key, const Color& Replacement);
+
+    ////////////////////////////////////////////////////////////
+    /// Fill pixels with a color
+    ///
+    /// \param Pixels : Pixels to fill
+    /// \param Count :  Number of pixels
+    /// \param Col :    Color to fill with
+    ///
+    ////////////////////////////////////////////////////////////
+    static void Fill(Uint8* Pixels, std::size_t Count, const Color& Col);
+
+    ////////////////////////////////////////////////////////////
+    /// Convert RGB pixels to opaque RGBA pixels
+    ///
+    /// \param Dst :   RGBA pixels to write (must not overlap Src)
+    /// \param Src :   RGB pixels to convert
+    /// \param Count : Number of pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    static void ExpandRGB(Uint8* Dst, const Uint8* Src, std::size_t Count);
+
+    ////////////////////////////////////////////////////////////
+    /// Reduce two rows of pixels to one row of half the width,
+    /// each pixel being the rounded average of a 2x2 block
+    ///
+    /// \param Dst :   Pixels to write
+    /// \param Row0 :  First source row (2 * Count pixels)
+    /// \param Row1 :  Second source row (2 * Count pixels)
+    /// \param Count : Number of pixels to write
+    ///
+    ////////////////////////////////////////////////////////////
+    static void HalveRows(Uint8* Dst, const Uint8* Row0, const Uint8* Row1, std::size_t Count);
+
+    ////////////////////////////////////////////////////////////
+    /// Add values multiplied by a weight to an accumulator
+    ///
+    /// \param Acc :    Accumulated values
+    /// \param Src :    Values to add
+    /// \param Weight : Weight of the added values
+    /// \param Count :  Number of values
+    ///
+    ////////////////////////////////////////////////////////////
+    static void MultiplyAdd(float* Acc, const float* Src, float Weight, std::size_t Count);
+
+    ////////////////////////////////////////////////////////////
+    /// Compute a row of float RGBA pixels as weighted sums of
+    /// consecutive pixels of a source row
+    ///
+    /// \param Dst :     Pixels to write
+    /// \param Src :     Source pixels
+    /// \param First :   Index of the first source pixel of each destination pixel
+    /// \param Weights : Weights of the source pixels (NbTaps per destination pixel)
+    /// \param NbTaps :  Number of source pixels per destination pixel
+    /// \param Count :   Number of pixels to write
+    ///
+    ////////////////////////////////////////////////////////////
+    static void ConvolveRGBA(float* Dst, const float* Src, const unsigned int* First, const float* Weights, std::size_t NbTaps, std::size_t Count);
+
+    ////////////////////////////////////////////////////////////
+    /// Tell whether the SSE2 versions of the routines are used
+    ///
+    /// \return True if the CPU supports SSE2
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool HasSSE2();
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_PIXELKERNELS_HPP
@@ -27,12 +27,14 @@
 // Headers
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/PostFX.hpp>
-#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/GLStateCache.hpp>
 #include <fstream>
 #include <iostream>
 #include <set>
 #include <sstream>
+#include <vector>
 
 
 namespace sf
@@ -41,7 +43,9 @@ namespace sf
 /// Default constructor
 ////////////////////////////////////////////////////////////
 PostFX::PostFX() :
-myShaderProgram(0)
+myShaderProgram   (0),
+myTexturesModified(false),
+myInput           (NULL)
 {
     // No filtering on frame buffer
     myFrameBuffer.SetSmooth(false);
@@ -52,15 +56,25 @@ myShaderProgram(0)
 /// Copy constructor
 ////////////////////////////////////////////////////////////
 PostFX::PostFX(const PostFX& Copy) :
-Drawable        (Copy),
-myShaderProgram (0),
-myTextures      (Copy.myTextures),
-myFragmentShader(Copy.myFragmentShader),
-myFrameBuffer   (Copy.myFrameBuffer)
+Drawable          (Copy),
+myShaderProgram   (0),
+myTextures        (Copy.myTextures),
+myParameters      (Copy.myParameters),
+myTexturesModified(false),
+myFragmentShader  (Copy.myFragmentShader),
+myFrameBuffer     (Copy.myFrameBuffer),
+myInput           (NULL)
 {
     // No filtering on frame buffer
     myFrameBuffer.SetSmooth(false);
 
+    // Textures referring to the frame buffer of the copied effect must use ours
+    for (TextureTable::iterator i = myTextures.begin(); i != myTextures.end(); ++i)
+    {
+        if (i->second == &Copy.myFrameBuffer)
+            i->second = &myFrameBuffer;
+    }
+
     // Create the shaders and the program
     if (Copy.myShaderProgram)
         CreateProgram();
@@ -129,21 +143,7 @@ bool PostFX::LoadFromMemory(const std::string& Effect)
 ////////////////////////////////////////////////////////////
 void PostFX::SetParameter(const std::string& Name, float X)
 {
-    if (myShaderProgram)
-    {
-        // Enable program
-        GLCheck(glUseProgramObjectARB(myShaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint Location = glGetUniformLocationARB(myShaderProgram, Name.c_str());
-        if (Location != -1)
-            GLCheck(glUniform1fARB(Location, X));
-        else
-            std::cerr << "Parameter \"" << Name << "\" not found in post-effect" << std::endl;
-
-        // Disable program
-        GLCheck(glUseProgramObjectARB(0));
-    }
+    StageParameter(Name, 1, X, 0.f, 0.f, 0.f);
 }
 
 
@@ -152,21 +152,7 @@ void PostFX::SetParameter(const std::string& Name, float X)
 ////////////////////////////////////////////////////////////
 void PostFX::SetParameter(const std::string& Name, float X, float Y)
 {
-    if (myShaderProgram)
-    {
-        // Enable program
-        GLCheck(glUseProgramObjectARB(myShaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint Location = glGetUniformLocationARB(myShaderProgram, Name.c_str());
-        if (Location != -1)
-            GLCheck(glUniform2fARB(Location, X, Y));
-        else
-            std::cerr << "Parameter \"" << Name << "\" not found in post-effect" << std::endl;
-
-        // Disable program
-        GLCheck(glUseProgramObjectARB(0));
-    }
+    StageParameter(Name, 2, X, Y, 0.f, 0.f);
 }
 
 
@@ -175,21 +161,7 @@ void PostFX::SetParameter(const std::string& Name, float X, float Y)
 ////////////////////////////////////////////////////////////
 void PostFX::SetParameter(const std::string& Name, float X, float Y, float Z)
 {
-    if (myShaderProgram)
-    {
-        // Enable program
-        GLCheck(glUseProgramObjectARB(myShaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint Location = glGetUniformLocationARB(myShaderProgram, Name.c_str());
-        if (Location != -1)
-            GLCheck(glUniform3fARB(Location, X, Y, Z));
-        else
-            std::cerr << "Parameter \"" << Name << "\" not found in post-effect" << std::endl;
-
-        // Disable program
-        GLCheck(glUseProgramObjectARB(0));
-    }
+    StageParameter(Name, 3, X, Y, Z, 0.f);
 }
 
 
@@ -198,21 +170,7 @@ void PostFX::SetParameter(const std::string& Name, float X, float Y, float Z)
 ////////////////////////////////////////////////////////////
 void PostFX::SetParameter(const std::string& Name, float X, float Y, float Z, float W)
 {
-    if (myShaderProgram)
-    {
-        // Enable program
-        GLCheck(glUseProgramObjectARB(myShaderProgram));
-
-        // Get parameter location and assign it new values
-        GLint Location = glGetUniformLocationARB(myShaderProgram, Name.c_str());
-        if (Location != -1)
-            GLCheck(glUniform4fARB(Location, X, Y, Z, W));
-        else
-            std::cerr << "Parameter \"" << Name << "\" not found in post-effect" << std::endl;
-
-        // Disable program
-        GLCheck(glUseProgramObjectARB(0));
-    }
+    StageParameter(Name, 4, X, Y, Z, W);
 }
 
 
@@ -231,15 +189,15 @@ void PostFX::SetTexture(const std::string& Name, Image* Texture)
     }
 
     // Make sure the given name is a valid variable in the effect
-    int Location = glGetUniformLocationARB(myShaderProgram, Name.c_str());
-    if (Location == -1)
+    if (myParameters.find(Name) == myParameters.end())
     {
         std::cerr << "Texture \"" << Name << "\" not found in post-effect" << std::endl;
         return;
     }
 
-    // Store the texture for later use
+    // Store the texture for later use ; texture units will have to be assigned again
     myTextures[Name] = Texture ? Texture : &myFrameBuffer;
+    myTexturesModified = true;
 }
 
 
@@ -250,10 +208,19 @@ PostFX& PostFX::operator =(const PostFX& Other)
 {
     PostFX Temp(Other);
 
-    std::swap(myShaderProgram,  Temp.myShaderProgram);
-    std::swap(myTextures,       Temp.myTextures);
-    std::swap(myFragmentShader, Temp.myFragmentShader);
-    std::swap(myFrameBuffer,    Temp.myFrameBuffer);
+    std::swap(myShaderProgram,    Temp.myShaderProgram);
+    std::swap(myTextures,         Temp.myTextures);
+    std::swap(myParameters,       Temp.myParameters);
+    std::swap(myTexturesModified, Temp.myTexturesModified);
+    std::swap(myFragmentShader,   Temp.myFragmentShader);
+    std::swap(myFrameBuffer,      Temp.myFrameBuffer);
+
+    // Textures referring to the frame buffer of the temporary copy must use ours
+    for (TextureTable::iterator i = myTextures.begin(); i != myTextures.end(); ++i)
+    {
+        if (i->second == &Temp.myFrameBuffer)
+            i->second = &myFrameBuffer;
+    }
 
     return *this;
 }
@@ -274,6 +241,16 @@ bool PostFX::CanUsePostFX()
 }
 
 
+////////////////////////////////////////////////////////////
+/// /see Drawable::ReadsTarget
+////////////////////////////////////////////////////////////
+bool PostFX::ReadsTarget() const
+{
+    // Post-effects work on what has been drawn before them
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// /see Drawable::Render
 ////////////////////////////////////////////////////////////
@@ -283,36 +260,50 @@ void PostFX::Render(RenderTarget& Target) const
     if (!myShaderProgram)
         return;
 
-    // Copy the current framebuffer pixels to our frame buffer texture
-    // The ugly cast is temporary until PostFx are rewritten :)
-    myFrameBuffer.CopyScreen((RenderWindow&)Target);
+    // Copy the current framebuffer pixels to our frame buffer texture,
+    // unless we're given the image to process
+    const Image* Input = myInput;
+    if (!Input)
+    {
+        myFrameBuffer.CopyScreen(Target);
+        Input = &myFrameBuffer;
+    }
 
-    // Enable program
+    // Enable program, and send it the parameters which changed
     GLCheck(glUseProgramObjectARB(myShaderProgram));
+    UploadParameters();
 
-    // Bind textures
+    // Bind textures ; the texture units are assigned only when they change
     TextureTable::const_iterator ItTex = myTextures.begin();
     for (std::size_t i = 0; i < myTextures.size(); ++i)
     {
-        int Location = glGetUniformLocationARB(myShaderProgram, ItTex->first.c_str());
-        GLCheck(glUniform1iARB(Location, static_cast<GLint>(i)));
+        if (myTexturesModified)
+            GLCheck(glUniform1iARB(myParameters[ItTex->first].Location, static_cast<GLint>(i)));
         GLCheck(glActiveTextureARB(static_cast<GLenum>(GL_TEXTURE0_ARB + i)));
-        ItTex->second->Bind();
+        priv::GLStateCache::ForgetTextures();
+        const Image* Texture = (ItTex->second == &myFrameBuffer) ? Input : ItTex->second;
+        Texture->Bind();
         ItTex++;
     }
+    myTexturesModified = false;
 
-    // Compute the texture coordinates (in case the texture is larger than the screen, or flipped)
-    IntRect FrameBufferRect(0, 0, myFrameBuffer.GetWidth(), myFrameBuffer.GetHeight());
-    FloatRect TexCoords = myFrameBuffer.GetTexCoords(FrameBufferRect);
+    // Compute the texture coordinates (in case the texture is larger than the screen)
+    IntRect FrameBufferRect(0, 0, Input->GetWidth(), Input->GetHeight());
+    FloatRect TexCoords = Input->GetTexCoords(FrameBufferRect);
 
-    // Render a fullscreen quad using the effect on our framebuffer
-    FloatRect Screen = Target.GetView().GetRect();
+    // Render a fullscreen quad using the effect on our framebuffer ; it is defined
+    // directly in normalized device coordinates, so that each row of the frame buffer
+    // goes back where it was copied from, whatever the orientation of the target
+    priv::GLStateCache::SetMatrixMode(GL_PROJECTION); GLCheck(glPushMatrix()); GLCheck(glLoadIdentity());
+    priv::GLStateCache::SetMatrixMode(GL_MODELVIEW);  GLCheck(glPushMatrix()); GLCheck(glLoadIdentity());
     glBegin(GL_QUADS);
-         glTexCoord2f(TexCoords.Left,  TexCoords.Top);    glVertex2f(Screen.Left,  Screen.Bottom);
-         glTexCoord2f(TexCoords.Right, TexCoords.Top);    glVertex2f(Screen.Right, Screen.Bottom);
-         glTexCoord2f(TexCoords.Right, TexCoords.Bottom); glVertex2f(Screen.Right, Screen.Top);
-         glTexCoord2f(TexCoords.Left,  TexCoords.Bottom); glVertex2f(Screen.Left,  Screen.Top);
+         glTexCoord2f(TexCoords.Left,  TexCoords.Top);    glVertex2f(-1.f, -1.f);
+         glTexCoord2f(TexCoords.Right, TexCoords.Top);    glVertex2f( 1.f, -1.f);
+         glTexCoord2f(TexCoords.Right, TexCoords.Bottom); glVertex2f( 1.f,  1.f);
+         glTexCoord2f(TexCoords.Left,  TexCoords.Bottom); glVertex2f(-1.f,  1.f);
     glEnd();
+    priv::GLStateCache::SetMatrixMode(GL_PROJECTION); GLCheck(glPopMatrix());
+    priv::GLStateCache::SetMatrixMode(GL_MODELVIEW);  GLCheck(glPopMatrix());
 
     // Disable program
     GLCheck(glUseProgramObjectARB(0));
@@ -324,6 +315,9 @@ void PostFX::Render(RenderTarget& Target) const
         GLCheck(glBindTexture(GL_TEXTURE_2D, 0));
     }
     GLCheck(glActiveTextureARB(GL_TEXTURE0_ARB));
+
+    // Textures have been bound and enabled on several units
+    priv::GLStateCache::ForgetTextures();
 }
 
 
@@ -501,6 +495,105 @@ void PostFX::CreateProgram()
         myShaderProgram = 0;
         return;
     }
+
+    // Find the variables of the program once for all
+    ReadParameters();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Find the locations of all the variables of the program
+////////////////////////////////////////////////////////////
+void PostFX::ReadParameters()
+{
+    GLint NbUniforms = 0, MaxLength = 0;
+    GLCheck(glGetObjectParameterivARB(myShaderProgram, GL_OBJECT_ACTIVE_UNIFORMS_ARB, &NbUniforms));
+    GLCheck(glGetObjectParameterivARB(myShaderProgram, GL_OBJECT_ACTIVE_UNIFORM_MAX_LENGTH_ARB, &MaxLength));
+
+    ParameterTable Parameters;
+    std::vector<GLcharARB> Buffer(MaxLength + 1);
+    for (GLint i = 0; i < NbUniforms; ++i)
+    {
+        GLsizei Length = 0;
+        GLint   Size;
+        GLenum  Type;
+        GLCheck(glGetActiveUniformARB(myShaderProgram, i, static_cast<GLsizei>(Buffer.size()), &Length, &Size, &Type, &Buffer[0]));
+
+        // Skip the built-in variables, and refer to arrays by their name only
+        std::string Name(&Buffer[0], Length);
+        if (Name.compare(0, 3, "gl_") == 0)
+            continue;
+        if ((Name.size() > 3) && (Name.compare(Name.size() - 3, 3, "[0]") == 0))
+            Name.erase(Name.size() - 3);
+
+        // Keep the values already stored for this variable, they will be sent to the new program
+        Parameter& Param = Parameters[Name];
+        ParameterTable::const_iterator Previous = myParameters.find(Name);
+        if (Previous != myParameters.end())
+            Param = Previous->second;
+        else
+            Param.NbValues = 0;
+
+        Param.Location = glGetUniformLocationARB(myShaderProgram, Name.c_str());
+        Param.Modified = Param.NbValues > 0;
+    }
+
+    myParameters.swap(Parameters);
+    myTexturesModified = true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Store the new value of a parameter of the effect
+////////////////////////////////////////////////////////////
+void PostFX::StageParameter(const std::string& Name, int NbValues, float X, float Y, float Z, float W)
+{
+    if (myShaderProgram)
+    {
+        ParameterTable::iterator It = myParameters.find(Name);
+        if (It != myParameters.end())
+        {
+            // Only a different value will need to be sent to the program
+            Parameter& Param = It->second;
+            if ((Param.NbValues != NbValues) || (Param.Values[0] != X) || (Param.Values[1] != Y) || (Param.Values[2] != Z) || (Param.Values[3] != W))
+            {
+                Param.NbValues  = NbValues;
+                Param.Values[0] = X;
+                Param.Values[1] = Y;
+                Param.Values[2] = Z;
+                Param.Values[3] = W;
+                Param.Modified  = true;
+            }
+        }
+        else
+        {
+            std::cerr << "Parameter \"" << Name << "\" not found in post-effect" << std::endl;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Send the parameters changed since the last render to
+/// the program
+////////////////////////////////////////////////////////////
+void PostFX::UploadParameters() const
+{
+    for (ParameterTable::iterator i = myParameters.begin(); i != myParameters.end(); ++i)
+    {
+        Parameter& Param = i->second;
+        if (Param.Modified)
+        {
+            switch (Param.NbValues)
+            {
+                case 1 : GLCheck(glUniform1fARB(Param.Location, Param.Values[0]));                                                   break;
+                case 2 : GLCheck(glUniform2fARB(Param.Location, Param.Values[0], Param.Values[1]));                                  break;
+                case 3 : GLCheck(glUniform3fARB(Param.Location, Param.Values[0], Param.Values[1], Param.Values[2]));                 break;
+                case 4 : GLCheck(glUniform4fARB(Param.Location, Param.Values[0], Param.Values[1], Param.Values[2], Param.Values[3])); break;
+            }
+            Param.Modified = false;
+        }
+    }
 }
 
 } // namespace sf
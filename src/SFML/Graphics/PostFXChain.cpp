@@ -0,0 +1,191 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/PostFXChain.hpp>
+#include <algorithm>
+#include <iostream>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// Default constructor
+////////////////////////////////////////////////////////////
+PostFXChain::PostFXChain() :
+myWidth (0),
+myHeight(0)
+{
+    for (int i = 0; i < NbResolutions; ++i)
+        myImages[i][0] = myImages[i][1] = NULL;
+
+    // The final result replaces the contents of the target
+    myResult.SetBlendMode(Blend::None);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destructor
+////////////////////////////////////////////////////////////
+PostFXChain::~PostFXChain()
+{
+    for (int i = 0; i < NbResolutions; ++i)
+    {
+        delete myImages[i][0];
+        delete myImages[i][1];
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Create the off-screen image receiving the scene
+////////////////////////////////////////////////////////////
+bool PostFXChain::Create(unsigned int Width, unsigned int Height)
+{
+    // Destroy the images of the previous size
+    for (int i = 0; i < NbResolutions; ++i)
+    {
+        delete myImages[i][0];
+        delete myImages[i][1];
+        myImages[i][0] = myImages[i][1] = NULL;
+    }
+
+    myWidth  = Width;
+    myHeight = Height;
+
+    myImages[PassResolution::Full][0] = new RenderImage;
+    if (!myImages[PassResolution::Full][0]->Create(Width, Height))
+    {
+        std::cerr << "Failed to create post-effect chain : cannot create the scene image" << std::endl;
+        delete myImages[PassResolution::Full][0];
+        myImages[PassResolution::Full][0] = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the render image to draw the scene into
+////////////////////////////////////////////////////////////
+RenderImage& PostFXChain::GetScene()
+{
+    static RenderImage Invalid;
+    return myImages[PassResolution::Full][0] ? *myImages[PassResolution::Full][0] : Invalid;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Add an effect at the end of the chain
+////////////////////////////////////////////////////////////
+void PostFXChain::AddEffect(const PostFX& Effect, PassResolution::Mode Resolution)
+{
+    Pass NewPass;
+    NewPass.Effect     = &Effect;
+    NewPass.Resolution = Resolution;
+    myPasses.push_back(NewPass);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove all the effects of the chain
+////////////////////////////////////////////////////////////
+void PostFXChain::ClearEffects()
+{
+    myPasses.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Apply the effects to the scene, and draw the result
+////////////////////////////////////////////////////////////
+void PostFXChain::Draw(RenderTarget& Target)
+{
+    RenderImage* Source = myImages[PassResolution::Full][0];
+    if (!Source)
+        return;
+
+    // Finish drawing the scene
+    Source->Flush();
+    Source->Display();
+
+    // Apply the effects one after the other, each one reading the result of the previous one
+    for (std::vector<Pass>::const_iterator i = myPasses.begin(); i != myPasses.end(); ++i)
+    {
+        // Effects that failed to load would just erase the image
+        if (!i->Effect->myShaderProgram)
+            continue;
+
+        RenderImage* Destination = GetPassTarget(i->Resolution, Source);
+        if (!Destination)
+            continue;
+
+        Destination->Clear(Color(0, 0, 0, 0));
+        i->Effect->myInput = &Source->GetImage();
+        Destination->Draw(*i->Effect);
+        Destination->Flush();
+        i->Effect->myInput = NULL;
+        Destination->Display();
+
+        Source = Destination;
+    }
+
+    // Draw the result over the current view of the target
+    const FloatRect& Rect = Target.GetView().GetRect();
+    myResult.SetImage(Source->GetImage());
+    myResult.SetSubRect(IntRect(0, 0, Source->GetWidth(), Source->GetHeight()));
+    myResult.SetPosition(Rect.Left, Rect.Top);
+    myResult.Resize(Rect.GetWidth(), Rect.GetHeight());
+    Target.Draw(myResult);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the image receiving a pass, creating it if needed
+////////////////////////////////////////////////////////////
+RenderImage* PostFXChain::GetPassTarget(PassResolution::Mode Resolution, const RenderImage* Source)
+{
+    // Use the image of this resolution which is not being read
+    int Index = (myImages[Resolution][0] == Source) ? 1 : 0;
+    RenderImage*& Image = myImages[Resolution][Index];
+
+    if (!Image)
+    {
+        unsigned int Divisor = 1 << Resolution;
+        Image = new RenderImage;
+        if (!Image->Create(std::max(myWidth / Divisor, 1u), std::max(myHeight / Divisor, 1u)))
+        {
+            delete Image;
+            Image = NULL;
+        }
+    }
+
+    return Image;
+}
+
+} // namespace sf
@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/RenderImage.hpp>
+#include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Window/Context.hpp>
+#include <iostream>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// Default constructor
+////////////////////////////////////////////////////////////
+RenderImage::RenderImage() :
+myContext    (NULL),
+myFrameBuffer(0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destructor
+////////////////////////////////////////////////////////////
+RenderImage::~RenderImage()
+{
+    if (myContext)
+    {
+        // The frame buffer object belongs to our context
+        myContext->SetActive(true);
+        if (myFrameBuffer)
+        {
+            GLuint FrameBuffer = static_cast<GLuint>(myFrameBuffer);
+            GLCheck(glDeleteFramebuffersEXT(1, &FrameBuffer));
+        }
+        myContext->SetActive(false);
+
+        delete myContext;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Create the render image
+////////////////////////////////////////////////////////////
+bool RenderImage::Create(unsigned int Width, unsigned int Height)
+{
+    // Check that we can use render images
+    if (!CanUseRenderImage())
+    {
+        std::cerr << "Failed to create render image : your system doesn't support frame buffer objects" << std::endl;
+        return false;
+    }
+
+    // Create the target image, and upload its initial pixels before drawing into it
+    if (!myImage.Create(Width, Height, Color(0, 0, 0, 0)))
+    {
+        std::cerr << "Failed to create render image : cannot create the target image" << std::endl;
+        return false;
+    }
+    myImage.EnsureTextureUpdate();
+
+    // Frame buffer objects are not shared between contexts, so we need our own
+    if (!myContext)
+        myContext = new Context;
+    myContext->SetActive(true);
+
+    if (!myFrameBuffer)
+    {
+        GLuint FrameBuffer = 0;
+        GLCheck(glGenFramebuffersEXT(1, &FrameBuffer));
+        myFrameBuffer = static_cast<unsigned int>(FrameBuffer);
+    }
+
+    // Attach the image texture ; the frame buffer stays bound in our context
+    GLCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, myFrameBuffer));
+    GLCheck(glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, myImage.myTexture, 0));
+    GLenum Status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
+    if (Status != GL_FRAMEBUFFER_COMPLETE_EXT)
+    {
+        std::cerr << "Failed to create render image : frame buffer object is incomplete (status " << Status << ")" << std::endl;
+        GLuint FrameBuffer = static_cast<GLuint>(myFrameBuffer);
+        GLCheck(glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0));
+        GLCheck(glDeleteFramebuffersEXT(1, &FrameBuffer));
+        myFrameBuffer = 0;
+        return false;
+    }
+
+    // We can now initialize the render target part
+    RenderTarget::Initialize();
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Finish the drawing into the render image
+////////////////////////////////////////////////////////////
+void RenderImage::Display()
+{
+    // Execute the draw calls recorded since BeginFrame, if any
+    Flush();
+
+    if (Activate(true))
+    {
+        // Make sure the drawing is finished before other contexts use the texture
+        GLCheck(glFlush());
+
+        // The pixels of the image are now in its texture only
+        myImage.NotifyTextureModified();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the image containing the drawn contents
+////////////////////////////////////////////////////////////
+const Image& RenderImage::GetImage() const
+{
+    return myImage;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the width of the rendering region of the image
+////////////////////////////////////////////////////////////
+unsigned int RenderImage::GetWidth() const
+{
+    return myImage.GetWidth();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the height of the rendering region of the image
+////////////////////////////////////////////////////////////
+unsigned int RenderImage::GetHeight() const
+{
+    return myImage.GetHeight();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Tell whether or not the system supports render images
+////////////////////////////////////////////////////////////
+bool RenderImage::CanUseRenderImage()
+{
+    // Make sure we have a valid context
+    priv::GraphicsContext Ctx;
+
+    return glewIsSupported("GL_EXT_framebuffer_object") != 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// /see RenderTarget::Activate
+////////////////////////////////////////////////////////////
+bool RenderImage::Activate(bool Active)
+{
+    // For performances and consistency reasons, we only handle activation
+    if (Active)
+    {
+        if (!myFrameBuffer)
+            return false;
+
+        myContext->SetActive(true);
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// /see RenderTarget::IsTopToBottom
+////////////////////////////////////////////////////////////
+bool RenderImage::IsTopToBottom() const
+{
+    // The rows of the texture are drawn in the same order as the image pixels
+    return true;
+}
+
+} // namespace sf
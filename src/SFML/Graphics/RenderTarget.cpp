@@ -28,7 +28,9 @@
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Drawable.hpp>
 #include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/GLStateCache.hpp>
 #include <iostream>
+#include <cstddef>
 
 
 namespace sf
@@ -39,7 +41,13 @@ namespace sf
 RenderTarget::RenderTarget() :
 myCurrentView   (&myDefaultView),
 myPreserveStates(false),
-myIsDrawing     (false)
+myIsDrawing     (false),
+myIsDeferring   (false),
+myLayer         (0),
+mySequence      (0),
+myStateCache    (new priv::GLStateCache),
+myNbSubmitted   (0),
+myNbCulled      (0)
 {
 
 }
@@ -50,7 +58,7 @@ myIsDrawing     (false)
 ////////////////////////////////////////////////////////////
 RenderTarget::~RenderTarget()
 {
-    // Nothing to do
+    delete myStateCache;
 }
 
 
@@ -59,12 +67,26 @@ RenderTarget::~RenderTarget()
 ////////////////////////////////////////////////////////////
 void RenderTarget::Clear(const Color& FillColor)
 {
+    // Everything that has been recorded would be overwritten anyway
+    if (myIsDeferring)
+    {
+        myCommands.clear();
+        myViews.clear();
+        myStates.clear();
+        mySequence = 0;
+    }
+
     if (Activate(true))
     {
         // Clear the frame buffer
         GLCheck(glClearColor(FillColor.r / 255.f, FillColor.g / 255.f, FillColor.b / 255.f, FillColor.a / 255.f));
         GLCheck(glClear(GL_COLOR_BUFFER_BIT));
 
+        // A new frame starts
+        myStateCache->ResetCounter();
+        myNbSubmitted = 0;
+        myNbCulled    = 0;
+
         Activate(false);
     }
 }
@@ -75,39 +97,79 @@ void RenderTarget::Clear(const Color& FillColor)
 ////////////////////////////////////////////////////////////
 void RenderTarget::Draw(const Drawable& Object)
 {
-    // Check whether we are called from the outside or from a previous call to Draw
+    // Skip the objects which are entirely outside the view, before doing any work for them
     if (!myIsDrawing)
     {
-        myIsDrawing = true;
+        myNbSubmitted++;
 
-        // Set our target as the current target for rendering
-        if (Activate(true))
+        FloatRect Bounds;
+        if (Object.GetGlobalBounds(Bounds))
         {
-            // Save the current render states and set the SFML ones
-            if (myPreserveStates)
+            const FloatRect& ViewRect = myCurrentView->GetRect();
+            if ((Bounds.Right < ViewRect.Left) || (Bounds.Left > ViewRect.Right) ||
+                (Bounds.Bottom < ViewRect.Top) || (Bounds.Top > ViewRect.Bottom))
             {
-                GLCheck(glPushAttrib(GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT   | GL_ENABLE_BIT  |
-                                     GL_TEXTURE_BIT      | GL_TRANSFORM_BIT | GL_VIEWPORT_BIT));
-                GLCheck(glMatrixMode(GL_MODELVIEW));  GLCheck(glPushMatrix());
-                GLCheck(glMatrixMode(GL_PROJECTION)); GLCheck(glPushMatrix());
-                SetRenderStates();
+                myNbCulled++;
+                return;
             }
+        }
+    }
+
+    // Check whether we are called from the outside or from a previous call to Draw
+    if (!myIsDrawing && myIsDeferring)
+    {
+        // Keep a copy of the view if it changed since the last call,
+        // and don't reorder the calls made with different views
+        if (myViews.empty() ||
+            (myViews.back().GetCenter()   != myCurrentView->GetCenter()) ||
+            (myViews.back().GetHalfSize() != myCurrentView->GetHalfSize()))
+        {
+            if (!myViews.empty())
+                mySequence++;
+            myViews.push_back(*myCurrentView);
+        }
+
+        // Objects reading the target must see everything drawn before them, and nothing after
+        bool Barrier = Object.ReadsTarget();
+        if (Barrier && !myCommands.empty())
+            mySequence++;
+
+        // Build the sort key : layer and sequence first, then blending mode and image
+        std::size_t ImageBits = reinterpret_cast<std::size_t>(Object.GetRenderImage());
+
+        DrawCommand Command;
+        Command.Key[0] = (static_cast<Uint32>(Object.GetBlendMode()) << 30) | (static_cast<Uint32>(ImageBits >> 4) & 0x3FFFFFFF);
+        Command.Key[1] = mySequence;
+        Command.Key[2] = myLayer;
+        Command.View   = static_cast<unsigned int>(myViews.size() - 1);
+        Command.State  = static_cast<unsigned int>(myStates.size());
+        Command.Object = &Object;
+        myCommands.push_back(Command);
 
-            // Set the window viewport and transform matrices
-            GLCheck(glViewport(0, 0, GetWidth(), GetHeight()));
-            GLCheck(glMatrixMode(GL_PROJECTION)); GLCheck(glLoadMatrixf(myCurrentView->GetMatrix().Get4x4Elements()));
-            GLCheck(glMatrixMode(GL_MODELVIEW));  GLCheck(glLoadIdentity());
+        // Save the states which may change before the call is executed
+        DrawState State;
+        State.Matrix = Object.GetMatrix();
+        State.Col    = Object.GetColor();
+        State.Mode   = Object.GetBlendMode();
+        myStates.push_back(State);
+
+        if (Barrier)
+            mySequence++;
+    }
+    else if (!myIsDrawing)
+    {
+        myIsDrawing = true;
+
+        // Set our target as the current target for rendering
+        if (Activate(true))
+        {
+            BeginDrawing();
+            ApplyView(*myCurrentView);
 
             // Let the object draw itself
             Object.Draw(*this);
 
-            // Restore render states
-            if (myPreserveStates)
-            {
-                GLCheck(glMatrixMode(GL_PROJECTION)); GLCheck(glPopMatrix());
-                GLCheck(glMatrixMode(GL_MODELVIEW));  GLCheck(glPopMatrix());
-                GLCheck(glPopAttrib());
-            }
+            EndDrawing();
 
             // Deactivate rendering on this target
             Activate(false);
@@ -123,6 +185,80 @@ void RenderTarget::Draw(const Drawable& Object)
 }
 
 
+////////////////////////////////////////////////////////////
+/// Start recording draw calls instead of executing them
+////////////////////////////////////////////////////////////
+void RenderTarget::BeginFrame()
+{
+    // Execute what is left from the previous frame
+    Flush();
+
+    myIsDeferring = true;
+    mySequence    = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Execute all the draw calls recorded since BeginFrame,
+/// and go back to immediate drawing
+////////////////////////////////////////////////////////////
+void RenderTarget::Flush()
+{
+    if (!myIsDeferring)
+        return;
+
+    myIsDeferring = false;
+
+    if (!myCommands.empty())
+    {
+        SortCommands();
+
+        myIsDrawing = true;
+
+        // Set our target as the current target for rendering
+        if (Activate(true))
+        {
+            BeginDrawing();
+
+            // Draw the objects, changing the view only when needed
+            unsigned int CurrentView = static_cast<unsigned int>(myViews.size());
+            for (std::vector<DrawCommand>::const_iterator i = myCommands.begin(); i != myCommands.end(); ++i)
+            {
+                if (i->View != CurrentView)
+                {
+                    CurrentView = i->View;
+                    ApplyView(myViews[CurrentView]);
+                }
+
+                const DrawState& State = myStates[i->State];
+                i->Object->Draw(*this, State.Matrix, State.Col, State.Mode);
+            }
+
+            EndDrawing();
+
+            // Deactivate rendering on this target
+            Activate(false);
+        }
+
+        myIsDrawing = false;
+    }
+
+    myCommands.clear();
+    myViews.clear();
+    myStates.clear();
+    mySequence = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Change the layer of the next recorded draw calls
+////////////////////////////////////////////////////////////
+void RenderTarget::SetLayer(unsigned int Layer)
+{
+    myLayer = Layer;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Change the current active view
 ////////////////////////////////////////////////////////////
@@ -164,6 +300,36 @@ void RenderTarget::PreserveOpenGLStates(bool Preserve)
 }
 
 
+////////////////////////////////////////////////////////////
+/// Get the number of OpenGL calls which were skipped because
+/// they wouldn't have changed the current states
+////////////////////////////////////////////////////////////
+unsigned int RenderTarget::GetNbElidedCalls() const
+{
+    return myStateCache->GetNbElidedCalls();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the number of objects passed to Draw since the last
+/// call to Clear
+////////////////////////////////////////////////////////////
+unsigned int RenderTarget::GetNbSubmittedObjects() const
+{
+    return myNbSubmitted;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the number of objects which were not drawn because
+/// they were entirely outside the current view
+////////////////////////////////////////////////////////////
+unsigned int RenderTarget::GetNbCulledObjects() const
+{
+    return myNbCulled;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Called by the derived class when it's ready to be initialized
 ////////////////////////////////////////////////////////////
@@ -171,6 +337,7 @@ void RenderTarget::Initialize()
 {
     // Set the default rendering states
     SetRenderStates();
+    myStateCache->Invalidate();
 
     // Setup the default view
     myDefaultView.SetFromRect(FloatRect(0, 0, static_cast<float>(GetWidth()), static_cast<float>(GetHeight())));
@@ -178,6 +345,16 @@ void RenderTarget::Initialize()
 }
 
 
+////////////////////////////////////////////////////////////
+/// Tell whether the target stores its rows top to bottom
+////////////////////////////////////////////////////////////
+bool RenderTarget::IsTopToBottom() const
+{
+    // Default targets are regular OpenGL framebuffers
+    return false;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Set the OpenGL render states needed for the SFML rendering
 ////////////////////////////////////////////////////////////
@@ -188,4 +365,107 @@ void RenderTarget::SetRenderStates()
     GLCheck(glDisable(GL_LIGHTING)); 
 }
 
+
+////////////////////////////////////////////////////////////
+/// Save the external OpenGL states if needed, and set the SFML ones
+////////////////////////////////////////////////////////////
+void RenderTarget::BeginDrawing()
+{
+    if (myPreserveStates)
+    {
+        GLCheck(glPushAttrib(GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT   | GL_ENABLE_BIT  |
+                             GL_TEXTURE_BIT      | GL_TRANSFORM_BIT | GL_VIEWPORT_BIT));
+        GLCheck(glMatrixMode(GL_MODELVIEW));  GLCheck(glPushMatrix());
+        GLCheck(glMatrixMode(GL_PROJECTION)); GLCheck(glPushMatrix());
+        SetRenderStates();
+
+        // The external code may have changed anything since the last draw
+        myStateCache->Invalidate();
+    }
+
+    // Let the graphics module skip redundant state changes
+    priv::GLStateCache::SetCurrent(myStateCache);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Restore the external OpenGL states if needed
+////////////////////////////////////////////////////////////
+void RenderTarget::EndDrawing()
+{
+    priv::GLStateCache::SetCurrent(NULL);
+
+    if (myPreserveStates)
+    {
+        GLCheck(glMatrixMode(GL_PROJECTION)); GLCheck(glPopMatrix());
+        GLCheck(glMatrixMode(GL_MODELVIEW));  GLCheck(glPopMatrix());
+        GLCheck(glPopAttrib());
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Set the viewport and projection matrix of a view
+////////////////////////////////////////////////////////////
+void RenderTarget::ApplyView(const View& ViewToApply)
+{
+    priv::GLStateCache::SetViewport(0, 0, GetWidth(), GetHeight());
+    priv::GLStateCache::SetMatrixMode(GL_PROJECTION);
+    if (IsTopToBottom())
+    {
+        static const float FlipY[16] = {1.f, 0.f, 0.f, 0.f, 0.f, -1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f};
+        GLCheck(glLoadMatrixf(FlipY));
+        GLCheck(glMultMatrixf(ViewToApply.GetMatrix().Get4x4Elements()));
+    }
+    else
+    {
+        GLCheck(glLoadMatrixf(ViewToApply.GetMatrix().Get4x4Elements()));
+    }
+    priv::GLStateCache::SetMatrixMode(GL_MODELVIEW);  GLCheck(glLoadIdentity());
+}
+
+
+////////////////////////////////////////////////////////////
+/// Sort the recorded draw calls by key. We use a LSD radix sort
+/// on bytes, which is stable (calls with the same key keep their
+/// submission order) and linear ; passes on bytes which are the
+/// same for all the calls (typically the layer) are skipped
+////////////////////////////////////////////////////////////
+void RenderTarget::SortCommands()
+{
+    const std::size_t Count = myCommands.size();
+    mySortBuffer.resize(Count);
+
+    for (unsigned int Pass = 0; Pass < 12; ++Pass)
+    {
+        const unsigned int Shift = (Pass % 4) * 8;
+        const unsigned int Word  = Pass / 4;
+
+        // Count the occurences of each byte value
+        std::size_t Offsets[256] = {0};
+        for (std::size_t i = 0; i < Count; ++i)
+            Offsets[(myCommands[i].Key[Word] >> Shift) & 0xFF]++;
+
+        // Nothing to do if all the calls share the same byte
+        Uint32 FirstKey = myCommands[0].Key[Word];
+        if (Offsets[(FirstKey >> Shift) & 0xFF] == Count)
+            continue;
+
+        // Turn the counts into offsets
+        std::size_t Total = 0;
+        for (unsigned int i = 0; i < 256; ++i)
+        {
+            std::size_t Occurences = Offsets[i];
+            Offsets[i] = Total;
+            Total += Occurences;
+        }
+
+        // Move the calls to their sorted position
+        for (std::size_t i = 0; i < Count; ++i)
+            mySortBuffer[Offsets[(myCommands[i].Key[Word] >> Shift) & 0xFF]++] = myCommands[i];
+
+        myCommands.swap(mySortBuffer);
+    }
+}
+
 } // namespace sf
@@ -106,6 +106,9 @@ unsigned int RenderWindow::GetHeight() const
 ////////////////////////////////////////////////////////////
 Image RenderWindow::Capture() const
 {
+    // Execute the draw calls recorded since BeginFrame, if any
+    const_cast<RenderWindow*>(this)->Flush();
+
     // Get the window dimensions
     const unsigned int Width  = GetWidth();
     const unsigned int Height = GetHeight();
@@ -164,4 +167,14 @@ void RenderWindow::OnCreate()
     RenderTarget::Initialize();
 }
 
+
+////////////////////////////////////////////////////////////
+/// Called before the window is displayed on screen
+////////////////////////////////////////////////////////////
+void RenderWindow::OnDisplay()
+{
+    // Execute the draw calls recorded since BeginFrame, if any
+    Flush();
+}
+
 } // namespace sf
@@ -0,0 +1,452 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SceneIndex.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+
+
+namespace
+{
+    // Objects covering more cells than this are kept in a separate list, tested by every query
+    const int MaxCellsPerObject = 64;
+
+    // Cell indices are clamped to this range, to avoid overflows with huge coordinates
+    const float MaxCellIndex = 1 << 24;
+
+    // Initial number of buckets of the grid
+    const std::size_t MinBuckets = 1024;
+}
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// Construct the index
+////////////////////////////////////////////////////////////
+SceneIndex::SceneIndex(float CellSize) :
+myCellSize (CellSize > 0 ? CellSize : 256.f),
+myBuckets  (MinBuckets),
+myNbObjects(0),
+myNextOrder(0),
+myStamp    (0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destructor
+////////////////////////////////////////////////////////////
+SceneIndex::~SceneIndex()
+{
+    Clear();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Add an object to the index
+////////////////////////////////////////////////////////////
+bool SceneIndex::Add(const Drawable& Object)
+{
+    if (Object.myIndex == this)
+        return true;
+
+    if (Object.myIndex)
+    {
+        std::cerr << "Failed to add object to scene index : it already belongs to another index" << std::endl;
+        return false;
+    }
+
+    // Reuse a free entry if possible
+    unsigned int Index;
+    if (!myFreeEntries.empty())
+    {
+        Index = myFreeEntries.back();
+        myFreeEntries.pop_back();
+    }
+    else
+    {
+        Index = static_cast<unsigned int>(myEntries.size());
+        myEntries.push_back(Entry());
+    }
+
+    Entry& NewEntry = myEntries[Index];
+    NewEntry.Object = &Object;
+    NewEntry.Order  = myNextOrder++;
+    NewEntry.Moved  = false;
+    NewEntry.Stamp  = myStamp;
+
+    Object.myIndex      = this;
+    Object.myIndexEntry = Index;
+
+    Insert(Index);
+
+    // Keep about one object per bucket
+    if (++myNbObjects > myBuckets.size())
+        Rehash(myBuckets.size() * 2);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove an object from the index
+////////////////////////////////////////////////////////////
+void SceneIndex::Remove(const Drawable& Object)
+{
+    if (Object.myIndex != this)
+        return;
+
+    unsigned int Index = Object.myIndexEntry;
+    Erase(Index);
+
+    // Entries in the list of moved entries are skipped once they are no longer marked
+    myEntries[Index].Object = NULL;
+    myEntries[Index].Moved  = false;
+    myFreeEntries.push_back(Index);
+
+    Object.myIndex = NULL;
+    myNbObjects--;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Update the place of an object whose size changed
+////////////////////////////////////////////////////////////
+void SceneIndex::Refresh(const Drawable& Object)
+{
+    if (Object.myIndex == this)
+        NotifyMoved(Object.myIndexEntry);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove all the objects from the index
+////////////////////////////////////////////////////////////
+void SceneIndex::Clear()
+{
+    for (std::vector<Entry>::iterator i = myEntries.begin(); i != myEntries.end(); ++i)
+    {
+        if (i->Object)
+            i->Object->myIndex = NULL;
+    }
+
+    myEntries.clear();
+    myFreeEntries.clear();
+    myLargeEntries.clear();
+    myMovedEntries.clear();
+    myBuckets.clear();
+    myBuckets.resize(MinBuckets);
+    myNbObjects = 0;
+    myNextOrder = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the number of objects in the index
+////////////////////////////////////////////////////////////
+std::size_t SceneIndex::GetNbObjects() const
+{
+    return myNbObjects;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Find the objects whose global bounds intersect a rectangle
+////////////////////////////////////////////////////////////
+std::size_t SceneIndex::QueryRect(const FloatRect& Rect, std::vector<const Drawable*>& Objects)
+{
+    Update();
+
+    // Start a new query ; when the identifier wraps, reset the entries so that none looks already found
+    if (++myStamp == 0)
+    {
+        for (std::vector<Entry>::iterator i = myEntries.begin(); i != myEntries.end(); ++i)
+            i->Stamp = 0;
+        myStamp = 1;
+    }
+    myFound.clear();
+
+    // Visit the cells covered by the rectangle, or all the buckets if there are fewer
+    int Left   = GetCell(Rect.Left);
+    int Top    = GetCell(Rect.Top);
+    int Right  = GetCell(Rect.Right);
+    int Bottom = GetCell(Rect.Bottom);
+    double NbCells = (static_cast<double>(Right) - Left + 1) * (static_cast<double>(Bottom) - Top + 1);
+    if (NbCells <= static_cast<double>(myBuckets.size()))
+    {
+        for (int Y = Top; Y <= Bottom; ++Y)
+        {
+            for (int X = Left; X <= Right; ++X)
+            {
+                const std::vector<unsigned int>& Bucket = GetBucket(X, Y);
+                for (std::vector<unsigned int>::const_iterator i = Bucket.begin(); i != Bucket.end(); ++i)
+                    TestEntry(*i, Rect);
+            }
+        }
+    }
+    else
+    {
+        for (std::vector<std::vector<unsigned int> >::const_iterator i = myBuckets.begin(); i != myBuckets.end(); ++i)
+        {
+            for (std::vector<unsigned int>::const_iterator j = i->begin(); j != i->end(); ++j)
+                TestEntry(*j, Rect);
+        }
+    }
+
+    for (std::vector<unsigned int>::const_iterator i = myLargeEntries.begin(); i != myLargeEntries.end(); ++i)
+        TestEntry(*i, Rect);
+
+    // Return the objects in the order they were added
+    std::sort(myFound.begin(), myFound.end());
+    for (std::vector<FoundObject>::const_iterator i = myFound.begin(); i != myFound.end(); ++i)
+        Objects.push_back(i->second);
+
+    return myFound.size();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Find the objects whose global bounds contain a point
+////////////////////////////////////////////////////////////
+std::size_t SceneIndex::QueryPoint(const Vector2f& Point, std::vector<const Drawable*>& Objects)
+{
+    return QueryRect(FloatRect(Point.x, Point.y, Point.x, Point.y), Objects);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Find the topmost object under a point
+////////////////////////////////////////////////////////////
+const Drawable* SceneIndex::Pick(const Vector2f& Point)
+{
+    std::vector<const Drawable*> Candidates;
+    QueryPoint(Point, Candidates);
+
+    // Test the local bounds, starting from the topmost object
+    for (std::vector<const Drawable*>::reverse_iterator i = Candidates.rbegin(); i != Candidates.rend(); ++i)
+    {
+        FloatRect Bounds;
+        if ((*i)->GetLocalBounds(Bounds))
+        {
+            Vector2f Local = (*i)->TransformToLocal(Point);
+            if ((Local.x >= Bounds.Left) && (Local.x <= Bounds.Right) && (Local.y >= Bounds.Top) && (Local.y <= Bounds.Bottom))
+                return *i;
+        }
+    }
+
+    return NULL;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Called by an object of the index when its transform changes
+////////////////////////////////////////////////////////////
+void SceneIndex::NotifyMoved(unsigned int Index)
+{
+    Entry& Moved = myEntries[Index];
+    if (!Moved.Moved)
+    {
+        Moved.Moved = true;
+        myMovedEntries.push_back(Index);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Move the objects which changed since the last query
+////////////////////////////////////////////////////////////
+void SceneIndex::Update()
+{
+    for (std::vector<unsigned int>::const_iterator i = myMovedEntries.begin(); i != myMovedEntries.end(); ++i)
+    {
+        Entry& Moved = myEntries[*i];
+        if (!Moved.Object || !Moved.Moved)
+            continue;
+
+        Moved.Moved = false;
+
+        // Objects which stay in the same cells only need their bounds to be updated
+        FloatRect Bounds;
+        if (Moved.InGrid && Moved.Object->GetGlobalBounds(Bounds) &&
+            (GetCell(Bounds.Left)  == Moved.Cells.Left)  && (GetCell(Bounds.Top)    == Moved.Cells.Top) &&
+            (GetCell(Bounds.Right) == Moved.Cells.Right) && (GetCell(Bounds.Bottom) == Moved.Cells.Bottom))
+        {
+            Moved.Bounds = Bounds;
+            continue;
+        }
+
+        Erase(*i);
+        Insert(*i);
+    }
+
+    myMovedEntries.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Compute the bounds of an entry and insert it into the cells it covers
+////////////////////////////////////////////////////////////
+void SceneIndex::Insert(unsigned int Index)
+{
+    Entry& Inserted = myEntries[Index];
+
+    Inserted.HasBounds = Inserted.Object->GetGlobalBounds(Inserted.Bounds);
+    if (Inserted.HasBounds)
+    {
+        Inserted.Cells = IntRect(GetCell(Inserted.Bounds.Left),  GetCell(Inserted.Bounds.Top),
+                                 GetCell(Inserted.Bounds.Right), GetCell(Inserted.Bounds.Bottom));
+
+        double NbCells = (static_cast<double>(Inserted.Cells.Right)  - Inserted.Cells.Left + 1) *
+                         (static_cast<double>(Inserted.Cells.Bottom) - Inserted.Cells.Top  + 1);
+        Inserted.InGrid = NbCells <= MaxCellsPerObject;
+    }
+    else
+    {
+        Inserted.InGrid = false;
+    }
+
+    if (Inserted.InGrid)
+    {
+        for (int Y = Inserted.Cells.Top; Y <= Inserted.Cells.Bottom; ++Y)
+            for (int X = Inserted.Cells.Left; X <= Inserted.Cells.Right; ++X)
+                GetBucket(X, Y).push_back(Index);
+    }
+    else
+    {
+        myLargeEntries.push_back(Index);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove an entry from the cells it covers
+////////////////////////////////////////////////////////////
+void SceneIndex::Erase(unsigned int Index)
+{
+    const Entry& Erased = myEntries[Index];
+
+    if (Erased.InGrid)
+    {
+        for (int Y = Erased.Cells.Top; Y <= Erased.Cells.Bottom; ++Y)
+        {
+            for (int X = Erased.Cells.Left; X <= Erased.Cells.Right; ++X)
+            {
+                // The order inside a bucket doesn't matter
+                std::vector<unsigned int>& Bucket = GetBucket(X, Y);
+                std::vector<unsigned int>::iterator It = std::find(Bucket.begin(), Bucket.end(), Index);
+                if (It != Bucket.end())
+                {
+                    *It = Bucket.back();
+                    Bucket.pop_back();
+                }
+            }
+        }
+    }
+    else
+    {
+        std::vector<unsigned int>::iterator It = std::find(myLargeEntries.begin(), myLargeEntries.end(), Index);
+        if (It != myLargeEntries.end())
+        {
+            *It = myLargeEntries.back();
+            myLargeEntries.pop_back();
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Change the number of buckets of the grid
+////////////////////////////////////////////////////////////
+void SceneIndex::Rehash(std::size_t NbBuckets)
+{
+    myBuckets.clear();
+    myBuckets.resize(NbBuckets);
+
+    for (unsigned int i = 0; i < myEntries.size(); ++i)
+    {
+        const Entry& Rehashed = myEntries[i];
+        if (Rehashed.Object && Rehashed.InGrid)
+        {
+            for (int Y = Rehashed.Cells.Top; Y <= Rehashed.Cells.Bottom; ++Y)
+                for (int X = Rehashed.Cells.Left; X <= Rehashed.Cells.Right; ++X)
+                    GetBucket(X, Y).push_back(i);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the bucket storing a cell of the grid
+////////////////////////////////////////////////////////////
+std::vector<unsigned int>& SceneIndex::GetBucket(int X, int Y)
+{
+    // Several cells may share a bucket : queries test the bounds of the objects anyway
+    Uint32 Hash = static_cast<Uint32>(X) * 73856093u ^ static_cast<Uint32>(Y) * 19349663u;
+    return myBuckets[Hash & (myBuckets.size() - 1)];
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the cell containing a coordinate
+////////////////////////////////////////////////////////////
+int SceneIndex::GetCell(float Coordinate) const
+{
+    float Cell = static_cast<float>(floor(Coordinate / myCellSize));
+
+    if (Cell < -MaxCellIndex) return static_cast<int>(-MaxCellIndex);
+    if (Cell >  MaxCellIndex) return static_cast<int>(MaxCellIndex);
+
+    return static_cast<int>(Cell);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Test an entry against a rectangle
+////////////////////////////////////////////////////////////
+void SceneIndex::TestEntry(unsigned int Index, const FloatRect& Rect)
+{
+    Entry& Tested = myEntries[Index];
+    if (Tested.Stamp == myStamp)
+        return;
+
+    Tested.Stamp = myStamp;
+
+    // Objects without bounds may be anywhere
+    if (Tested.HasBounds &&
+        ((Tested.Bounds.Right < Rect.Left) || (Tested.Bounds.Left > Rect.Right) ||
+         (Tested.Bounds.Bottom < Rect.Top) || (Tested.Bounds.Top > Rect.Bottom)))
+        return;
+
+    myFound.push_back(std::make_pair(Tested.Order, Tested.Object));
+}
+
+} // namespace sf
@@ -27,25 +27,98 @@
 ////////////////////////////////////////////////////////////
 #include <SFML/Graphics/Shape.hpp>
 #include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/GLStateCache.hpp>
+#include <algorithm>
 #include <math.h>
 
 
+namespace
+{
+    ////////////////////////////////////////////////////////////
+    // Check if vertex buffer objects are supported ; if not,
+    // shapes are drawn from client-side arrays
+    ////////////////////////////////////////////////////////////
+    bool CanUseVertexBuffers()
+    {
+        static bool Available = (GLEW_ARB_vertex_buffer_object != 0);
+        return Available;
+    }
+}
+
+
 namespace sf
 {
 ////////////////////////////////////////////////////////////
 /// Default constructor
 ////////////////////////////////////////////////////////////
 Shape::Shape() :
-myOutline         (0.f),
-myIsFillEnabled   (true),
-myIsOutlineEnabled(true),
-myIsCompiled      (false)
+myOutline           (0.f),
+myIsFillEnabled     (true),
+myIsOutlineEnabled  (true),
+myIsCompiled        (false),
+myNeedVerticesUpdate(true),
+myBuffer            (0)
 {
     // Put a placeholder for the center of the shape
     myPoints.push_back(Point());
 }
 
 
+////////////////////////////////////////////////////////////
+/// Copy constructor
+////////////////////////////////////////////////////////////
+Shape::Shape(const Shape& Copy) :
+Drawable            (Copy),
+myPoints            (Copy.myPoints),
+myOutline           (Copy.myOutline),
+myIsFillEnabled     (Copy.myIsFillEnabled),
+myIsOutlineEnabled  (Copy.myIsOutlineEnabled),
+myIsCompiled        (Copy.myIsCompiled),
+myNeedVerticesUpdate(true),
+myBuffer            (0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destructor
+////////////////////////////////////////////////////////////
+Shape::~Shape()
+{
+    if (myBuffer)
+    {
+        // Make sure we have a valid context
+        priv::GraphicsContext Ctx;
+
+        GLuint Buffer = static_cast<GLuint>(myBuffer);
+        GLCheck(glDeleteBuffersARB(1, &Buffer));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+/// Assignment operator
+////////////////////////////////////////////////////////////
+Shape& Shape::operator =(const Shape& Other)
+{
+    Shape Temp(Other);
+
+    Drawable::operator =(Other);
+    myPoints.swap(Temp.myPoints);
+    myVertices.swap(Temp.myVertices);
+    std::swap(myOutline,            Temp.myOutline);
+    std::swap(myIsFillEnabled,      Temp.myIsFillEnabled);
+    std::swap(myIsOutlineEnabled,   Temp.myIsOutlineEnabled);
+    std::swap(myIsCompiled,         Temp.myIsCompiled);
+    std::swap(myVerticesColor,      Temp.myVerticesColor);
+    std::swap(myNeedVerticesUpdate, Temp.myNeedVerticesUpdate);
+    std::swap(myBuffer,             Temp.myBuffer);
+
+    return *this;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Add a point to the shape
 ////////////////////////////////////////////////////////////
@@ -139,6 +212,7 @@ void Shape::SetPointOutlineColor(unsigned int Index, const Color& OutlineCol)
 void Shape::SetOutlineWidth(float Width)
 {
     myOutline = Width;
+    myNeedVerticesUpdate = true;
 }
 
 
@@ -292,52 +366,74 @@ void Shape::Render(RenderTarget&) const
     if (!myIsCompiled)
         const_cast<Shape*>(this)->Compile();
 
+    // Make sure the vertices are up-to-date
+    if (myNeedVerticesUpdate || (myVerticesColor != GetRenderColor()))
+        UpdateVertices();
+
     // Shapes only use color, no texture
-    GLCheck(glDisable(GL_TEXTURE_2D));
+    priv::GLStateCache::EnableTexture(false);
 
-    // Draw the shape
-    if (myIsFillEnabled)
+    // Setup the vertex arrays
+    if (myBuffer)
     {
-        glBegin(GL_TRIANGLE_FAN);
-        {
-            for (std::vector<Point>::const_iterator i = myPoints.begin(); i != myPoints.end(); ++i)
-            {
-                Color PointColor = i->Col * GetColor();
-                glColor4f(PointColor.r / 255.f, PointColor.g / 255.f, PointColor.b / 255.f, PointColor.a / 255.f);
-                glVertex2f(i->Position.x, i->Position.y);
-            }
-
-            // Close the shape by duplicating the first point at the end
-            Color PointColor = myPoints[1].Col * GetColor();
-            glColor4f(PointColor.r / 255.f, PointColor.g / 255.f, PointColor.b / 255.f, PointColor.a / 255.f);
-            glVertex2f(myPoints[1].Position.x, myPoints[1].Position.y);
-        }
-        glEnd();
+        GLCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, myBuffer));
+        GLCheck(glInterleavedArrays(GL_C4UB_V2F, 0, NULL));
+    }
+    else
+    {
+        GLCheck(glInterleavedArrays(GL_C4UB_V2F, 0, &myVertices[0]));
     }
 
+    // Draw the shape : the fill fan is made of the center, the points and the first point again
+    GLsizei NbFillVertices = static_cast<GLsizei>(myPoints.size() + 1);
+    if (myIsFillEnabled)
+        GLCheck(glDrawArrays(GL_TRIANGLE_FAN, 0, NbFillVertices));
+
     // Draw the outline
     if (myIsOutlineEnabled)
+        GLCheck(glDrawArrays(GL_TRIANGLE_STRIP, NbFillVertices, static_cast<GLsizei>(myVertices.size()) - NbFillVertices));
+
+    // Disable the vertex arrays, we don't want them to interfere with immediate mode rendering
+    GLCheck(glDisableClientState(GL_COLOR_ARRAY));
+    GLCheck(glDisableClientState(GL_VERTEX_ARRAY));
+    if (myBuffer)
+        GLCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
+
+    // The current color is undefined after drawing with a color array
+    priv::GLStateCache::ForgetColor();
+}
+
+
+////////////////////////////////////////////////////////////
+/// /see Drawable::GetLocalBounds
+////////////////////////////////////////////////////////////
+bool Shape::GetLocalBounds(FloatRect& Bounds) const
+{
+    // Nothing is drawn with less than 3 points
+    if (myPoints.size() < 4)
     {
-        glBegin(GL_TRIANGLE_STRIP);
-        {
-            for (std::size_t i = 1; i < myPoints.size(); ++i)
-            {
-                Color PointColor = myPoints[i].OutlineCol * GetColor();
-                glColor4f(PointColor.r / 255.f, PointColor.g / 255.f, PointColor.b / 255.f, PointColor.a / 255.f);
-                glVertex2f(myPoints[i].Position.x, myPoints[i].Position.y);
-                glColor4f(PointColor.r / 255.f, PointColor.g / 255.f, PointColor.b / 255.f, PointColor.a / 255.f);
-                glVertex2f(myPoints[i].Position.x + myPoints[i].Normal.x * myOutline, myPoints[i].Position.y + myPoints[i].Normal.y * myOutline);
-            }
-
-            // Close the shape by duplicating the first point at the end
-            Color PointColor = myPoints[1].OutlineCol * GetColor();
-            glColor4f(PointColor.r / 255.f, PointColor.g / 255.f, PointColor.b / 255.f, PointColor.a / 255.f);
-            glVertex2f(myPoints[1].Position.x, myPoints[1].Position.y);
-            glColor4f(PointColor.r / 255.f, PointColor.g / 255.f, PointColor.b / 255.f, PointColor.a / 255.f);
-            glVertex2f(myPoints[1].Position.x + myPoints[1].Normal.x * myOutline, myPoints[1].Position.y + myPoints[1].Normal.y * myOutline);
-        }
-        glEnd();
+        Bounds = FloatRect(0, 0, 0, 0);
+        return true;
     }
+
+    // The normals are computed when compiling
+    if (!myIsCompiled)
+        const_cast<Shape*>(this)->Compile();
+
+    // Include the outer vertices of the outline, the center is inside the points anyway
+    Bounds = FloatRect(myPoints[1].Position.x, myPoints[1].Position.y, myPoints[1].Position.x, myPoints[1].Position.y);
+    for (std::size_t i = 1; i < myPoints.size(); ++i)
+    {
+        Vector2f Inner = myPoints[i].Position;
+        Vector2f Outer = myIsOutlineEnabled ? Inner + myPoints[i].Normal * myOutline : Inner;
+
+        Bounds.Left   = std::min(Bounds.Left,   std::min(Inner.x, Outer.x));
+        Bounds.Top    = std::min(Bounds.Top,    std::min(Inner.y, Outer.y));
+        Bounds.Right  = std::max(Bounds.Right,  std::max(Inner.x, Outer.x));
+        Bounds.Bottom = std::max(Bounds.Bottom, std::max(Inner.y, Outer.y));
+    }
+
+    return true;
 }
 
 
@@ -388,6 +484,71 @@ void Shape::Compile()
     }
 
     myIsCompiled = true;
+    myNeedVerticesUpdate = true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Build the vertices of the fill and the outline, and
+/// upload them to the vertex buffer if there is one
+////////////////////////////////////////////////////////////
+void Shape::UpdateVertices() const
+{
+    const Color& GlobalColor = GetRenderColor();
+    std::size_t  NbPoints    = myPoints.size();
+
+    myVertices.resize(NbPoints + 1 + NbPoints * 2);
+    Vertex* Fill    = &myVertices[0];
+    Vertex* Outline = Fill + NbPoints + 1;
+
+    for (std::size_t i = 0; i <= NbPoints; ++i)
+    {
+        // The last vertex closes the shape by duplicating the first point
+        const Point& P = (i < NbPoints) ? myPoints[i] : myPoints[1];
+
+        // Fill : center and points
+        Color FillColor = P.Col * GlobalColor;
+        Fill[i].R = FillColor.r;
+        Fill[i].G = FillColor.g;
+        Fill[i].B = FillColor.b;
+        Fill[i].A = FillColor.a;
+        Fill[i].X = P.Position.x;
+        Fill[i].Y = P.Position.y;
+
+        // Outline : inner and outer vertices of each point (the center is not part of the outline)
+        if (i > 0)
+        {
+            Color OutlineColor = P.OutlineCol * GlobalColor;
+            Vertex* Inner = Outline + (i - 1) * 2;
+            Vertex* Outer = Inner + 1;
+            Inner->R = Outer->R = OutlineColor.r;
+            Inner->G = Outer->G = OutlineColor.g;
+            Inner->B = Outer->B = OutlineColor.b;
+            Inner->A = Outer->A = OutlineColor.a;
+            Inner->X = P.Position.x;
+            Inner->Y = P.Position.y;
+            Outer->X = P.Position.x + P.Normal.x * myOutline;
+            Outer->Y = P.Position.y + P.Normal.y * myOutline;
+        }
+    }
+
+    // Upload the vertices to video memory if possible
+    if (CanUseVertexBuffers())
+    {
+        if (!myBuffer)
+        {
+            GLuint Buffer = 0;
+            GLCheck(glGenBuffersARB(1, &Buffer));
+            myBuffer = static_cast<unsigned int>(Buffer);
+        }
+
+        GLCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, myBuffer));
+        GLCheck(glBufferDataARB(GL_ARRAY_BUFFER_ARB, myVertices.size() * sizeof(Vertex), &myVertices[0], GL_STATIC_DRAW_ARB));
+        GLCheck(glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0));
+    }
+
+    myVerticesColor      = GlobalColor;
+    myNeedVerticesUpdate = false;
 }
 
 
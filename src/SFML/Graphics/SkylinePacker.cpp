@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SkylinePacker.hpp>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// Construct the packer for an area of given size
+////////////////////////////////////////////////////////////
+SkylinePacker::SkylinePacker(unsigned int Width, unsigned int Height)
+{
+    Reset(Width, Height);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove all the rectangles and change the size of the area
+////////////////////////////////////////////////////////////
+void SkylinePacker::Reset(unsigned int Width, unsigned int Height)
+{
+    myWidth      = Width;
+    myHeight     = Height;
+    myUsedHeight = 0;
+    myUsedArea   = 0;
+
+    // The skyline starts as a single segment at the top of the area
+    Segment Floor;
+    Floor.Left  = 0;
+    Floor.Top   = 0;
+    Floor.Width = Width;
+    mySkyline.clear();
+    mySkyline.push_back(Floor);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Find room for a new rectangle
+////////////////////////////////////////////////////////////
+bool SkylinePacker::Insert(unsigned int Width, unsigned int Height, unsigned int& Left, unsigned int& Top)
+{
+    if ((Width == 0) || (Height == 0))
+    {
+        Left = 0;
+        Top  = 0;
+        return true;
+    }
+
+    // Find the position where the bottom of the rectangle stays the closest to the top
+    // of the area, and among them the one resting on the narrowest segment
+    std::size_t  BestIndex  = mySkyline.size();
+    unsigned int BestBottom = 0;
+    unsigned int BestWidth  = 0;
+    for (std::size_t i = 0; i < mySkyline.size(); ++i)
+    {
+        unsigned int CurTop;
+        if (Fit(i, Width, Height, CurTop))
+        {
+            unsigned int Bottom = CurTop + Height;
+            if ((BestIndex == mySkyline.size()) || (Bottom < BestBottom) || ((Bottom == BestBottom) && (mySkyline[i].Width < BestWidth)))
+            {
+                BestIndex  = i;
+                BestBottom = Bottom;
+                BestWidth  = mySkyline[i].Width;
+            }
+        }
+    }
+
+    if (BestIndex == mySkyline.size())
+        return false;
+
+    Left = mySkyline[BestIndex].Left;
+    Top  = BestBottom - Height;
+
+    // Insert the new segment on top of the rectangle
+    Segment NewSegment;
+    NewSegment.Left  = Left;
+    NewSegment.Top   = BestBottom;
+    NewSegment.Width = Width;
+    mySkyline.insert(mySkyline.begin() + BestIndex, NewSegment);
+
+    // Shrink or remove the segments that are now under the rectangle
+    std::size_t i = BestIndex + 1;
+    while (i < mySkyline.size())
+    {
+        Segment&     Cur   = mySkyline[i];
+        unsigned int Right = Left + Width;
+        if (Cur.Left >= Right)
+            break;
+
+        if (Cur.Left + Cur.Width <= Right)
+        {
+            mySkyline.erase(mySkyline.begin() + i);
+        }
+        else
+        {
+            Cur.Width -= Right - Cur.Left;
+            Cur.Left   = Right;
+            break;
+        }
+    }
+
+    // Merge the neighbour segments which are at the same height
+    for (std::size_t j = 0; j + 1 < mySkyline.size(); )
+    {
+        if (mySkyline[j].Top == mySkyline[j + 1].Top)
+        {
+            mySkyline[j].Width += mySkyline[j + 1].Width;
+            mySkyline.erase(mySkyline.begin() + j + 1);
+        }
+        else
+        {
+            ++j;
+        }
+    }
+
+    // Update the statistics
+    if (BestBottom > myUsedHeight)
+        myUsedHeight = BestBottom;
+    myUsedArea += static_cast<unsigned long>(Width) * Height;
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the height actually used by the packed rectangles
+////////////////////////////////////////////////////////////
+unsigned int SkylinePacker::GetUsedHeight() const
+{
+    return myUsedHeight;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the total area of the packed rectangles
+////////////////////////////////////////////////////////////
+unsigned long SkylinePacker::GetUsedArea() const
+{
+    return myUsedArea;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Check if a rectangle can be put at the left of a segment
+////////////////////////////////////////////////////////////
+bool SkylinePacker::Fit(std::size_t Index, unsigned int Width, unsigned int Height, unsigned int& Top) const
+{
+    // The rectangle must not go out of the area on the right
+    if (mySkyline[Index].Left + Width > myWidth)
+        return false;
+
+    // The rectangle rests on the highest segment below it
+    Top = 0;
+    unsigned int Remaining = Width;
+    for (std::size_t i = Index; Remaining > 0; ++i)
+    {
+        if (mySkyline[i].Top > Top)
+            Top = mySkyline[i].Top;
+
+        if (mySkyline[i].Width >= Remaining)
+            break;
+        Remaining -= mySkyline[i].Width;
+    }
+
+    // ... and must not go out of the area on the bottom
+    return Top + Height <= myHeight;
+}
+
+} // namespace priv
+
+} // namespace sf
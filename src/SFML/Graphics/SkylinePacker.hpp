@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+#ifndef SFML_SKYLINEPACKER_HPP
+#define SFML_SKYLINEPACKER_HPP
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <vector>
+
+
+namespace sf
+{
+namespace priv
+{
+////////////////////////////////////////////////////////////
+/// Packs rectangles into a fixed-size area, using the
+/// "skyline bottom-left" heuristic : the upper contour of
+/// the packed rectangles is kept as a list of horizontal
+/// segments, and each new rectangle is put where its bottom
+/// stays the closest to the top of the area.
+/// Rectangles should be inserted by decreasing height for
+/// the tightest results.
+/// This class is for internal use only
+////////////////////////////////////////////////////////////
+class SkylinePacker
+{
+public :
+
+    ////////////////////////////////////////////////////////////
+    /// Construct the packer for an area of given size
+    ///
+    /// \param Width :  Width of the area (0 by default)
+    /// \param Height : Height of the area (0 by default)
+    ///
+    ////////////////////////////////////////////////////////////
+    SkylinePacker(unsigned int Width = 0, unsigned int Height = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// Remove all the rectangles and change the size of the area
+    ///
+    /// \param Width :  New width of the area
+    /// \param Height : New height of the area
+    ///
+    ////////////////////////////////////////////////////////////
+    void Reset(unsigned int Width, unsigned int Height);
+
+    ////////////////////////////////////////////////////////////
+    /// Find room for a new rectangle
+    ///
+    /// \param Width :  Width of the rectangle
+    /// \param Height : Height of the rectangle
+    /// \param Left :   Receives the left coordinate of the rectangle
+    /// \param Top :    Receives the top coordinate of the rectangle
+    ///
+    /// \return True if the rectangle was inserted, false if there's not enough room
+    ///
+    ////////////////////////////////////////////////////////////
+    bool Insert(unsigned int Width, unsigned int Height, unsigned int& Left, unsigned int& Top);
+
+    ////////////////////////////////////////////////////////////
+    /// Get the height actually used by the packed rectangles
+    ///
+    /// \return Bottom coordinate of the lowest rectangle
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned int GetUsedHeight() const;
+
+    ////////////////////////////////////////////////////////////
+    /// Get the total area of the packed rectangles
+    ///
+    /// \return Sum of the areas of the inserted rectangles
+    ///
+    ////////////////////////////////////////////////////////////
+    unsigned long GetUsedArea() const;
+
+private :
+
+    ////////////////////////////////////////////////////////////
+    /// Horizontal segment of the skyline
+    ////////////////////////////////////////////////////////////
+    struct Segment
+    {
+        unsigned int Left;  ///< Left coordinate of the segment
+        unsigned int Top;   ///< Height of the skyline along the segment
+        unsigned int Width; ///< Width of the segment
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// Check if a rectangle can be put at the left of a segment
+    ///
+    /// \param Index :  Index of the segment
+    /// \param Width :  Width of the rectangle
+    /// \param Height : Height of the rectangle
+    /// \param Top :    Receives the top coordinate the rectangle would have
+    ///
+    /// \return True if the rectangle fits
+    ///
+    ////////////////////////////////////////////////////////////
+    bool Fit(std::size_t Index, unsigned int Width, unsigned int Height, unsigned int& Top) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    unsigned int         myWidth;      ///< Width of the area
+    unsigned int         myHeight;     ///< Height of the area
+    unsigned int         myUsedHeight; ///< Bottom coordinate of the lowest rectangle
+    unsigned long        myUsedArea;   ///< Sum of the areas of the inserted rectangles
+    std::vector<Segment> mySkyline;    ///< Segments of the skyline, from left to right
+};
+
+} // namespace priv
+
+} // namespace sf
+
+
+#endif // SFML_SKYLINEPACKER_HPP
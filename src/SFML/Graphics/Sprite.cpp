@@ -28,6 +28,7 @@
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/GLStateCache.hpp>
 
 
 namespace sf
@@ -174,6 +175,25 @@ Color Sprite::GetPixel(unsigned int X, unsigned int Y) const
 }
 
 
+////////////////////////////////////////////////////////////
+/// /see Drawable::GetRenderImage
+////////////////////////////////////////////////////////////
+const Image* Sprite::GetRenderImage() const
+{
+    return myImage;
+}
+
+
+////////////////////////////////////////////////////////////
+/// /see Drawable::GetLocalBounds
+////////////////////////////////////////////////////////////
+bool Sprite::GetLocalBounds(FloatRect& Bounds) const
+{
+    Bounds = FloatRect(0, 0, static_cast<float>(mySubRect.GetWidth()), static_cast<float>(mySubRect.GetHeight()));
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// /see sfDrawable::Render
 ////////////////////////////////////////////////////////////
@@ -211,7 +231,7 @@ void Sprite::Render(RenderTarget&) const
     else
     {
         // Disable texturing
-        GLCheck(glDisable(GL_TEXTURE_2D));
+        priv::GLStateCache::EnableTexture(false);
 
         // Draw the sprite's triangles
         glBegin(GL_QUADS);
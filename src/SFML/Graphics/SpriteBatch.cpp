@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/SpriteBatch.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/GLStateCache.hpp>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// Default constructor
+////////////////////////////////////////////////////////////
+SpriteBatch::SpriteBatch() :
+myNbGroups (0),
+myNbSprites(0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+/// Add a sprite to the batch
+////////////////////////////////////////////////////////////
+void SpriteBatch::Add(const Sprite& Object)
+{
+    // Check if the image is valid
+    const Image* Texture = Object.GetImage();
+    if (Texture && ((Texture->GetWidth() == 0) || (Texture->GetHeight() == 0)))
+        Texture = NULL;
+
+    // Find the group of the sprite -- most of the time it's the last one
+    Blend::Mode Mode = Object.GetBlendMode();
+    Group*      Dest = NULL;
+    for (std::size_t i = myNbGroups; i > 0; --i)
+    {
+        if ((myGroups[i - 1].Texture == Texture) && (myGroups[i - 1].Mode == Mode))
+        {
+            Dest = &myGroups[i - 1];
+            break;
+        }
+    }
+
+    // Not found : start a new group, reusing an old one if possible
+    if (!Dest)
+    {
+        if (myNbGroups == myGroups.size())
+            myGroups.push_back(Group());
+
+        Dest = &myGroups[myNbGroups++];
+        Dest->Texture = Texture;
+        Dest->Mode    = Mode;
+        Dest->Vertices.clear();
+    }
+
+    // Compute the local corners of the sprite, using the "offset trick" for pixel-perfect rendering
+    // (see Sprite::Render)
+    const IntRect& SubRect = Object.GetSubRect();
+    float Width  = static_cast<float>(SubRect.GetWidth());
+    float Height = static_cast<float>(SubRect.GetHeight());
+    Vector2f Corners[4] =
+    {
+        Vector2f(0.375f,         0.375f),
+        Vector2f(0.375f,         Height + 0.375f),
+        Vector2f(Width + 0.375f, Height + 0.375f),
+        Vector2f(Width + 0.375f, 0.375f)
+    };
+
+    // Compute the texture coordinates
+    FloatRect Rect(0, 0, 0, 0);
+    if (Texture)
+    {
+        FloatRect TexCoords = Texture->GetTexCoords(SubRect);
+        Rect = FloatRect(Object.myIsFlippedX ? TexCoords.Right  : TexCoords.Left,
+                         Object.myIsFlippedY ? TexCoords.Bottom : TexCoords.Top,
+                         Object.myIsFlippedX ? TexCoords.Left   : TexCoords.Right,
+                         Object.myIsFlippedY ? TexCoords.Top    : TexCoords.Bottom);
+    }
+    float TexX[4] = {Rect.Left, Rect.Left,   Rect.Right,  Rect.Right};
+    float TexY[4] = {Rect.Top,  Rect.Bottom, Rect.Bottom, Rect.Top};
+
+    // Transform the corners and append them to the group
+    const Matrix3& Transform = Object.GetMatrix();
+    const Color&   Col       = Object.GetColor();
+    for (int i = 0; i < 4; ++i)
+    {
+        Vector2f Position = Transform.Transform(Corners[i]);
+
+        Vertex V;
+        V.TexX = TexX[i];
+        V.TexY = TexY[i];
+        V.R    = Col.r;
+        V.G    = Col.g;
+        V.B    = Col.b;
+        V.A    = Col.a;
+        V.X    = Position.x;
+        V.Y    = Position.y;
+        V.Z    = 0.f;
+        Dest->Vertices.push_back(V);
+    }
+
+    myNbSprites++;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove all the sprites from the batch
+////////////////////////////////////////////////////////////
+void SpriteBatch::Clear()
+{
+    myNbGroups  = 0;
+    myNbSprites = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the number of sprites in the batch
+////////////////////////////////////////////////////////////
+std::size_t SpriteBatch::GetSize() const
+{
+    return myNbSprites;
+}
+
+
+////////////////////////////////////////////////////////////
+/// /see Drawable::Render
+////////////////////////////////////////////////////////////
+void SpriteBatch::Render(RenderTarget&) const
+{
+    for (std::size_t i = 0; i < myNbGroups; ++i)
+    {
+        const Group& CurGroup = myGroups[i];
+
+        // Setup the blending mode of the group
+        priv::GLStateCache::SetBlendMode(CurGroup.Mode);
+
+        // Bind the image of the group
+        if (CurGroup.Texture)
+            CurGroup.Texture->Bind();
+        else
+            priv::GLStateCache::EnableTexture(false);
+
+        // Draw all the quads at once
+        GLCheck(glInterleavedArrays(GL_T2F_C4UB_V3F, 0, &CurGroup.Vertices[0]));
+        GLCheck(glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(CurGroup.Vertices.size())));
+    }
+
+    // Disable the vertex arrays, we don't want them to interfere with immediate mode rendering
+    GLCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
+    GLCheck(glDisableClientState(GL_COLOR_ARRAY));
+    GLCheck(glDisableClientState(GL_VERTEX_ARRAY));
+
+    // The current color is undefined after drawing with a color array
+    priv::GLStateCache::ForgetColor();
+}
+
+} // namespace sf
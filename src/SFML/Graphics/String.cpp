@@ -28,6 +28,7 @@
 #include <SFML/Graphics/String.hpp>
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/GraphicsContext.hpp>
+#include <SFML/Graphics/GLStateCache.hpp>
 #include <locale>
 
 
@@ -37,10 +38,12 @@ namespace sf
 /// Default constructor
 ////////////////////////////////////////////////////////////
 String::String() :
-myFont          (&Font::GetDefaultFont()),
-mySize          (30.f),
-myStyle         (Regular),
-myNeedRectUpdate(true)
+myFont              (&Font::GetDefaultFont()),
+mySize              (30.f),
+myStyle             (Regular),
+myNbGlyphVertices   (0),
+myFontGeneration    (0),
+myNeedGeometryUpdate(true)
 {
 
 }
@@ -50,10 +53,12 @@ myNeedRectUpdate(true)
 /// Construct the string from any kind of text
 ////////////////////////////////////////////////////////////
 String::String(const Unicode::Text& Text, const Font& CharFont, float Size) :
-myFont          (&CharFont),
-mySize          (Size),
-myStyle         (Regular),
-myNeedRectUpdate(true)
+myFont              (&CharFont),
+mySize              (Size),
+myStyle             (Regular),
+myNbGlyphVertices   (0),
+myFontGeneration    (0),
+myNeedGeometryUpdate(true)
 {
     SetText(Text);
 }
@@ -64,7 +69,7 @@ myNeedRectUpdate(true)
 ////////////////////////////////////////////////////////////
 void String::SetText(const Unicode::Text& Text)
 {
-    myNeedRectUpdate = true;
+    myNeedGeometryUpdate = true;
     myText = Text;
 }
 
@@ -76,7 +81,7 @@ void String::SetFont(const Font& CharFont)
 {
     if (myFont != &CharFont)
     {
-        myNeedRectUpdate = true;
+        myNeedGeometryUpdate = true;
         myFont = &CharFont;
     }
 }
@@ -89,7 +94,7 @@ void String::SetSize(float Size)
 {
     if (mySize != Size)
     {
-        myNeedRectUpdate = true;
+        myNeedGeometryUpdate = true;
         mySize = Size;
     }
 }
@@ -103,7 +108,7 @@ void String::SetStyle(unsigned long TextStyle)
 {
     if (myStyle != TextStyle)
     {
-        myNeedRectUpdate = true;
+        myNeedGeometryUpdate = true;
         myStyle = TextStyle;
     }
 }
@@ -152,40 +157,13 @@ unsigned long String::GetStyle() const
 ////////////////////////////////////////////////////////////
 sf::Vector2f String::GetCharacterPos(std::size_t Index) const
 {
-    // First get the UTF32 representation of the text
-    const Unicode::UTF32String& Text = myText;
+    UpdateGeometry();
 
     // Adjust the index if it's out of range
-    if (Index > Text.length())
-        Index = Text.length();
-
-    // The final size is based on the text size
-    float FactorX  = mySize / myFont->GetCharacterSize();
-    float AdvanceY = mySize;
-
-    // Compute the position
-    sf::Vector2f Position;
-    for (std::size_t i = 0; i < Index; ++i)
-    {
-        // Get the current character and its corresponding glyph
-        Uint32       CurChar  = Text[i];
-        const Glyph& CurGlyph = myFont->GetGlyph(CurChar);
-        float        AdvanceX = CurGlyph.Advance * FactorX;
+    if (Index >= myCharactersPos.size())
+        Index = myCharactersPos.size() - 1;
 
-        switch (CurChar)
-        {
-            // Handle special characters
-            case L' ' :  Position.x += AdvanceX;                 break;
-            case L'\t' : Position.x += AdvanceX * 4;             break;
-            case L'\v' : Position.y += AdvanceY * 4;             break;
-            case L'\n' : Position.y += AdvanceY; Position.x = 0; break;
-
-            // Regular character : just add its advance value
-            default : Position.x += AdvanceX; break;
-        }
-    }
-
-    return Position;
+    return myCharactersPos[Index];
 }
 
 
@@ -194,8 +172,7 @@ sf::Vector2f String::GetCharacterPos(std::size_t Index) const
 ////////////////////////////////////////////////////////////
 FloatRect String::GetRect() const
 {
-    if (myNeedRectUpdate)
-        const_cast<String*>(this)->RecomputeRect();
+    UpdateGeometry();
 
     FloatRect Rect;
     Rect.Left   = (myBaseRect.Left   - GetCenter().x) * GetScale().x + GetPosition().x;
@@ -207,179 +184,235 @@ FloatRect String::GetRect() const
 }
 
 
+////////////////////////////////////////////////////////////
+/// /see Drawable::GetRenderImage
+////////////////////////////////////////////////////////////
+const Image* String::GetRenderImage() const
+{
+    return &myFont->GetImage();
+}
+
+
+////////////////////////////////////////////////////////////
+/// /see Drawable::GetLocalBounds
+////////////////////////////////////////////////////////////
+bool String::GetLocalBounds(FloatRect& Bounds) const
+{
+    UpdateGeometry();
+
+    Bounds = myBaseRect;
+    return true;
+}
+
+
 ////////////////////////////////////////////////////////////
 /// /see sfDrawable::Render
 ////////////////////////////////////////////////////////////
 void String::Render(RenderTarget&) const
 {
-    // First get the internal UTF-32 string of the text
-    const Unicode::UTF32String& Text = myText;
+    // Make sure the geometry is up-to-date
+    UpdateGeometry();
 
     // No text, no rendering :)
-    if (Text.empty())
+    if (myVertices.empty())
         return;
 
     // Set the scaling factor to get the actual size
-    float CharSize =  static_cast<float>(myFont->GetCharacterSize());
-    float Factor   = mySize / CharSize;
+    float Factor = mySize / myFont->GetCharacterSize();
     GLCheck(glScalef(Factor, Factor, 1.f));
 
-    // Bind the font texture
-    myFont->GetImage().Bind();
-
-    // Initialize the rendering coordinates
-    float X = 0.f;
-    float Y = CharSize;
-
-    // Holds the lines to draw later, for underlined style
-    std::vector<float> UnderlineCoords;
-    UnderlineCoords.reserve(16);
-
-    // Compute the shearing to apply if we're using the italic style
-    float ItalicCoeff = (myStyle & Italic) ? 0.208f : 0.f; // 12 degrees
-
-    // Draw one quad for each character
-    glBegin(GL_QUADS);
-    for (std::size_t i = 0; i < Text.size(); ++i)
+    // Draw the glyphs, with one call per font page ; the pages are marked as used,
+    // so that a dynamic font doesn't recycle those of the text which stays on screen
+    GLCheck(glEnableClientState(GL_VERTEX_ARRAY));
+    GLCheck(glEnableClientState(GL_TEXTURE_COORD_ARRAY));
+    GLCheck(glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &myVertices[0].X));
+    GLCheck(glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &myVertices[0].TexX));
+    for (std::vector<PageRange>::const_iterator i = myPageRanges.begin(); i != myPageRanges.end(); ++i)
     {
-        // Get the current character and its corresponding glyph
-        Uint32           CurChar  = Text[i];
-        const Glyph&     CurGlyph = myFont->GetGlyph(CurChar);
-        int              Advance  = CurGlyph.Advance;
-        const IntRect&   Rect     = CurGlyph.Rectangle;
-        const FloatRect& Coord    = CurGlyph.TexCoords;
-
-        // If we're using the underlined style and there's a new line,
-        // we keep track of the previous line to draw it later
-        if ((CurChar == L'\n') && (myStyle & Underlined))
-        {
-            UnderlineCoords.push_back(X);
-            UnderlineCoords.push_back(Y + 2);
-        }
-
-        // Handle special characters
-        switch (CurChar)
-        {
-            case L' ' :  X += Advance;         continue;
-            case L'\n' : Y += CharSize; X = 0; continue;
-            case L'\t' : X += Advance  * 4;    continue;
-            case L'\v' : Y += CharSize * 4;    continue;
-        }
-
-        // Draw a textured quad for the current character
-        glTexCoord2f(Coord.Left,  Coord.Top);    glVertex2f(X + Rect.Left  - ItalicCoeff * Rect.Top,    Y + Rect.Top);
-        glTexCoord2f(Coord.Left,  Coord.Bottom); glVertex2f(X + Rect.Left  - ItalicCoeff * Rect.Bottom, Y + Rect.Bottom);
-        glTexCoord2f(Coord.Right, Coord.Bottom); glVertex2f(X + Rect.Right - ItalicCoeff * Rect.Bottom, Y + Rect.Bottom);
-        glTexCoord2f(Coord.Right, Coord.Top);    glVertex2f(X + Rect.Right - ItalicCoeff * Rect.Top,    Y + Rect.Top);
-
-        // If we're using the bold style, we must render the character 4 more times,
-        // slightly offseted, to simulate a higher weight
-        if (myStyle & Bold)
-        {
-            static const float OffsetsX[] = {-0.5f, 0.5f, 0.f, 0.f};
-            static const float OffsetsY[] = {0.f, 0.f, -0.5f, 0.5f};
-
-            for (int j = 0; j < 4; ++j)
-            {
-                glTexCoord2f(Coord.Left,  Coord.Top);    glVertex2f(X + OffsetsX[j] + Rect.Left  - ItalicCoeff * Rect.Top,    Y + OffsetsY[j] + Rect.Top);
-                glTexCoord2f(Coord.Left,  Coord.Bottom); glVertex2f(X + OffsetsX[j] + Rect.Left  - ItalicCoeff * Rect.Bottom, Y + OffsetsY[j] + Rect.Bottom);
-                glTexCoord2f(Coord.Right, Coord.Bottom); glVertex2f(X + OffsetsX[j] + Rect.Right - ItalicCoeff * Rect.Bottom, Y + OffsetsY[j] + Rect.Bottom);
-                glTexCoord2f(Coord.Right, Coord.Top);    glVertex2f(X + OffsetsX[j] + Rect.Right - ItalicCoeff * Rect.Top,    Y + OffsetsY[j] + Rect.Top);
-            }
-        }
-
-        // Advance to the next character
-        X += Advance;
+        myFont->UsePage(i->Page);
+        myFont->GetImage(i->Page).Bind();
+        GLCheck(glDrawArrays(GL_QUADS, static_cast<GLint>(i->First), static_cast<GLsizei>(i->Count)));
     }
-    glEnd();
+    GLCheck(glDisableClientState(GL_TEXTURE_COORD_ARRAY));
 
     // Draw the underlines if needed
-    if (myStyle & Underlined)
+    if (myVertices.size() > myNbGlyphVertices)
     {
-        // Compute the line thickness
-        float Thickness = (myStyle & Bold) ? 3.f : 2.f;
+        priv::GLStateCache::EnableTexture(false);
+        GLCheck(glDrawArrays(GL_QUADS, static_cast<GLsizei>(myNbGlyphVertices), static_cast<GLsizei>(myVertices.size() - myNbGlyphVertices)));
+    }
 
-        // Add the last line (which was not finished with a \n)
-        UnderlineCoords.push_back(X);
-        UnderlineCoords.push_back(Y + 2);
+    // Disable the vertex arrays, we don't want them to interfere with immediate mode rendering
+    GLCheck(glDisableClientState(GL_VERTEX_ARRAY));
+}
 
-        // Draw the underlines as quads
-        GLCheck(glDisable(GL_TEXTURE_2D));
-        glBegin(GL_QUADS);
-        for (std::size_t i = 0; i < UnderlineCoords.size(); i += 2)
-        {
-            glVertex2f(0,                  UnderlineCoords[i + 1]);
-            glVertex2f(0,                  UnderlineCoords[i + 1] + Thickness);
-            glVertex2f(UnderlineCoords[i], UnderlineCoords[i + 1] + Thickness);
-            glVertex2f(UnderlineCoords[i], UnderlineCoords[i + 1]);
-        }
-        glEnd();
+
+////////////////////////////////////////////////////////////
+/// Make sure the geometry of the text is up-to-date
+////////////////////////////////////////////////////////////
+void String::UpdateGeometry() const
+{
+    // The geometry must be computed again if the text has changed,
+    // or if the font has invalidated some of its glyphs
+    if (!myNeedGeometryUpdate && (myFontGeneration == myFont->myGeneration))
+        return;
+
+    // Laying out the text may render new glyphs into a recycled page of a dynamic font,
+    // invalidating the glyphs computed before : in this case we do it once again
+    for (int i = 0; i < 2; ++i)
+    {
+        myFontGeneration = myFont->myGeneration;
+        ComputeGeometry();
+        if (myFontGeneration == myFont->myGeneration)
+            break;
     }
+
+    // Reset the "need update" state
+    myNeedGeometryUpdate = false;
 }
 
 
 ////////////////////////////////////////////////////////////
-/// Recompute the bounding rectangle of the text
+/// Lay out the text : compute the vertices of the glyphs and
+/// underlines, the position of each character and the bounding
+/// rectangle of the text
 ////////////////////////////////////////////////////////////
-void String::RecomputeRect()
+void String::ComputeGeometry() const
 {
     // First get the internal UTF-32 string of the text
     const Unicode::UTF32String& Text = myText;
 
-    // Reset the "need update" state
-    myNeedRectUpdate = false;
+    myVertices.clear();
+    myCharactersPos.clear();
+    myPageRanges.clear();
+    myNbGlyphVertices = 0;
 
     // No text, empty box :)
     if (Text.empty())
     {
         myBaseRect = FloatRect(0, 0, 0, 0);
+        myCharactersPos.push_back(Vector2f(0, 0));
         return;
     }
 
-    // Initial values
-    float CurWidth  = 0;
+    // The geometry is computed in font units, the bounds and positions in object units
+    float CharSize = static_cast<float>(myFont->GetCharacterSize());
+    float Factor   = mySize / CharSize;
+
+    // If we're using the bold style, we must render each character 4 more times,
+    // slightly offseted, to simulate a higher weight
+    static const float OffsetsX[] = {0.f, -0.5f, 0.5f, 0.f, 0.f};
+    static const float OffsetsY[] = {0.f, 0.f, 0.f, -0.5f, 0.5f};
+    int NbQuads = (myStyle & Bold) ? 5 : 1;
+
+    // Compute the shearing to apply if we're using the italic style
+    float ItalicCoeff = (myStyle & Italic) ? 0.208f : 0.f; // 12 degrees
+
+    // Initialize the rendering coordinates
+    float X = 0.f;
+    float Y = CharSize;
+
+    // Initialize the bounds
     float CurHeight = 0;
     float Width     = 0;
     float Height    = 0;
-    float Factor    = mySize / myFont->GetCharacterSize();
 
-    // Go through each character
+    // Holds the lines to draw, for underlined style
+    std::vector<float> UnderlineCoords;
+
+    // Holds the vertices of the glyphs of each font page
+    std::vector<std::vector<Vertex> > PagesVertices(1);
+    PagesVertices[0].reserve(Text.size() * NbQuads * 4);
+
+    myCharactersPos.reserve(Text.size() + 1);
     for (std::size_t i = 0; i < Text.size(); ++i)
     {
+        myCharactersPos.push_back(Vector2f(X * Factor, (Y - CharSize) * Factor));
+
         // Get the current character and its corresponding glyph
-        Uint32         CurChar  = Text[i];
-        const Glyph&   CurGlyph = myFont->GetGlyph(CurChar);
-        float          Advance  = CurGlyph.Advance * Factor;
-        const IntRect& Rect     = CurGlyph.Rectangle;
+        Uint32           CurChar  = Text[i];
+        const Glyph&     CurGlyph = myFont->GetGlyph(CurChar);
+        int              Advance  = CurGlyph.Advance;
+        const IntRect&   Rect     = CurGlyph.Rectangle;
+        const FloatRect& Coord    = CurGlyph.TexCoords;
 
         // Handle special characters
         switch (CurChar)
         {
-            case L' ' :  CurWidth += Advance;                    continue;
-            case L'\t' : CurWidth += Advance * 4;                continue;
-            case L'\v' : Height   += mySize  * 4; CurHeight = 0; continue;
+            case L' ' :  X += Advance;     continue;
+            case L'\t' : X += Advance * 4; continue;
+
+            case L'\v' :
+                Y += CharSize * 4;
+                Height += mySize * 4;
+                CurHeight = 0;
+                continue;
 
             case L'\n' :
+                // If we're using the underlined style, we keep track of the line to draw it later
+                if (myStyle & Underlined)
+                {
+                    UnderlineCoords.push_back(X);
+                    UnderlineCoords.push_back(Y + 2);
+                }
+                if (X * Factor > Width)
+                    Width = X * Factor;
                 Height += mySize;
                 CurHeight = 0;
-                if (CurWidth > Width)
-                    Width = CurWidth;
-                CurWidth = 0;
+                Y += CharSize;
+                X = 0;
                 continue;
         }
 
-        // Advance to the next character
-        CurWidth += Advance;
+        // Add a textured quad for the current character (several if bold)
+        if (CurGlyph.Page >= PagesVertices.size())
+            PagesVertices.resize(CurGlyph.Page + 1);
+        std::vector<Vertex>& Vertices = PagesVertices[CurGlyph.Page];
+        for (int j = 0; j < NbQuads; ++j)
+        {
+            float Left   = X + OffsetsX[j] + Rect.Left;
+            float Right  = X + OffsetsX[j] + Rect.Right;
+            float Top    = Y + OffsetsY[j] + Rect.Top;
+            float Bottom = Y + OffsetsY[j] + Rect.Bottom;
+
+            Vertex Quad[4] =
+            {
+                {Coord.Left,  Coord.Top,    Left  - ItalicCoeff * Rect.Top,    Top},
+                {Coord.Left,  Coord.Bottom, Left  - ItalicCoeff * Rect.Bottom, Bottom},
+                {Coord.Right, Coord.Bottom, Right - ItalicCoeff * Rect.Bottom, Bottom},
+                {Coord.Right, Coord.Top,    Right - ItalicCoeff * Rect.Top,    Top}
+            };
+            Vertices.insert(Vertices.end(), Quad, Quad + 4);
+        }
 
         // Update the maximum height
-        float CharHeight = (myFont->GetCharacterSize() + Rect.Bottom) * Factor;
+        float CharHeight = (CharSize + Rect.Bottom) * Factor;
         if (CharHeight > CurHeight)
             CurHeight = CharHeight;
+
+        // Advance to the next character
+        X += Advance;
+    }
+    myCharactersPos.push_back(Vector2f(X * Factor, (Y - CharSize) * Factor));
+
+    // Gather the glyphs vertices, grouped by font page
+    for (std::size_t i = 0; i < PagesVertices.size(); ++i)
+    {
+        if (!PagesVertices[i].empty())
+        {
+            PageRange Range;
+            Range.Page  = static_cast<unsigned int>(i);
+            Range.First = myVertices.size();
+            Range.Count = PagesVertices[i].size();
+            myPageRanges.push_back(Range);
+            myVertices.insert(myVertices.end(), PagesVertices[i].begin(), PagesVertices[i].end());
+        }
     }
+    myNbGlyphVertices = myVertices.size();
 
     // Update the last line
-    if (CurWidth > Width)
-        Width = CurWidth;
+    if (X * Factor > Width)
+        Width = X * Factor;
     Height += CurHeight;
 
     // Add a slight width / height if we're using the bold style
@@ -395,9 +428,33 @@ void String::RecomputeRect()
         Width += 0.208f * mySize;
     }
 
-    // Add a slight height if we're using the underlined style
+    // Add the underlines if we're using the underlined style
     if (myStyle & Underlined)
     {
+        // Compute the line thickness
+        float Thickness = (myStyle & Bold) ? 3.f : 2.f;
+
+        // Add the last line (which was not finished with a \n)
+        UnderlineCoords.push_back(X);
+        UnderlineCoords.push_back(Y + 2);
+
+        for (std::size_t i = 0; i < UnderlineCoords.size(); i += 2)
+        {
+            float Right  = UnderlineCoords[i];
+            float Top    = UnderlineCoords[i + 1];
+            float Bottom = Top + Thickness;
+
+            Vertex Quad[4] =
+            {
+                {0, 0, 0,     Top},
+                {0, 0, 0,     Bottom},
+                {0, 0, Right, Bottom},
+                {0, 0, Right, Top}
+            };
+            myVertices.insert(myVertices.end(), Quad, Quad + 4);
+        }
+
+        // Add a slight height
         if (CurHeight < mySize + 4 * Factor)
             Height += 4 * Factor;
     }
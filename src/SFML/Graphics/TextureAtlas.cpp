@@ -0,0 +1,304 @@
+////////////////////////////////////////////////////////////
+//
+// SFML - Simple and Fast Multimedia Library
+// Copyright (C) 2007-2009 Laurent Gomila (laurent.gom@gmail.com)
+//
+// This software is provided 'as-is', without any express or implied warranty.
+// In no event will the authors be held liable for any damages arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it freely,
+// subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented;
+//    you must not claim that you wrote the original software.
+//    If you use this software in a product, an acknowledgment
+//    in the product documentation would be appreciated but is not required.
+//
+// 2. Altered source versions must be plainly marked as such,
+//    and must not be misrepresented as being the original software.
+//
+// 3. This notice may not be removed or altered from any source distribution.
+//
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+// Headers
+////////////////////////////////////////////////////////////
+#include <SFML/Graphics/TextureAtlas.hpp>
+#include <SFML/Graphics/ImageLoader.hpp>
+#include <SFML/Graphics/SkylinePacker.hpp>
+#include <iostream>
+
+
+namespace sf
+{
+////////////////////////////////////////////////////////////
+/// Default constructor for Region
+////////////////////////////////////////////////////////////
+TextureAtlas::Region::Region() :
+Texture(NULL),
+Rect   (0, 0, 0, 0)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+/// Default constructor
+////////////////////////////////////////////////////////////
+TextureAtlas::TextureAtlas(unsigned int PageSize, unsigned int Padding, bool Extrude) :
+myPageSize(PageSize),
+myPadding (Padding),
+myExtrude (Extrude),
+myIsSmooth(true)
+{
+
+}
+
+
+////////////////////////////////////////////////////////////
+/// Destructor
+////////////////////////////////////////////////////////////
+TextureAtlas::~TextureAtlas()
+{
+    Clear();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Load an image from a file and add it to the atlas
+////////////////////////////////////////////////////////////
+TextureAtlas::Region TextureAtlas::AddFromFile(const std::string& Filename)
+{
+    // Decode the pixels directly, a temporary image would needlessly create a texture
+    std::vector<Uint8>  Pixels;
+    unsigned int        Width, Height;
+    PixelFormat::Format Format;
+    if (!priv::ImageLoader::GetInstance().LoadImageFromFile(Filename, Pixels, Width, Height, Format))
+        return Region();
+
+    return AddPixels(Pixels, Width, Height, Format);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Load an image from a file in memory and add it to the atlas
+////////////////////////////////////////////////////////////
+TextureAtlas::Region TextureAtlas::AddFromMemory(const char* Data, std::size_t SizeInBytes)
+{
+    // Decode the pixels directly, a temporary image would needlessly create a texture
+    std::vector<Uint8>  Pixels;
+    unsigned int        Width, Height;
+    PixelFormat::Format Format;
+    if (!priv::ImageLoader::GetInstance().LoadImageFromMemory(Data, SizeInBytes, Pixels, Width, Height, Format))
+        return Region();
+
+    return AddPixels(Pixels, Width, Height, Format);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Add an existing image (or a part of it) to the atlas
+////////////////////////////////////////////////////////////
+TextureAtlas::Region TextureAtlas::Add(const Image& Source, const IntRect& SourceRect)
+{
+    // Adjust the source rectangle
+    IntRect SrcRect = SourceRect;
+    if (SrcRect.GetWidth() == 0 || (SrcRect.GetHeight() == 0))
+    {
+        SrcRect.Left   = 0;
+        SrcRect.Top    = 0;
+        SrcRect.Right  = Source.GetWidth();
+        SrcRect.Bottom = Source.GetHeight();
+    }
+    else
+    {
+        if (SrcRect.Left   < 0) SrcRect.Left = 0;
+        if (SrcRect.Top    < 0) SrcRect.Top  = 0;
+        if (SrcRect.Right  > static_cast<int>(Source.GetWidth()))  SrcRect.Right  = Source.GetWidth();
+        if (SrcRect.Bottom > static_cast<int>(Source.GetHeight())) SrcRect.Bottom = Source.GetHeight();
+    }
+
+    // Make sure there's something to add
+    if ((SrcRect.GetWidth() <= 0) || (SrcRect.GetHeight() <= 0))
+    {
+        std::cerr << "Cannot add an empty image to a texture atlas" << std::endl;
+        return Region();
+    }
+
+    // Find room for the image
+    Region Result;
+    Image* Page = Allocate(SrcRect.GetWidth(), SrcRect.GetHeight(), Result.Rect);
+    if (!Page)
+        return Region();
+
+    // Copy the pixels of the image into the page
+    Result.Texture = Page;
+    Page->Copy(Source, Result.Rect.Left, Result.Rect.Top, SrcRect);
+
+    if (myExtrude && (myPadding > 0))
+        ExtrudeBorders(*Page, Result.Rect);
+
+    return Result;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Remove all the images and pages of the atlas
+////////////////////////////////////////////////////////////
+void TextureAtlas::Clear()
+{
+    for (std::vector<priv::SkylinePacker*>::iterator i = myPackers.begin(); i != myPackers.end(); ++i)
+        delete *i;
+
+    myPackers.clear();
+    myPages.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+/// Enable or disable the smooth filter of all the pages
+////////////////////////////////////////////////////////////
+void TextureAtlas::SetSmooth(bool Smooth)
+{
+    myIsSmooth = Smooth;
+
+    for (std::deque<Image>::iterator i = myPages.begin(); i != myPages.end(); ++i)
+        i->SetSmooth(Smooth);
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get the number of pages of the atlas
+////////////////////////////////////////////////////////////
+unsigned int TextureAtlas::GetNbPages() const
+{
+    return static_cast<unsigned int>(myPages.size());
+}
+
+
+////////////////////////////////////////////////////////////
+/// Get one of the pages of the atlas
+////////////////////////////////////////////////////////////
+const Image& TextureAtlas::GetPage(unsigned int Index) const
+{
+    return myPages[Index];
+}
+
+
+////////////////////////////////////////////////////////////
+/// Add an array of pixels to the atlas
+////////////////////////////////////////////////////////////
+TextureAtlas::Region TextureAtlas::AddPixels(const std::vector<Uint8>& Pixels, unsigned int Width, unsigned int Height, PixelFormat::Format Format)
+{
+    // Find room for the image
+    Region Result;
+    Image* Page = Allocate(Width, Height, Result.Rect);
+    if (!Page)
+        return Region();
+
+    // Pages are RGBA : expand single-channel pixels first
+    const Uint8* Source = &Pixels[0];
+    std::vector<Uint8> Expanded;
+    if (Format != PixelFormat::RGBA8)
+    {
+        Expanded.resize(Pixels.size() * 4);
+        for (std::size_t i = 0; i < Pixels.size(); ++i)
+        {
+            Uint8* Pixel = &Expanded[i * 4];
+            if (Format == PixelFormat::A8)
+            {
+                Pixel[0] = Pixel[1] = Pixel[2] = 255;
+                Pixel[3] = Pixels[i];
+            }
+            else
+            {
+                Pixel[0] = Pixel[1] = Pixel[2] = Pixels[i];
+                Pixel[3] = 255;
+            }
+        }
+        Source = &Expanded[0];
+    }
+
+    // Copy the pixels into the page
+    Result.Texture = Page;
+    Page->UpdatePixels(Source, Result.Rect);
+
+    if (myExtrude && (myPadding > 0))
+        ExtrudeBorders(*Page, Result.Rect);
+
+    return Result;
+}
+
+
+////////////////////////////////////////////////////////////
+/// Find room for an image in the pages, adding a new page
+/// if none of them has enough space left
+////////////////////////////////////////////////////////////
+Image* TextureAtlas::Allocate(unsigned int Width, unsigned int Height, IntRect& Rect)
+{
+    // The image is surrounded by the padding
+    unsigned int PaddedWidth  = Width  + myPadding * 2;
+    unsigned int PaddedHeight = Height + myPadding * 2;
+    if ((Width == 0) || (Height == 0) || (PaddedWidth > myPageSize) || (PaddedHeight > myPageSize))
+    {
+        std::cerr << "Cannot add image to texture atlas, invalid size (" << Width << "x" << Height
+                  << ", pages are " << myPageSize << "x" << myPageSize << ")" << std::endl;
+        return NULL;
+    }
+
+    // Find room for the image in the existing pages, starting with the last one
+    unsigned int Left  = 0;
+    unsigned int Top   = 0;
+    std::size_t  Index = myPackers.size();
+    while ((Index > 0) && !myPackers[Index - 1]->Insert(PaddedWidth, PaddedHeight, Left, Top))
+        --Index;
+
+    // None of them has enough room : add a new page
+    if (Index == 0)
+    {
+        myPages.push_back(Image());
+        if (!myPages.back().Create(myPageSize, myPageSize, Color(0, 0, 0, 0)))
+        {
+            myPages.pop_back();
+            return NULL;
+        }
+        myPages.back().SetSmooth(myIsSmooth);
+
+        myPackers.push_back(new priv::SkylinePacker(myPageSize, myPageSize));
+        myPackers.back()->Insert(PaddedWidth, PaddedHeight, Left, Top);
+        Index = myPackers.size();
+    }
+
+    Rect = IntRect(Left + myPadding, Top + myPadding, Left + myPadding + Width, Top + myPadding + Height);
+
+    return &myPages[Index - 1];
+}
+
+
+////////////////////////////////////////////////////////////
+/// Copy the border pixels of an image into the padding
+/// around it
+////////////////////////////////////////////////////////////
+void TextureAtlas::ExtrudeBorders(Image& Page, const IntRect& Rect)
+{
+    int Padding = static_cast<int>(myPadding);
+
+    // Repeat the first and last columns on the left and right sides
+    for (int i = 1; i <= Padding; ++i)
+    {
+        Page.Copy(Page, Rect.Left - i,      Rect.Top, IntRect(Rect.Left,      Rect.Top, Rect.Left + 1, Rect.Bottom));
+        Page.Copy(Page, Rect.Right + i - 1, Rect.Top, IntRect(Rect.Right - 1, Rect.Top, Rect.Right,    Rect.Bottom));
+    }
+
+    // Then repeat the first and last (widened) rows on the top and bottom sides, which fills the corners too
+    for (int i = 1; i <= Padding; ++i)
+    {
+        Page.Copy(Page, Rect.Left - Padding, Rect.Top - i,        IntRect(Rect.Left - Padding, Rect.Top,        Rect.Right + Padding, Rect.Top + 1));
+        Page.Copy(Page, Rect.Left - Padding, Rect.Bottom + i - 1, IntRect(Rect.Left - Padding, Rect.Bottom - 1, Rect.Right + Padding, Rect.Bottom));
+    }
+}
+
+} // namespace sf
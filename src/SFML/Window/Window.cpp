@@ -352,6 +352,9 @@ bool Window::SetActive(bool Active) const
 ////////////////////////////////////////////////////////////
 void Window::Display()
 {
+    // Let the derived class finish its rendering
+    OnDisplay();
+
     // Limit the framerate if needed
     if (myFramerateLimit > 0)
     {
@@ -417,6 +420,15 @@ void Window::OnCreate()
 }
 
 
+////////////////////////////////////////////////////////////
+/// Called before the window is displayed on screen
+////////////////////////////////////////////////////////////
+void Window::OnDisplay()
+{
+    // Nothing by default
+}
+
+
 ////////////////////////////////////////////////////////////
 /// Receive an event from window
 ////////////////////////////////////////////////////////////